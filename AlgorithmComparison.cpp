@@ -0,0 +1,247 @@
+#include "AlgorithmComparison.h"
+
+#include <math.h>
+#include <chrono>
+#include <algorithm>
+#include <fstream>
+
+#include "AllocationCounter.h"
+
+/**
+ * The AlgorithmComparison constructor creates a comparison with no results.
+ */
+AlgorithmComparison::AlgorithmComparison()
+{
+}
+
+/**
+ * This function runs BIA, DDA and BA on a sweep of lines: the given line rotated around its starting
+ * point in steps equal angles, so every octant is covered. BA is drawLineBres, the one the viewer
+ * draws, which only walks the first octant. The reference of the three is OCT, drawLineOctant, the
+ * Bresenham walk that handles all eight octants, and it is timed as well. DDA is skipped for the lines
+ * it would never finish.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line.
+ * @param steps The number of lines of the sweep.
+ */
+void AlgorithmComparison::sweepLines(double x1, double y1, double x2, double y2, unsigned int steps)
+{
+	std::vector<glm::vec4> sweep(steps);
+	double length = sqrt((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1));
+	double start = atan2(y2 - y1, x2 - x1);
+	for (unsigned int i = 0; i < steps; i++)
+	{
+		double angle = start + 2.0 * 3.14159265358979 * i / steps;
+		sweep[i] = glm::vec4(x1, y1, floor(x1 + length * cos(angle) + 0.5), floor(y1 + length * sin(angle) + 0.5));
+	}
+
+	MathOGL& math = mathGL;
+	Rasterizer octant = [&math](const glm::vec4& p) { return math.drawLineOctant(p.x, p.y, p.z, p.w); };
+	run("BIA", "OCT", [&math](const glm::vec4& p) { return math.drawLineBasic(p.x, p.y, p.z, p.w); }, octant, sweep, false);
+	run("DDA", "OCT", [&math](const glm::vec4& p) { return math.drawLineDDA(p.x, p.y, p.z, p.w); }, octant, sweep, true);
+	run("BA", "OCT", [&math](const glm::vec4& p) { return math.drawLineBres(p.x, p.y, p.z, p.w); }, octant, sweep, false);
+	run("OCT", "OCT", octant, octant, sweep, false);
+}
+
+/**
+ * This function runs MPC and BCA on a sweep of concentric circles, with radii r / steps, 2r / steps
+ * and so on up to r. midPointCircleDraw only draws the quadrant of positive offsets, so MPC is
+ * compared with the same quadrant of BresenhamCircle and BCA with the whole circle.
+ * 
+ * @param x The x-coordinate of the centre of the circles.
+ * @param y The y-coordinate of the centre of the circles.
+ * @param r The radius of the largest circle.
+ * @param steps The number of circles of the sweep.
+ */
+void AlgorithmComparison::sweepCircles(double x, double y, double r, unsigned int steps)
+{
+	std::vector<glm::vec4> sweep(steps);
+	for (unsigned int i = 0; i < steps; i++)
+	{
+		sweep[i] = glm::vec4(x, y, std::max(1.0, floor(r * (i + 1) / steps)), 0.0f);
+	}
+
+	MathOGL& math = mathGL;
+	Rasterizer bresenham = [&math](const glm::vec4& p) { return math.BresenhamCircle(p.x, p.y, p.z); };
+	Rasterizer bresenhamQuadrant = [&math](const glm::vec4& p)
+	{
+		std::vector<glm::vec3> circle = math.BresenhamCircle(p.x, p.y, p.z);
+		circle.erase(std::remove_if(circle.begin(), circle.end(),
+			[&p](const glm::vec3& pixel) { return pixel.x < p.x || pixel.y < p.y; }), circle.end());
+		return circle;
+	};
+	run("MPC", "BCA-Q1", [&math](const glm::vec4& p) { return math.midPointCircleDraw(p.x, p.y, p.z); }, bresenhamQuadrant, sweep, false);
+	run("BCA", "BCA", bresenham, bresenham, sweep, false);
+}
+
+/**
+ * This function prints the results as a table. The allocation columns show "-" unless the program
+ * was built with COUNT_ALLOCATIONS.
+ * 
+ * @param out The stream to print to, such as stdout.
+ */
+void AlgorithmComparison::print(FILE* out) const
+{
+	fprintf(out, "%-4s %-6s %10s %8s %12s %10s %12s %10s %12s %12s %10s\n", "alg", "ref", "primitives", "skipped",
+		"ms", "ns/pixel", "pixels", "allocs", "alloc KB", "missing", "extra");
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const ComparisonResult& r = results[i];
+		fprintf(out, "%-4s %-6s %10u %8u %12.3f %10.2f %12llu", r.algorithm.c_str(), r.reference.c_str(), r.primitives,
+			r.skipped, r.ms, r.pixels > 0 ? 1e6 * r.ms / r.pixels : 0.0, r.pixels);
+		if (AllocationCounter::isEnabled())
+			fprintf(out, " %10llu %12.1f", r.allocations, r.allocatedBytes / 1024.0);
+		else
+			fprintf(out, " %10s %12s", "-", "-");
+		fprintf(out, " %12llu %10llu", r.missing, r.extra);
+		if (r.differing > 0)
+		{
+			fprintf(out, " (%u differ)", r.differing);
+		}
+		fprintf(out, "\n");
+	}
+}
+
+/**
+ * This function writes the results as a CSV file with one row per rasterizer. The allocation fields
+ * are empty unless the program was built with COUNT_ALLOCATIONS.
+ * 
+ * @param path The path of the file.
+ * 
+ * @return true if the file was written.
+ */
+bool AlgorithmComparison::writeReport(const char* path) const
+{
+	std::ofstream file(path);
+	if (!file)
+	{
+		printf("Error writing comparison report '%s'\n", path);
+		return false;
+	}
+
+	file << "algorithm,reference,primitives,skipped,ms,pixels,allocations,allocated_bytes,missing,extra,differing\n";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const ComparisonResult& r = results[i];
+		file << r.algorithm << ',' << r.reference << ',' << r.primitives << ',' << r.skipped << ',' << r.ms << ','
+			<< r.pixels << ',';
+		if (AllocationCounter::isEnabled())
+		{
+			file << r.allocations << ',' << r.allocatedBytes;
+		}
+		else
+		{
+			file << ',';
+		}
+		file << ',' << r.missing << ',' << r.extra << ',' << r.differing << '\n';
+	}
+	return file.good();
+}
+
+/**
+ * This function times a rasterizer over a sweep and compares its pixels with those of the reference.
+ * Only the calls to the rasterizer are timed and counted; the comparison runs afterwards.
+ * 
+ * @param algorithm The name of the rasterizer.
+ * @param reference The name of the reference rasterizer.
+ * @param rasterizer The rasterizer.
+ * @param referenceRasterizer The reference rasterizer.
+ * @param sweep The primitives to rasterize.
+ * @param skipUnboundedDDA Whether to skip the lines drawLineDDA never finishes.
+ */
+void AlgorithmComparison::run(const char* algorithm, const char* reference, const Rasterizer& rasterizer, const Rasterizer& referenceRasterizer,
+	const std::vector<glm::vec4>& sweep, bool skipUnboundedDDA)
+{
+	ComparisonResult result = { algorithm, reference, 0, 0, 0.0, 0, 0, 0, 0, 0, 0 };
+	std::vector<std::vector<glm::vec3> > outputs(sweep.size());
+	std::vector<bool> ran(sweep.size(), false);
+
+	for (size_t i = 0; i < sweep.size(); i++)
+	{
+		const glm::vec4& p = sweep[i];
+		if (skipUnboundedDDA && MathOGL::countLineDDA(p.x, p.y, p.z, p.w) == MathOGL::rasterUnbounded)
+		{
+			result.skipped++;
+			continue;
+		}
+
+		unsigned long long allocations = AllocationCounter::getAllocations();
+		unsigned long long bytes = AllocationCounter::getBytes();
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		outputs[i] = rasterizer(p);
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+		result.ms += elapsed.count();
+		result.allocations += AllocationCounter::getAllocations() - allocations;
+		result.allocatedBytes += AllocationCounter::getBytes() - bytes;
+		result.pixels += outputs[i].size();
+		result.primitives++;
+		ran[i] = true;
+	}
+
+	std::vector<long long> pixels, referencePixels;
+	for (size_t i = 0; i < sweep.size(); i++)
+	{
+		if (!ran[i])
+			continue;
+
+		pixelSet(outputs[i], pixels);
+		pixelSet(referenceRasterizer(sweep[i]), referencePixels);
+		size_t missing = countMissing(referencePixels, pixels);
+		size_t extra = countMissing(pixels, referencePixels);
+		result.missing += missing;
+		result.extra += extra;
+		result.differing += missing > 0 || extra > 0;
+	}
+	results.push_back(result);
+}
+
+/**
+ * This function turns a list of pixels into a sorted set of distinct pixels, each packed in one
+ * integer.
+ * 
+ * @param pixels The pixels, as given by the rasterizers.
+ * @param set Receives the sorted packed pixels.
+ */
+void AlgorithmComparison::pixelSet(const std::vector<glm::vec3>& pixels, std::vector<long long>& set)
+{
+	set.resize(pixels.size());
+	for (size_t i = 0; i < pixels.size(); i++)
+	{
+		set[i] = (long long)floor(pixels[i].x + 0.5f) * 4294967296LL + (long long)floor(pixels[i].y + 0.5f);
+	}
+	std::sort(set.begin(), set.end());
+	set.erase(std::unique(set.begin(), set.end()), set.end());
+}
+
+/**
+ * This function counts the pixels of one sorted set missing from another.
+ * 
+ * @param from The set whose pixels are looked for.
+ * @param in The set they are looked for in.
+ * 
+ * @return the number of pixels of from that are not in in.
+ */
+size_t AlgorithmComparison::countMissing(const std::vector<long long>& from, const std::vector<long long>& in)
+{
+	size_t missing = 0;
+	size_t j = 0;
+	for (size_t i = 0; i < from.size(); i++)
+	{
+		while (j < in.size() && in[j] < from[i])
+		{
+			j++;
+		}
+		missing += j == in.size() || in[j] != from[i];
+	}
+	return missing;
+}
+
+/**
+ * This is a destructor for the AlgorithmComparison class.
+ */
+AlgorithmComparison::~AlgorithmComparison()
+{
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdio.h>
+#include <vector>
+#include <string>
+#include <functional>
+
+#include <glm.hpp>
+
+#include "MathOGL.h"
+
+/**
+ * Totals of one rasterizer over a parameter sweep, next to the reference rasterizer of its kind.
+ */
+struct ComparisonResult
+{
+	std::string algorithm;
+	std::string reference;
+	unsigned int primitives;
+	// Primitives not run because the rasterizer would never return for them (DDA).
+	unsigned int skipped;
+	double ms;
+	unsigned long long pixels;
+	unsigned long long allocations;
+	unsigned long long allocatedBytes;
+	// Distinct pixels of the reference the rasterizer misses, and drawn ones the reference doesn't.
+	unsigned long long missing;
+	unsigned long long extra;
+	// Primitives whose pixel set differs from the reference.
+	unsigned int differing;
+};
+
+/**
+ * Runs the line rasterizers BIA, DDA and BA and the circle rasterizers MPC and BCA of MathOGL on the
+ * same parameter sweeps, timing them, counting their pixels and heap allocations (when built with
+ * COUNT_ALLOCATIONS, as the Profile configuration does), and comparing the set of pixels of every
+ * primitive with OCT (drawLineOctant) for lines and BCA for circles, or the same quadrant of BCA for
+ * MPC, which only draws one.
+ */
+class AlgorithmComparison
+{
+public:
+	AlgorithmComparison();
+
+	void sweepLines(double x1, double y1, double x2, double y2, unsigned int steps);
+	void sweepCircles(double x, double y, double r, unsigned int steps);
+	void print(FILE* out) const;
+	bool writeReport(const char* path) const;
+
+	const std::vector<ComparisonResult>& getResults() const { return results; }
+
+	~AlgorithmComparison();
+
+private:
+	MathOGL mathGL;
+	std::vector<ComparisonResult> results;
+
+	// Rasterizes the primitive of a sweep: a line (x1, y1, x2, y2) or a circle (x, y, r).
+	typedef std::function<std::vector<glm::vec3>(const glm::vec4&)> Rasterizer;
+
+	void run(const char* algorithm, const char* reference, const Rasterizer& rasterizer, const Rasterizer& referenceRasterizer,
+		const std::vector<glm::vec4>& sweep, bool skipUnboundedDDA);
+	static void pixelSet(const std::vector<glm::vec3>& pixels, std::vector<long long>& set);
+	static size_t countMissing(const std::vector<long long>& from, const std::vector<long long>& in);
+};
@@ -0,0 +1,94 @@
+#include "AllocationCounter.h"
+
+#include <stdlib.h>
+#include <new>
+
+#ifdef COUNT_ALLOCATIONS
+// Per thread, so counting needs no atomics and other threads don't disturb a measurement.
+static thread_local unsigned long long allocations = 0;
+static thread_local unsigned long long allocatedBytes = 0;
+#endif
+
+/**
+ * This function tells whether allocations are counted, that is, whether the program was built with
+ * COUNT_ALLOCATIONS.
+ * 
+ * @return true if the global operator new is replaced by the counting one.
+ */
+bool AllocationCounter::isEnabled()
+{
+#ifdef COUNT_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+/**
+ * This function returns the number of allocations made by the calling thread since it started.
+ * 
+ * @return the number of calls to operator new, 0 without COUNT_ALLOCATIONS.
+ */
+unsigned long long AllocationCounter::getAllocations()
+{
+#ifdef COUNT_ALLOCATIONS
+	return allocations;
+#else
+	return 0;
+#endif
+}
+
+/**
+ * This function returns the bytes requested by the calling thread since it started.
+ * 
+ * @return the sum of the sizes passed to operator new, 0 without COUNT_ALLOCATIONS.
+ */
+unsigned long long AllocationCounter::getBytes()
+{
+#ifdef COUNT_ALLOCATIONS
+	return allocatedBytes;
+#else
+	return 0;
+#endif
+}
+
+#ifdef COUNT_ALLOCATIONS
+
+/**
+ * Replacement of the global operator new that counts the allocation before handing it to malloc.
+ * The array and nothrow forms call it, so they are counted as well.
+ * 
+ * @param size The number of bytes to allocate.
+ * 
+ * @return the allocated memory.
+ */
+void* operator new(size_t size)
+{
+	allocations++;
+	allocatedBytes += size;
+	void* memory = malloc(size > 0 ? size : 1);
+	if (memory == NULL)
+		throw std::bad_alloc();
+	return memory;
+}
+
+/**
+ * Replacement of the global operator delete matching the operator new above.
+ * 
+ * @param memory The memory to free.
+ */
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+/**
+ * Replacement of the sized global operator delete, which some runtimes call directly.
+ * 
+ * @param memory The memory to free.
+ */
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+
+/**
+ * Counts of the heap allocations made through operator new by the calling thread. When built with
+ * COUNT_ALLOCATIONS the global operator new and delete are replaced in AllocationCounter.cpp to keep
+ * them, so they cover every std::vector or other container growth on that thread. Take the counts
+ * before and after the code to measure and subtract them. The Profile configuration of the project is
+ * Release plus the flag; Debug and Release leave the default operators alone and the counts stay at 0.
+ */
+struct AllocationCounter
+{
+	static bool isEnabled();
+	static unsigned long long getAllocations();
+	static unsigned long long getBytes();
+};
@@ -0,0 +1,46 @@
+#include "Backdrop.h"
+
+/**
+ * The Backdrop constructor initializes the GL handle to 0. The vertex array is created on the first
+ * render.
+ */
+Backdrop::Backdrop()
+{
+	VAO = 0;
+}
+
+/**
+ * This function draws the triangle covering the screen. The backdrop shader must be in use, with the
+ * projection, view, gridSpacing and fadeDistance uniforms set.
+ */
+void Backdrop::render()
+{
+	if (VAO == 0)
+	{
+		glGenVertexArrays(1, &VAO);
+	}
+
+	glBindVertexArray(VAO);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+}
+
+/**
+ * The function deletes the vertex array of the backdrop.
+ */
+void Backdrop::clear()
+{
+	if (VAO != 0)
+	{
+		glDeleteVertexArrays(1, &VAO);
+		VAO = 0;
+	}
+}
+
+/**
+ * The destructor function for the Backdrop class that clears the backdrop.
+ */
+Backdrop::~Backdrop()
+{
+	clear();
+}
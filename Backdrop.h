@@ -0,0 +1,24 @@
+#pragma once
+
+#include <GL\glew.h>
+
+/**
+ * Ground plane, grid and cartesian axes of the scene, drawn procedurally in one pass. A single
+ * triangle covers the screen and Shaders/backdrop.frag casts the camera ray of each fragment onto
+ * the y = 0 ground and towards the axes, so the grid can be as dense as wanted without adding any
+ * geometry. The backdrop is drawn first and the scene on top of it.
+ */
+class Backdrop
+{
+public:
+	Backdrop();
+
+	void render();
+	void clear();
+
+	~Backdrop();
+
+private:
+	// Empty, the triangle comes from gl_VertexID, but a core context can't draw without a VAO.
+	GLuint VAO;
+};
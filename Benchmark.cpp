@@ -0,0 +1,1327 @@
+#include "Benchmark.h"
+#include "SimdFloat.h"
+#include "TempFile.h"
+
+/**
+ * The Benchmark constructor seeds the random generator with a fixed value so every run measures the
+ * same inputs.
+ */
+Benchmark::Benchmark()
+{
+	rng.seed(2023);
+}
+
+/**
+ * This function runs every benchmark with its default workload and prints the results.
+ */
+void Benchmark::runAll()
+{
+	lineOctants(200000, 1000);
+	primitiveFeed(4, 1000000, 0);
+	primitiveFeed(4, 250000, 8);
+	vectorBatch(4000000);
+	transformBatch(8000000);
+	clipping(2000, 5000);
+	tiledCanvas(16384, 100000, 5000, 64);
+	lazyPixels(1000000, 10000000);
+	polylineSimplify(2000, 5000);
+	chainCodes(20000, 1000, 1000000);
+	rasterExport(1000000);
+	pixelDedup(5000, 1000);
+	mortonOrder(2000, 1000, 100000);
+	spatialQueries(2000, 1000, 100000);
+	sparseTiles(1000000, 16384, 5000, (size_t)8 << 20);
+	thickLines(2000, 4000);
+}
+
+/**
+ * This function times drawLineOctant against a Bresenham loop that resolves the direction on every
+ * pixel, over the same random lines spread through the eight octants, and checks that both produce
+ * the same pixels.
+ * 
+ * @param lineCount The number of random lines to rasterize.
+ * @param maxLength The maximum distance of the end points from the origin on each axis.
+ */
+void Benchmark::lineOctants(unsigned int lineCount, int maxLength)
+{
+	std::uniform_int_distribution<int> coord(-maxLength, maxLength);
+	std::vector<glm::vec4> lines(lineCount);
+	for (unsigned int i = 0; i < lineCount; i++) {
+		lines[i] = glm::vec4(coord(rng), coord(rng), coord(rng), coord(rng));
+	}
+
+	size_t pixelsBranching = 0;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < lineCount; i++) {
+		pixelsBranching += drawLineBranching(lines[i].x, lines[i].y, lines[i].z, lines[i].w).size();
+	}
+	double branchingMs = elapsedMs(start);
+
+	size_t pixelsOctant = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < lineCount; i++) {
+		pixelsOctant += mathGL.drawLineOctant(lines[i].x, lines[i].y, lines[i].z, lines[i].w).size();
+	}
+	double octantMs = elapsedMs(start);
+
+	unsigned int mismatches = 0;
+	for (unsigned int i = 0; i < lineCount && i < 10000; i++) {
+		if (drawLineBranching(lines[i].x, lines[i].y, lines[i].z, lines[i].w) !=
+			mathGL.drawLineOctant(lines[i].x, lines[i].y, lines[i].z, lines[i].w)) {
+			mismatches++;
+		}
+	}
+
+	printf("[lineOctants] %u lines, %zu pixels\n", lineCount, pixelsOctant);
+	printf("  branching loop : %10.3f ms (%6.1f Mpx/s)\n", branchingMs, pixelsBranching / (branchingMs * 1000.0));
+	printf("  octant template: %10.3f ms (%6.1f Mpx/s)\n", octantMs, pixelsOctant / (octantMs * 1000.0));
+	printf("  speedup %.2fx, mismatching lines: %u\n", branchingMs / octantMs, mismatches);
+}
+
+/**
+ * This function measures the throughput of PrimitiveQueue: producer threads push random lines as fast
+ * as they can while this thread pops them and, when maxLength is not 0, rasterizes them the way the
+ * viewer drains its live feed.
+ * 
+ * @param producerCount The number of producer threads.
+ * @param primitivesPerProducer The number of primitives pushed by each producer.
+ * @param maxLength The maximum length of the lines on each axis, 0 to only move them through the queue.
+ */
+void Benchmark::primitiveFeed(unsigned int producerCount, unsigned int primitivesPerProducer, int maxLength)
+{
+	PrimitiveQueue queue(1 << 16);
+	std::atomic<unsigned long long> fullRetries(0);
+	std::vector<std::thread> producers;
+	unsigned long long total = (unsigned long long)producerCount * primitivesPerProducer;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (unsigned int p = 0; p < producerCount; p++)
+	{
+		producers.push_back(std::thread([&queue, &fullRetries, p, primitivesPerProducer, maxLength]() {
+			std::mt19937 producerRng(p);
+			std::uniform_int_distribution<int> coord(-maxLength, maxLength);
+			unsigned long long retries = 0;
+			for (unsigned int i = 0; i < primitivesPerProducer; i++)
+			{
+				Primitive primitive = { Primitive::LINE, 0.0f, 0.0f, (float)coord(producerRng), (float)coord(producerRng) };
+				while (!queue.push(primitive))
+				{
+					retries++;
+					std::this_thread::yield();
+				}
+			}
+			fullRetries += retries;
+		}));
+	}
+
+	unsigned long long popped = 0;
+	size_t pixels = 0;
+	Primitive primitive;
+	while (popped < total)
+	{
+		if (!queue.pop(primitive))
+			continue;
+
+		popped++;
+		if (maxLength != 0)
+		{
+			pixels += mathGL.drawLineOctant(primitive.x1, primitive.y1, primitive.x2, primitive.y2).size();
+		}
+	}
+	double totalMs = elapsedMs(start);
+
+	for (size_t p = 0; p < producers.size(); p++)
+	{
+		producers[p].join();
+	}
+
+	printf("[primitiveFeed] %u producers, %llu primitives%s\n", producerCount, total,
+		maxLength != 0 ? ", rasterized by the consumer" : ", queue only");
+	printf("  %10.3f ms (%6.2f M primitives/s", totalMs, total / (totalMs * 1000.0));
+	if (maxLength != 0)
+	{
+		printf(", %6.1f Mpx/s", pixels / (totalMs * 1000.0));
+	}
+	printf("), %llu pushes retried on a full queue\n", fullRetries.load());
+}
+
+/**
+ * This function times the batch vector operations of MathOGL, on arrays of glm::vec3 and on
+ * structure-of-arrays buffers, against calling the single vector functions in a loop, and reports the
+ * largest difference between the batch and the single vector results.
+ * 
+ * @param vectorCount The number of random vectors in each operand.
+ */
+void Benchmark::vectorBatch(size_t vectorCount)
+{
+	std::uniform_real_distribution<float> component(-100.0f, 100.0f);
+	std::vector<glm::vec3> a(vectorCount), b(vectorCount), outLoop(vectorCount), outAoS(vectorCount);
+	std::vector<float> soa(vectorCount * 9), scalarLoop(vectorCount), scalarBatch(vectorCount);
+	for (size_t i = 0; i < vectorCount; i++) {
+		a[i] = glm::vec3(component(rng), component(rng), component(rng));
+		b[i] = glm::vec3(component(rng), component(rng), component(rng));
+		soa[i] = a[i].x;
+		soa[vectorCount + i] = a[i].y;
+		soa[2 * vectorCount + i] = a[i].z;
+		soa[3 * vectorCount + i] = b[i].x;
+		soa[4 * vectorCount + i] = b[i].y;
+		soa[5 * vectorCount + i] = b[i].z;
+	}
+	Vec3SoA soaA = { &soa[0], &soa[vectorCount], &soa[2 * vectorCount], vectorCount };
+	Vec3SoA soaB = { &soa[3 * vectorCount], &soa[4 * vectorCount], &soa[5 * vectorCount], vectorCount };
+	Vec3SoA soaOut = { &soa[6 * vectorCount], &soa[7 * vectorCount], &soa[8 * vectorCount], vectorCount };
+
+	printf("[vectorBatch] %zu vectors, %s kernels (M vectors/s)\n", vectorCount, SimdFloat::name());
+	double maxError = 0.0;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < vectorCount; i++) {
+		outLoop[i] = mathGL.vecSum(a[i], b[i]);
+	}
+	printRate("vecSum       loop", elapsedMs(start), vectorCount);
+	start = std::chrono::high_resolution_clock::now();
+	mathGL.vecSum(a.data(), b.data(), outAoS.data(), vectorCount);
+	printRate("vecSum       AoS ", elapsedMs(start), vectorCount);
+	start = std::chrono::high_resolution_clock::now();
+	mathGL.vecSum(soaA, soaB, soaOut);
+	printRate("vecSum       SoA ", elapsedMs(start), vectorCount);
+	for (size_t i = 0; i < vectorCount; i++) {
+		maxError = std::max(maxError, (double)glm::length(outLoop[i] - outAoS[i]));
+		maxError = std::max(maxError, (double)glm::length(outLoop[i] - glm::vec3(soaOut.x[i], soaOut.y[i], soaOut.z[i])));
+	}
+
+	start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < vectorCount; i++) {
+		outLoop[i] = mathGL.crossProduct(a[i], b[i]);
+	}
+	printRate("crossProduct loop", elapsedMs(start), vectorCount);
+	start = std::chrono::high_resolution_clock::now();
+	mathGL.crossProduct(a.data(), b.data(), outAoS.data(), vectorCount);
+	printRate("crossProduct AoS ", elapsedMs(start), vectorCount);
+	start = std::chrono::high_resolution_clock::now();
+	mathGL.crossProduct(soaA, soaB, soaOut);
+	printRate("crossProduct SoA ", elapsedMs(start), vectorCount);
+	for (size_t i = 0; i < vectorCount; i++) {
+		maxError = std::max(maxError, (double)glm::length(outLoop[i] - outAoS[i]));
+		maxError = std::max(maxError, (double)glm::length(outLoop[i] - glm::vec3(soaOut.x[i], soaOut.y[i], soaOut.z[i])));
+	}
+
+	start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < vectorCount; i++) {
+		scalarLoop[i] = mathGL.dotProduct(a[i], b[i]);
+	}
+	printRate("dotProduct   loop", elapsedMs(start), vectorCount);
+	start = std::chrono::high_resolution_clock::now();
+	mathGL.dotProduct(a.data(), b.data(), scalarBatch.data(), vectorCount);
+	printRate("dotProduct   AoS ", elapsedMs(start), vectorCount);
+	start = std::chrono::high_resolution_clock::now();
+	mathGL.dotProduct(soaA, soaB, scalarBatch.data());
+	printRate("dotProduct   SoA ", elapsedMs(start), vectorCount);
+	for (size_t i = 0; i < vectorCount; i++) {
+		maxError = std::max(maxError, (double)std::abs(scalarLoop[i] - scalarBatch[i]) / std::max(1.0f, std::abs(scalarLoop[i])));
+	}
+
+	start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < vectorCount; i++) {
+		outLoop[i] = mathGL.normalize(a[i]);
+	}
+	printRate("normalize    loop", elapsedMs(start), vectorCount);
+	start = std::chrono::high_resolution_clock::now();
+	mathGL.normalize(a.data(), outAoS.data(), vectorCount);
+	printRate("normalize    AoS ", elapsedMs(start), vectorCount);
+	start = std::chrono::high_resolution_clock::now();
+	mathGL.normalize(soaA, soaOut);
+	printRate("normalize    SoA ", elapsedMs(start), vectorCount);
+	for (size_t i = 0; i < vectorCount; i++) {
+		maxError = std::max(maxError, (double)glm::length(outLoop[i] - outAoS[i]));
+		maxError = std::max(maxError, (double)glm::length(outLoop[i] - glm::vec3(soaOut.x[i], soaOut.y[i], soaOut.z[i])));
+	}
+
+	start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < vectorCount; i++) {
+		scalarLoop[i] = mathGL.angleBetween(a[i], b[i]);
+	}
+	printRate("angleBetween loop", elapsedMs(start), vectorCount);
+	start = std::chrono::high_resolution_clock::now();
+	mathGL.angleBetween(a.data(), b.data(), scalarBatch.data(), vectorCount);
+	printRate("angleBetween AoS ", elapsedMs(start), vectorCount);
+	start = std::chrono::high_resolution_clock::now();
+	mathGL.angleBetween(soaA, soaB, scalarBatch.data());
+	printRate("angleBetween SoA ", elapsedMs(start), vectorCount);
+	for (size_t i = 0; i < vectorCount; i++) {
+		maxError = std::max(maxError, (double)std::abs(scalarLoop[i] - scalarBatch[i]));
+	}
+
+	printf("  largest difference against the single vector functions: %g\n", maxError);
+}
+
+/**
+ * This function times MathOGL::transformPoints against multiplying every point by the matrix in a
+ * loop, for each kind of transformation it distinguishes, and reports the largest difference.
+ * 
+ * @param pointCount The number of random points transformed by each matrix.
+ */
+void Benchmark::transformBatch(size_t pointCount)
+{
+	std::uniform_real_distribution<float> component(-500.0f, 500.0f);
+	std::vector<glm::vec3> source(pointCount);
+	for (size_t i = 0; i < pointCount; i++) {
+		source[i] = glm::vec3(component(rng), component(rng), component(rng));
+	}
+
+	glm::mat4 projective(1.0f);
+	projective[2][3] = 0.001f;
+	const char* names[] = { "translation", "2D affine  ", "3D affine  ", "projective " };
+	glm::mat4 transforms[] = {
+		mathGL.translate(glm::vec3(10.0f, -20.0f, 0.0f)),
+		mathGL.compose(mathGL.rotate(0.5, glm::vec3(0.0f, 0.0f, 1.0f)), mathGL.translate(glm::vec3(10.0f, -20.0f, 0.0f))),
+		mathGL.compose(mathGL.compose(mathGL.scale(glm::vec3(2.0f, 0.5f, 1.5f)), mathGL.rotate(0.5, glm::vec3(1.0f, 1.0f, 0.0f))), mathGL.translate(glm::vec3(1.0f, 2.0f, 3.0f))),
+		mathGL.compose(mathGL.rotate(0.5, glm::vec3(0.0f, 1.0f, 0.0f)), projective),
+	};
+
+	printf("[transformBatch] %zu points, %s kernels, up to %u threads (M points/s)\n", pointCount, SimdFloat::name(), std::thread::hardware_concurrency());
+	double maxError = 0.0;
+	std::vector<glm::vec3> loop(pointCount), batch(pointCount);
+
+	for (size_t t = 0; t < sizeof(transforms) / sizeof(transforms[0]); t++)
+	{
+		const glm::mat4& m = transforms[t];
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (size_t i = 0; i < pointCount; i++) {
+			glm::vec4 p = m * glm::vec4(source[i].x, source[i].y, source[i].z, 1.0f);
+			loop[i] = glm::vec3(p.x / p.w, p.y / p.w, p.z / p.w);
+		}
+		double loopMs = elapsedMs(start);
+
+		batch = source;
+		start = std::chrono::high_resolution_clock::now();
+		mathGL.transformPoints(m, batch);
+		double batchMs = elapsedMs(start);
+
+		printf("  %s: loop %8.3f ms (%7.1f M/s), transformPoints %8.3f ms (%7.1f M/s), %.1fx\n", names[t],
+			loopMs, pointCount / (loopMs * 1000.0), batchMs, pointCount / (batchMs * 1000.0), loopMs / batchMs);
+
+		for (size_t i = 0; i < pointCount; i++) {
+			maxError = std::max(maxError, (double)glm::length(loop[i] - batch[i]) / std::max(1.0f, glm::length(loop[i])));
+		}
+	}
+
+	printf("  largest relative difference against the loop: %g\n", maxError);
+}
+
+/**
+ * This function times rasterizing primitives spread over a space much larger than an 800x600 window
+ * and keeping the visible pixels, against clipping them to the window before rasterizing, and checks
+ * that both give the same pixels.
+ * 
+ * @param primitiveCount The number of lines and of circles of each algorithm.
+ * @param extent The maximum distance of the end points and centers from the origin on each axis, also
+ * the largest radius.
+ */
+void Benchmark::clipping(unsigned int primitiveCount, int extent)
+{
+	const ClipRect window = { -400.0, -300.0, 400.0, 300.0 };
+	std::uniform_int_distribution<int> coord(-extent, extent);
+	std::uniform_int_distribution<int> radius(1, extent);
+	std::vector<glm::vec4> lines(primitiveCount), circles(primitiveCount);
+	for (unsigned int i = 0; i < primitiveCount; i++) {
+		lines[i] = glm::vec4(coord(rng), coord(rng), coord(rng), coord(rng));
+		circles[i] = glm::vec4(coord(rng), coord(rng), radius(rng), 0);
+	}
+
+	printf("[clipping] %u primitives of each kind within +-%d, window 800x600\n", primitiveCount, extent);
+	const char* names[] = { "drawLineOctant    ", "drawLineBasic     ", "drawLineDDA       ", "drawLineBres      ",
+		"midPointCircleDraw", "BresenhamCircle   " };
+	unsigned int mismatches = 0;
+
+	// drawLineDDA never finishes some lines, those are left out of both passes.
+	std::vector<bool> ddaEnds(primitiveCount);
+	for (unsigned int i = 0; i < primitiveCount; i++) {
+		ddaEnds[i] = MathOGL::countLineDDA(lines[i].x, lines[i].y, lines[i].z, lines[i].w) != MathOGL::rasterUnbounded;
+	}
+
+	for (int kind = 0; kind < 6; kind++)
+	{
+		size_t generated = 0, visible = 0, clippedPixels = 0;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (unsigned int i = 0; i < primitiveCount; i++) {
+			if (kind == 2 && !ddaEnds[i])
+				continue;
+			std::vector<glm::vec3> points =
+				kind == 0 ? mathGL.drawLineOctant(lines[i].x, lines[i].y, lines[i].z, lines[i].w) :
+				kind == 1 ? mathGL.drawLineBasic(lines[i].x, lines[i].y, lines[i].z, lines[i].w) :
+				kind == 2 ? mathGL.drawLineDDA(lines[i].x, lines[i].y, lines[i].z, lines[i].w) :
+				kind == 3 ? mathGL.drawLineBres(lines[i].x, lines[i].y, lines[i].z, lines[i].w) :
+				kind == 4 ? mathGL.midPointCircleDraw(circles[i].x, circles[i].y, circles[i].z) :
+				mathGL.BresenhamCircle(circles[i].x, circles[i].y, circles[i].z);
+			generated += points.size();
+			visible += countInside(points, window);
+		}
+		double fullMs = elapsedMs(start);
+
+		start = std::chrono::high_resolution_clock::now();
+		for (unsigned int i = 0; i < primitiveCount; i++) {
+			if (kind == 2 && !ddaEnds[i])
+				continue;
+			clippedPixels += (
+				kind == 0 ? mathGL.drawLineClipped(lines[i].x, lines[i].y, lines[i].z, lines[i].w, window) :
+				kind == 1 ? mathGL.drawLineBasicClipped(lines[i].x, lines[i].y, lines[i].z, lines[i].w, window) :
+				kind == 2 ? mathGL.drawLineDDAClipped(lines[i].x, lines[i].y, lines[i].z, lines[i].w, window) :
+				kind == 3 ? mathGL.drawLineBresClipped(lines[i].x, lines[i].y, lines[i].z, lines[i].w, window) :
+				kind == 4 ? mathGL.midPointCircleClipped(circles[i].x, circles[i].y, circles[i].z, window) :
+				mathGL.BresenhamCircleClipped(circles[i].x, circles[i].y, circles[i].z, window)).size();
+		}
+		double clippedMs = elapsedMs(start);
+
+		if (clippedPixels != visible) {
+			mismatches++;
+		}
+		printf("  %s: %10zu pixels %9.3f ms, clipped first: %8zu pixels %9.3f ms, %.1fx\n", names[kind],
+			generated, fullMs, clippedPixels, clippedMs, fullMs / clippedMs);
+	}
+
+	double x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+	unsigned int accepted = 0;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < primitiveCount; i++) {
+		x1 = lines[i].x; y1 = lines[i].y; x2 = lines[i].z; y2 = lines[i].w;
+		accepted += mathGL.clipLineLiangBarsky(x1, y1, x2, y2, window);
+	}
+	double liangBarskyMs = elapsedMs(start);
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < primitiveCount; i++) {
+		x1 = lines[i].x; y1 = lines[i].y; x2 = lines[i].z; y2 = lines[i].w;
+		accepted -= mathGL.clipLineCohenSutherland(x1, y1, x2, y2, window);
+	}
+	double cohenSutherlandMs = elapsedMs(start);
+
+	printf("  Liang-Barsky %.3f ms, Cohen-Sutherland %.3f ms, disagreements: %u\n", liangBarskyMs, cohenSutherlandMs, accepted);
+	printf("  kinds whose visible pixel count differs: %u\n", mismatches);
+}
+
+/**
+ * This function draws random lines and circles on a square canvas, first one primitive after another
+ * into a row-major bitmap, then with TileRasterizer on one thread and on every hardware thread, and
+ * checks that all of them set the same pixels.
+ * 
+ * @param canvasSize The side of the canvas in pixels.
+ * @param lineCount The number of random lines.
+ * @param circleCount The number of random circles.
+ * @param tileSize The side of the tiles in pixels.
+ */
+void Benchmark::tiledCanvas(int canvasSize, unsigned int lineCount, unsigned int circleCount, int tileSize)
+{
+	std::uniform_int_distribution<int> coord(0, canvasSize - 1);
+	std::uniform_int_distribution<int> offset(-1000, 1000);
+	std::uniform_int_distribution<int> radius(1, 1000);
+	std::vector<Primitive> primitives;
+	primitives.reserve(lineCount + circleCount);
+	for (unsigned int i = 0; i < lineCount; i++) {
+		float x = coord(rng), y = coord(rng);
+		Primitive line = { Primitive::LINE, x, y, x + offset(rng), y + offset(rng) };
+		primitives.push_back(line);
+	}
+	for (unsigned int i = 0; i < circleCount; i++) {
+		Primitive circle = { Primitive::CIRCLE, (float)coord(rng), (float)coord(rng), (float)radius(rng), 0.0f };
+		primitives.push_back(circle);
+	}
+
+	// One primitive after another, every pixel written straight into the row-major canvas.
+	std::vector<uint64_t> canvas((size_t)canvasSize * canvasSize / 64, 0);
+	auto start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < primitives.size(); i++) {
+		const Primitive& primitive = primitives[i];
+		std::vector<glm::vec3> pixels = primitive.kind == Primitive::LINE ?
+			mathGL.drawLineOctant(primitive.x1, primitive.y1, primitive.x2, primitive.y2) :
+			mathGL.BresenhamCircle((int)primitive.x1, (int)primitive.y1, (int)primitive.x2);
+		for (size_t p = 0; p < pixels.size(); p++) {
+			int x = pixels[p].x, y = pixels[p].y;
+			if (x >= 0 && y >= 0 && x < canvasSize && y < canvasSize) {
+				size_t bit = (size_t)y * canvasSize + x;
+				canvas[bit / 64] |= (uint64_t)1 << (bit % 64);
+			}
+		}
+	}
+	double serialMs = elapsedMs(start);
+
+	size_t serialPixels = 0;
+	for (size_t i = 0; i < canvas.size(); i++) {
+		for (uint64_t word = canvas[i]; word != 0; word &= word - 1) {
+			serialPixels++;
+		}
+	}
+
+	printf("[tiledCanvas] %dx%d canvas, %u lines, %u circles, %dx%d tiles\n", canvasSize, canvasSize, lineCount, circleCount, tileSize, tileSize);
+	printf("  one by one, row-major  : %10.3f ms, %zu pixels\n", serialMs, serialPixels);
+
+	unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	unsigned int threadCounts[] = { 1, hardwareThreads };
+	for (int run = 0; run < (hardwareThreads > 1 ? 2 : 1); run++)
+	{
+		TileRasterizer tiles(canvasSize, canvasSize, tileSize);
+		start = std::chrono::high_resolution_clock::now();
+		tiles.bin(primitives, threadCounts[run]);
+		double binMs = elapsedMs(start);
+		start = std::chrono::high_resolution_clock::now();
+		tiles.rasterize(threadCounts[run]);
+		double rasterMs = elapsedMs(start);
+
+		// Same number of pixels and every serial pixel set means the same pixels.
+		size_t tilePixels = tiles.countPixels();
+		size_t missing = 0;
+		for (size_t i = 0; i < canvas.size(); i++) {
+			for (uint64_t word = canvas[i]; word != 0; word &= word - 1) {
+				int bit = 0;
+				while (((word >> bit) & 1) == 0) {
+					bit++;
+				}
+				size_t pixel = i * 64 + bit;
+				missing += !tiles.getPixel(pixel % canvasSize, pixel / canvasSize);
+			}
+		}
+
+		printf("  tiled, %2u thread(s)    : %10.3f ms (bin %.3f + raster %.3f), %.2f tiles per primitive, %zu pixels, %zu missing, %.2fx\n",
+			threadCounts[run], binMs + rasterMs, binMs, rasterMs, (double)tiles.getBinnedReferences() / primitives.size(),
+			tilePixels, missing, serialMs / (binMs + rasterMs));
+	}
+}
+
+/**
+ * This function compares the vector rasterizers with the pixel sources of PixelRange.h on a large
+ * circle and a long line: the time to visit every pixel and the memory held while doing it. Then it
+ * counts the pixels of a circle whose vector would not be worth allocating, and times clipping and
+ * transforming the pixels in chunks against doing it on the whole vector.
+ * 
+ * @param radius The radius of the circle compared against its vector version.
+ * @param countOnlyRadius The radius of the circle only walked lazily.
+ */
+void Benchmark::lazyPixels(double radius, double countOnlyRadius)
+{
+	printf("[lazyPixels] circle of radius %.0f, line of %.0f pixels\n", radius, radius);
+	const char* names[] = { "midPointCircleDraw", "BresenhamCircle   ", "drawLineOctant    " };
+	unsigned int mismatches = 0;
+
+	for (int kind = 0; kind < 3; kind++)
+	{
+		double sumVector = 0, sumLazy = 0;
+		auto start = std::chrono::high_resolution_clock::now();
+		std::vector<glm::vec3> points =
+			kind == 0 ? mathGL.midPointCircleDraw(0, 0, radius) :
+			kind == 1 ? mathGL.BresenhamCircle(0, 0, radius) :
+			mathGL.drawLineOctant(0, 0, radius, radius / 3);
+		for (size_t i = 0; i < points.size(); i++) {
+			sumVector += points[i].x + points[i].y;
+		}
+		double vectorMs = elapsedMs(start);
+		size_t vectorBytes = points.capacity() * sizeof(glm::vec3);
+		size_t vectorCount = points.size();
+		std::vector<glm::vec3>().swap(points);
+
+		size_t lazyCount = 0;
+		glm::vec3 pixel;
+		start = std::chrono::high_resolution_clock::now();
+		if (kind == 0) {
+			MidPointCirclePixels source(0, 0, radius);
+			while (source.next(pixel)) { sumLazy += pixel.x + pixel.y; lazyCount++; }
+		}
+		else if (kind == 1) {
+			BresenhamCirclePixels source(0, 0, radius);
+			while (source.next(pixel)) { sumLazy += pixel.x + pixel.y; lazyCount++; }
+		}
+		else {
+			LineOctantPixels source(0, 0, radius, radius / 3);
+			while (source.next(pixel)) { sumLazy += pixel.x + pixel.y; lazyCount++; }
+		}
+		double lazyMs = elapsedMs(start);
+
+		// Sources give the same pixels, BresenhamCirclePixels in another order, so compare sums.
+		if (lazyCount != vectorCount || sumLazy != sumVector) {
+			mismatches++;
+		}
+		printf("  %s: vector %9.3f ms holding %8.1f MB, lazy %9.3f ms holding %zu bytes, %zu pixels\n", names[kind],
+			vectorMs, vectorBytes / 1048576.0, lazyMs, kind == 0 ? sizeof(MidPointCirclePixels) :
+			kind == 1 ? sizeof(BresenhamCirclePixels) : sizeof(LineOctantPixels), lazyCount);
+	}
+	printf("  sources whose pixels differ from the vector: %u\n", mismatches);
+
+	size_t hugeCount = 0;
+	glm::vec3 pixel;
+	auto start = std::chrono::high_resolution_clock::now();
+	BresenhamCirclePixels huge(0, 0, countOnlyRadius);
+	while (huge.next(pixel)) {
+		hugeCount++;
+	}
+	printf("  BresenhamCirclePixels radius %.0f: %zu pixels counted in %.3f ms, its vector would hold %.1f MB\n",
+		countOnlyRadius, hugeCount, elapsedMs(start), hugeCount * sizeof(glm::vec3) / 1048576.0);
+
+	// Clip to a window, move it and stream it in chunks, the way pixels reach a vertex buffer.
+	const ClipRect window = { radius * 0.5, -radius, radius, radius };
+	glm::mat4 transform = mathGL.translate(glm::vec3(-radius, 0, 0));
+	start = std::chrono::high_resolution_clock::now();
+	std::vector<glm::vec3> clipped = mathGL.BresenhamCircleClipped(0, 0, radius, window);
+	mathGL.transformPoints(transform, clipped);
+	double vectorMs = elapsedMs(start);
+	size_t vectorCount = clipped.size();
+	std::vector<glm::vec3>().swap(clipped);
+
+	std::vector<glm::vec3> chunk(4096);
+	size_t streamed = 0, pulled = 0;
+	TransformedPixels<ClippedPixels<BresenhamCirclePixels> > stream =
+		transformPixels(clipPixels(BresenhamCirclePixels(0, 0, radius), window), transform);
+	start = std::chrono::high_resolution_clock::now();
+	while ((pulled = pullPixels(stream, chunk.data(), chunk.size())) > 0) {
+		streamed += pulled;
+	}
+	double streamMs = elapsedMs(start);
+	printf("  clip + transform: vector %9.3f ms, chunks of %zu %9.3f ms, %zu / %zu pixels\n",
+		vectorMs, chunk.size(), streamMs, streamed, vectorCount);
+}
+
+/**
+ * This function rasterizes lines of a fixed length in random directions, a quarter of them along an
+ * axis or a diagonal, and simplifies the pixels into polylines with increasing tolerances. For each
+ * tolerance it prints the segments left for every pixel pair and the time taken.
+ * 
+ * @param lineCount The number of lines.
+ * @param length The length of the lines along their major axis, in pixels.
+ */
+void Benchmark::polylineSimplify(unsigned int lineCount, int length)
+{
+	std::uniform_real_distribution<double> angle(0.0, 6.283185307179586);
+	std::uniform_int_distribution<int> straight(0, 7);
+	std::vector<std::vector<glm::vec3> > lines(lineCount);
+	size_t pixelSegments = 0;
+	for (unsigned int i = 0; i < lineCount; i++) {
+		double a = i % 4 == 0 ? straight(rng) * 0.7853981633974483 : angle(rng);
+		double dx = cos(a), dy = sin(a);
+		double scale = length / std::max(fabs(dx), fabs(dy));
+		lines[i] = mathGL.drawLineOctant(0, 0, floor(dx * scale + 0.5), floor(dy * scale + 0.5));
+		pixelSegments += lines[i].size() - 1;
+	}
+
+	printf("[polylineSimplify] %u lines of %d pixels, %zu adjacent pixel pairs\n", lineCount, length, pixelSegments);
+	const double tolerances[] = { 0.0, 0.5, 1.0, 2.0 };
+	for (int t = 0; t < 4; t++)
+	{
+		size_t segments = 0;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (unsigned int i = 0; i < lineCount; i++) {
+			segments += mathGL.simplifyPolyline(lines[i], tolerances[t]).size() - 1;
+		}
+		double ms = elapsedMs(start);
+		printf("  tolerance %.1f: %9zu segments (%8.1fx fewer) %9.3f ms\n", tolerances[t], segments,
+			(double)pixelSegments / segments, ms);
+	}
+}
+
+/**
+ * The function counts the points inside a rectangle.
+ * 
+ * @param points The points to test.
+ * @param rect The rectangle.
+ * 
+ * @return the number of points inside, border included.
+ */
+size_t Benchmark::countInside(const std::vector<glm::vec3>& points, const ClipRect& rect)
+{
+	size_t inside = 0;
+	for (size_t i = 0; i < points.size(); i++) {
+		inside += points[i].x >= rect.xMin && points[i].x <= rect.xMax && points[i].y >= rect.yMin && points[i].y <= rect.yMax;
+	}
+	return inside;
+}
+
+/**
+ * The function prints one line of throughput results.
+ * 
+ * @param label The name of the measured variant.
+ * @param ms The time it took, in milliseconds.
+ * @param count The number of elements it processed.
+ */
+void Benchmark::printRate(const char* label, double ms, size_t count)
+{
+	printf("  %s: %10.3f ms (%8.1f M/s)\n", label, ms, count / (ms * 1000.0));
+}
+
+/**
+ * The function returns the milliseconds elapsed since start.
+ * 
+ * @param start The time point at which the measurement began.
+ * 
+ * @return the elapsed wall-clock time in milliseconds.
+ */
+double Benchmark::elapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count();
+}
+
+/**
+ * This function is the baseline for lineOctants: an all-octant Bresenham line that checks the major
+ * axis and step signs inside its loop, the way drawLineDDA and drawLineBasic do.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line.
+ * 
+ * @return A vector of glm::vec3 points going from (x1, y1) to (x2, y2).
+ */
+std::vector<glm::vec3> Benchmark::drawLineBranching(int x1, int y1, int x2, int y2)
+{
+	std::vector<glm::vec3> points;
+	int dx = abs(x2 - x1);
+	int dy = abs(y2 - y1);
+	int x = x1, y = y1;
+	int err = (dx > dy) ? 2 * dy - dx : 2 * dx - dy;
+
+	while (true)
+	{
+		points.push_back(glm::vec3(x, y, 0));
+		if (x == x2 && y == y2)
+			break;
+
+		if (dx > dy)
+		{
+			if (err > 0)
+			{
+				y += (y2 > y1) ? 1 : -1;
+				err -= 2 * dx;
+			}
+			err += 2 * dy;
+			x += (x2 > x1) ? 1 : -1;
+		}
+		else
+		{
+			if (err > 0)
+			{
+				x += (x2 > x1) ? 1 : -1;
+				err -= 2 * dy;
+			}
+			err += 2 * dx;
+			y += (y2 > y1) ? 1 : -1;
+		}
+	}
+	return points;
+}
+
+/**
+ * This is a destructor for the Benchmark class.
+ */
+Benchmark::~Benchmark()
+{
+
+}
+
+/**
+ * This function compares storing rasterized lines and a circle octant as vectors of points against
+ * their chain codes: the bytes held, the time to build each one, and the decode throughput of the
+ * chain codes in GB/s of glm::vec3 written. It also checks that decoding gives back the same pixels.
+ * 
+ * @param lineCount The number of random lines.
+ * @param maxLength The maximum distance between the end points on each axis.
+ * @param radius The radius of the circle octant.
+ */
+void Benchmark::chainCodes(unsigned int lineCount, int maxLength, double radius)
+{
+	std::uniform_int_distribution<int> coord(-maxLength / 2, maxLength / 2);
+	std::vector<glm::vec4> lines(lineCount);
+	for (unsigned int i = 0; i < lineCount; i++) {
+		lines[i] = glm::vec4(coord(rng), coord(rng), coord(rng), coord(rng));
+	}
+
+	printf("[chainCodes] %u lines within +-%d, circle octant of radius %.0f\n", lineCount, maxLength / 2, radius);
+	for (int kind = 0; kind < 2; kind++)
+	{
+		unsigned int count = kind == 0 ? lineCount : 1;
+		std::vector<std::vector<glm::vec3> > vectors(count);
+		std::vector<ChainCode> chains(count);
+		size_t vectorBytes = 0, chainBytes = 0, pixels = 0;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (unsigned int i = 0; i < count; i++) {
+			vectors[i] = kind == 0 ? mathGL.drawLineOctant(lines[i].x, lines[i].y, lines[i].z, lines[i].w) :
+				mathGL.BresenhamCircleOctant(radius);
+			vectorBytes += vectors[i].size() * sizeof(glm::vec3);
+			pixels += vectors[i].size();
+		}
+		double vectorMs = elapsedMs(start);
+
+		start = std::chrono::high_resolution_clock::now();
+		for (unsigned int i = 0; i < count; i++) {
+			chains[i] = kind == 0 ? mathGL.chainLineOctant(lines[i].x, lines[i].y, lines[i].z, lines[i].w) :
+				mathGL.chainBresenhamCircleOctant(radius);
+			chainBytes += chains[i].getBytes();
+		}
+		double chainMs = elapsedMs(start);
+
+		// Decode every chain several times into one buffer, the way pixels are staged for upload.
+		std::vector<glm::vec3> decoded(kind == 0 ? maxLength + 1 : pixels);
+		const int repeats = kind == 0 ? 20 : 50;
+		start = std::chrono::high_resolution_clock::now();
+		for (int r = 0; r < repeats; r++) {
+			for (unsigned int i = 0; i < count; i++) {
+				chains[i].decode(decoded.data());
+			}
+		}
+		double decodeMs = elapsedMs(start) / repeats;
+
+		unsigned int mismatches = 0;
+		for (unsigned int i = 0; i < count; i++) {
+			if (chains[i].decode() != vectors[i]) {
+				mismatches++;
+			}
+		}
+
+		printf("  %s: %zu pixels, vector %8.2f MB in %8.3f ms, chain code %8.3f MB in %8.3f ms (%.1fx smaller)\n",
+			kind == 0 ? "lines " : "octant", pixels, vectorBytes / 1048576.0, vectorMs, chainBytes / 1048576.0, chainMs,
+			(double)vectorBytes / chainBytes);
+		printf("          decode %8.3f ms, %6.2f GB/s of points, %u chains decoded wrong\n",
+			decodeMs, vectorBytes / (decodeMs * 1000000.0), mismatches);
+	}
+}
+
+/**
+ * This function writes the pixels of a large midpoint circle as text, one formatted line per pixel
+ * like the output drawMidPointCircle used to print, and as a RasterFile. Then it reads both back and
+ * checks the mapped pixels are the ones written. The files go to the temporary directory and are
+ * deleted afterwards.
+ * 
+ * @param radius The radius of the circle.
+ */
+void Benchmark::rasterExport(double radius)
+{
+	std::string textFile = TempFile::path("benchmark_points.txt");
+	std::string rasterFile = TempFile::path("benchmark_points.raster");
+	const char* textPath = textFile.c_str();
+	const char* rasterPath = rasterFile.c_str();
+	std::vector<glm::vec3> points = mathGL.midPointCircleDraw(0, 0, radius);
+	double parameters[4] = { 0, 0, radius, 0 };
+
+	auto start = std::chrono::high_resolution_clock::now();
+	{
+		std::ofstream text(textPath);
+		char line[128];
+		for (size_t i = 0; i < points.size(); i++) {
+			snprintf(line, sizeof(line), "point1: (%f, %f, %f)\n", points[i].x, points[i].y, points[i].z);
+			text << line;
+		}
+	}
+	double textWriteMs = elapsedMs(start);
+
+	start = std::chrono::high_resolution_clock::now();
+	size_t textRead = 0;
+	{
+		std::ifstream text(textPath);
+		std::string line;
+		glm::vec3 point;
+		while (std::getline(text, line)) {
+			const char* cursor = strchr(line.c_str(), '(');
+			if (cursor != NULL) {
+				char* end;
+				point.x = strtof(cursor + 1, &end);
+				point.y = strtof(end + 1, &end);
+				point.z = strtof(end + 1, &end);
+				textRead++;
+			}
+		}
+	}
+	double textReadMs = elapsedMs(start);
+
+	start = std::chrono::high_resolution_clock::now();
+	bool written = RasterFile::write(rasterPath, "MPC", parameters, points.data(), points.size());
+	double rasterWriteMs = elapsedMs(start);
+
+	start = std::chrono::high_resolution_clock::now();
+	RasterFile raster;
+	size_t rasterRead = 0, mismatches = 0;
+	size_t rasterBytes = 0;
+	if (written && raster.open(rasterPath)) {
+		rasterBytes = raster.getFileSize();
+		rasterRead = raster.getPixelCount();
+		// Touch every pixel, as an upload would.
+		const glm::vec3* pixels = raster.getPixels();
+		for (size_t i = 0; i < rasterRead && i < points.size(); i++) {
+			mismatches += pixels[i] != points[i];
+		}
+	}
+	double rasterReadMs = elapsedMs(start);
+	raster.close();
+
+	std::ifstream textSize(textPath, std::ios::binary | std::ios::ate);
+	size_t textBytes = (size_t)textSize.tellg();
+	textSize.close();
+	remove(textPath);
+	remove(rasterPath);
+
+	printf("[rasterExport] midpoint circle of radius %.0f, %zu pixels\n", radius, points.size());
+	printf("  text  : write %9.3f ms, read %9.3f ms, %8.2f MB, %zu pixels read\n", textWriteMs, textReadMs, textBytes / 1048576.0, textRead);
+	printf("  raster: write %9.3f ms, read %9.3f ms, %8.2f MB, %zu pixels read, %zu differ\n", rasterWriteMs, rasterReadMs,
+		rasterBytes / 1048576.0, rasterRead, mismatches);
+}
+
+/**
+ * This function rasterizes overlapping random lines and circles and removes the pixels drawn more
+ * than once, with sort and unique over all the pixels like BresenhamCircle does for one circle, with
+ * one PixelSet, and with one PixelSet per thread merged in parallel. It prints the overdraw saved and
+ * checks the three agree.
+ * 
+ * @param primitiveCount The number of lines and of circles.
+ * @param extent The maximum distance of the end points and centers from the origin on each axis.
+ */
+void Benchmark::pixelDedup(unsigned int primitiveCount, int extent)
+{
+	std::uniform_int_distribution<int> coord(-extent, extent);
+	std::uniform_int_distribution<int> radius(1, extent / 4);
+	std::vector<std::vector<glm::vec3> > rasterized(2 * primitiveCount);
+	size_t total = 0;
+	for (unsigned int i = 0; i < primitiveCount; i++) {
+		rasterized[2 * i] = mathGL.drawLineOctant(coord(rng), coord(rng), coord(rng), coord(rng));
+		rasterized[2 * i + 1] = mathGL.BresenhamCircle(coord(rng), coord(rng), radius(rng));
+		total += rasterized[2 * i].size() + rasterized[2 * i + 1].size();
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+	std::vector<glm::vec3> all;
+	all.reserve(total);
+	for (size_t i = 0; i < rasterized.size(); i++) {
+		all.insert(all.end(), rasterized[i].begin(), rasterized[i].end());
+	}
+	std::sort(all.begin(), all.end(), [](const glm::vec3& a, const glm::vec3& b) {
+		return a.x != b.x ? a.x < b.x : a.y < b.y;
+	});
+	size_t sortedUnique = std::unique(all.begin(), all.end()) - all.begin();
+	double sortMs = elapsedMs(start);
+	std::vector<glm::vec3>().swap(all);
+
+	start = std::chrono::high_resolution_clock::now();
+	PixelSet single;
+	for (size_t i = 0; i < rasterized.size(); i++) {
+		for (size_t p = 0; p < rasterized[i].size(); p++) {
+			single.insert(rasterized[i][p]);
+		}
+	}
+	double singleMs = elapsedMs(start);
+
+	unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<PixelSet> perThread(threadCount);
+	start = std::chrono::high_resolution_clock::now();
+	std::vector<std::thread> workers;
+	for (unsigned int t = 0; t < threadCount; t++) {
+		workers.push_back(std::thread([&rasterized, &perThread, t, threadCount]() {
+			for (size_t i = t; i < rasterized.size(); i += threadCount) {
+				for (size_t p = 0; p < rasterized[i].size(); p++) {
+					perThread[t].insert(rasterized[i][p]);
+				}
+			}
+		}));
+	}
+	for (size_t t = 0; t < workers.size(); t++) {
+		workers[t].join();
+	}
+	double insertMs = elapsedMs(start);
+	start = std::chrono::high_resolution_clock::now();
+	PixelSet merged;
+	PixelSet::mergeParallel(perThread, merged, threadCount);
+	double mergeMs = elapsedMs(start);
+
+	// Morton order from the set must be strictly increasing and hold every pixel once.
+	uint64_t previous = 0;
+	size_t visited = 0, outOfOrder = 0;
+	merged.forEach([&](int x, int y) {
+		uint64_t code = Morton::encode(Morton::toUnsigned(x), Morton::toUnsigned(y));
+		outOfOrder += visited > 0 && code <= previous;
+		previous = code;
+		visited++;
+	});
+
+	printf("[pixelDedup] %u lines and %u circles within +-%d, %zu pixels rasterized\n", primitiveCount, primitiveCount, extent, total);
+	printf("  sort + unique         : %10.3f ms, %zu pixels\n", sortMs, sortedUnique);
+	printf("  PixelSet              : %10.3f ms, %zu pixels, %zu tiles, %.2f MB\n", singleMs, single.size(),
+		single.getTileCount(), single.getBytes() / 1048576.0);
+	printf("  PixelSet, %2u thread(s): %10.3f ms (insert %.3f + merge %.3f), %zu pixels\n", threadCount,
+		insertMs + mergeMs, insertMs, mergeMs, merged.size());
+	printf("  overdraw saved: %.1f%%, Morton walk: %zu pixels, %zu out of order\n",
+		100.0 * (total - merged.size()) / total, visited, outOfOrder);
+}
+
+/**
+ * This function sorts the pixels of random lines and circles in Morton order with std::stable_sort and
+ * with the radix sort of MortonIndex, on one thread and on all of them, and then times pixel lookups
+ * and neighbour searches on the buffer in drawing order, which has to be scanned whole, against the
+ * same queries on the Morton index.
+ * 
+ * @param primitiveCount The number of lines and of circles to rasterize.
+ * @param extent The maximum distance of the centres and end points from the origin on each axis.
+ * @param queryCount The number of queries run on the index; the scans run a hundredth of them.
+ */
+void Benchmark::mortonOrder(unsigned int primitiveCount, int extent, unsigned int queryCount)
+{
+	std::uniform_int_distribution<int> coord(-extent, extent);
+	std::uniform_int_distribution<int> radius(1, extent / 4);
+	std::vector<glm::vec3> pixels;
+	for (unsigned int i = 0; i < primitiveCount; i++) {
+		std::vector<glm::vec3> line = mathGL.drawLineOctant(coord(rng), coord(rng), coord(rng), coord(rng));
+		std::vector<glm::vec3> circle = mathGL.BresenhamCircle(coord(rng), coord(rng), radius(rng));
+		pixels.insert(pixels.end(), line.begin(), line.end());
+		pixels.insert(pixels.end(), circle.begin(), circle.end());
+	}
+
+	MortonIndex single;
+	auto start = std::chrono::high_resolution_clock::now();
+	single.build(pixels, 1);
+	double singleMs = elapsedMs(start);
+
+	unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+	MortonIndex index;
+	start = std::chrono::high_resolution_clock::now();
+	index.build(pixels, threadCount);
+	double parallelMs = elapsedMs(start);
+
+	// The comparison sort uses the codes of the index, so all three orders must match.
+	start = std::chrono::high_resolution_clock::now();
+	std::vector<std::pair<uint64_t, uint32_t> > keyed(pixels.size());
+	for (size_t i = 0; i < pixels.size(); i++) {
+		keyed[i] = std::make_pair(single.keyOf(pixels[i]), (uint32_t)i);
+	}
+	std::stable_sort(keyed.begin(), keyed.end(), [](const std::pair<uint64_t, uint32_t>& a, const std::pair<uint64_t, uint32_t>& b) {
+		return a.first < b.first;
+	});
+	std::vector<glm::vec3> stableSorted(pixels.size());
+	for (size_t i = 0; i < keyed.size(); i++) {
+		stableSorted[i] = pixels[keyed[i].second];
+	}
+	double stableMs = elapsedMs(start);
+	std::vector<std::pair<uint64_t, uint32_t> >().swap(keyed);
+
+	bool same = single.getPixels() == stableSorted && index.getPixels() == stableSorted;
+	std::vector<glm::vec3>().swap(stableSorted);
+
+	// Queries are centred on drawn pixels, half of them moved by up to 8 pixels so some miss.
+	std::uniform_int_distribution<size_t> pick(0, pixels.size() - 1);
+	std::uniform_int_distribution<int> jitter(-8, 8);
+	std::vector<int> queryX(queryCount), queryY(queryCount);
+	for (unsigned int i = 0; i < queryCount; i++) {
+		const glm::vec3& pixel = pixels[pick(rng)];
+		queryX[i] = (int)pixel.x + (i % 2 ? jitter(rng) : 0);
+		queryY[i] = (int)pixel.y + (i % 2 ? jitter(rng) : 0);
+	}
+	unsigned int scanCount = std::max(1u, queryCount / 100);
+	const int reach = 4;
+
+	size_t scanFound = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < scanCount; i++) {
+		glm::vec3 wanted(queryX[i], queryY[i], 0);
+		scanFound += std::find(pixels.begin(), pixels.end(), wanted) != pixels.end();
+	}
+	double scanLookupMs = elapsedMs(start);
+
+	size_t indexFound = 0, indexFoundAll = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < queryCount; i++) {
+		bool found = index.contains(queryX[i], queryY[i]);
+		indexFound += found && i < scanCount;
+		indexFoundAll += found;
+	}
+	double indexLookupMs = elapsedMs(start);
+
+	size_t scanNeighbours = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < scanCount; i++) {
+		for (size_t p = 0; p < pixels.size(); p++) {
+			scanNeighbours += abs((int)pixels[p].x - queryX[i]) <= reach && abs((int)pixels[p].y - queryY[i]) <= reach;
+		}
+	}
+	double scanNeighbourMs = elapsedMs(start);
+
+	size_t indexNeighbours = 0, indexNeighboursAll = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < queryCount; i++) {
+		size_t count = index.countRange(queryX[i] - reach, queryY[i] - reach, queryX[i] + reach, queryY[i] + reach);
+		indexNeighbours += i < scanCount ? count : 0;
+		indexNeighboursAll += count;
+	}
+	double indexNeighbourMs = elapsedMs(start);
+
+	printf("[mortonOrder] %u lines and %u circles within +-%d, %zu pixels\n", primitiveCount, primitiveCount, extent, pixels.size());
+	printf("  std::stable_sort      : %10.3f ms\n", stableMs);
+	printf("  radix sort, 1 thread  : %10.3f ms (%.2fx)\n", singleMs, stableMs / singleMs);
+	printf("  radix sort, %2u thread(s): %8.3f ms (%.2fx), same order: %s\n", threadCount, parallelMs, stableMs / parallelMs, same ? "yes" : "NO");
+	printf("  lookup, drawing order : %10.3f us/query (%u queries, %zu found)\n", 1000.0 * scanLookupMs / scanCount, scanCount, scanFound);
+	printf("  lookup, Morton index  : %10.3f us/query (%u queries, %zu found, %zu of the first %u)\n",
+		1000.0 * indexLookupMs / queryCount, queryCount, indexFoundAll, indexFound, scanCount);
+	printf("  %dx%d neighbours, drawing order: %10.3f us/query (%zu found)\n", 2 * reach + 1, 2 * reach + 1,
+		1000.0 * scanNeighbourMs / scanCount, scanNeighbours);
+	printf("  %dx%d neighbours, Morton index : %10.3f us/query (%zu found, %zu in the first %u)\n", 2 * reach + 1, 2 * reach + 1,
+		1000.0 * indexNeighbourMs / queryCount, indexNeighboursAll, indexNeighbours, scanCount);
+}
+
+/**
+ * This function indexes the pixels of random lines and circles in a SpatialHash, one primitive at a
+ * time as the viewer does, and times point, radius and rectangle queries on it against scanning all
+ * the pixels, the only way to answer them before. Both must find the same pixels.
+ * 
+ * @param primitiveCount The number of lines and of circles to rasterize.
+ * @param extent The maximum distance of the centres and end points from the origin on each axis.
+ * @param queryCount The number of queries of each kind run on the index; the scans run a hundredth of them.
+ */
+void Benchmark::spatialQueries(unsigned int primitiveCount, int extent, unsigned int queryCount)
+{
+	std::uniform_int_distribution<int> coord(-extent, extent);
+	std::uniform_int_distribution<int> radius(1, extent / 4);
+	std::vector<std::vector<glm::vec3> > rasterized(2 * primitiveCount);
+	std::vector<SpatialHit> pixels;
+	for (unsigned int i = 0; i < primitiveCount; i++) {
+		rasterized[2 * i] = mathGL.drawLineOctant(coord(rng), coord(rng), coord(rng), coord(rng));
+		rasterized[2 * i + 1] = mathGL.BresenhamCircle(coord(rng), coord(rng), radius(rng));
+	}
+	for (unsigned int p = 0; p < rasterized.size(); p++) {
+		for (size_t i = 0; i < rasterized[p].size(); i++) {
+			SpatialHit pixel = { (int)rasterized[p][i].x, (int)rasterized[p][i].y, p };
+			pixels.push_back(pixel);
+		}
+	}
+
+	SpatialHash hash;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (unsigned int p = 0; p < rasterized.size(); p++) {
+		hash.insert(rasterized[p], p);
+	}
+	double insertMs = elapsedMs(start);
+
+	std::uniform_int_distribution<int> around(-extent - 8, extent + 8);
+	std::vector<int> queryX(queryCount), queryY(queryCount);
+	for (unsigned int i = 0; i < queryCount; i++) {
+		queryX[i] = around(rng);
+		queryY[i] = around(rng);
+	}
+	unsigned int scanCount = std::max(1u, queryCount / 100);
+	const int reach = 8;
+	const char* kinds[3] = { "point", "radius 8", "rect 17x17" };
+	double scanMs[3], hashMs[3];
+	size_t scanFound[3] = { 0, 0, 0 }, hashFound[3] = { 0, 0, 0 }, hashFoundAll[3] = { 0, 0, 0 };
+	std::vector<SpatialHit> out;
+
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < scanCount; i++) {
+		for (size_t p = pixels.size(); p-- > 0;) {
+			if (pixels[p].x == queryX[i] && pixels[p].y == queryY[i]) {
+				scanFound[0]++;
+				break;
+			}
+		}
+	}
+	scanMs[0] = elapsedMs(start);
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < scanCount; i++) {
+		for (size_t p = 0; p < pixels.size(); p++) {
+			int dx = pixels[p].x - queryX[i], dy = pixels[p].y - queryY[i];
+			scanFound[1] += dx * dx + dy * dy <= reach * reach;
+		}
+	}
+	scanMs[1] = elapsedMs(start);
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < scanCount; i++) {
+		for (size_t p = 0; p < pixels.size(); p++) {
+			scanFound[2] += abs(pixels[p].x - queryX[i]) <= reach && abs(pixels[p].y - queryY[i]) <= reach;
+		}
+	}
+	scanMs[2] = elapsedMs(start);
+
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < queryCount; i++) {
+		SpatialHit hit;
+		bool found = hash.queryPoint(queryX[i], queryY[i], hit);
+		hashFound[0] += found && i < scanCount;
+		hashFoundAll[0] += found;
+	}
+	hashMs[0] = elapsedMs(start);
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < queryCount; i++) {
+		out.clear();
+		size_t found = hash.queryRadius((float)queryX[i], (float)queryY[i], (float)reach, out);
+		hashFound[1] += i < scanCount ? found : 0;
+		hashFoundAll[1] += found;
+	}
+	hashMs[1] = elapsedMs(start);
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < queryCount; i++) {
+		out.clear();
+		size_t found = hash.queryRect(queryX[i] - reach, queryY[i] - reach, queryX[i] + reach, queryY[i] + reach, out);
+		hashFound[2] += i < scanCount ? found : 0;
+		hashFoundAll[2] += found;
+	}
+	hashMs[2] = elapsedMs(start);
+
+	printf("[spatialQueries] %u lines and %u circles within +-%d, %zu pixels\n", primitiveCount, primitiveCount, extent, pixels.size());
+	printf("  insert: %10.3f ms (%6.1f Mpx/s), %zu cells\n", insertMs, pixels.size() / (insertMs * 1000.0), hash.getCellCount());
+	for (int k = 0; k < 3; k++) {
+		printf("  %-10s scan: %10.3f us/query (%zu found) | hash: %8.3f us/query (%zu found, %zu in the first %u)%s\n", kinds[k],
+			1000.0 * scanMs[k] / scanCount, scanFound[k], 1000.0 * hashMs[k] / queryCount, hashFoundAll[k], hashFound[k], scanCount,
+			scanFound[k] == hashFound[k] ? "" : " MISMATCH");
+	}
+}
+
+/**
+ * This function writes the same primitives into a SparseCanvas and into a dense bitmap of the whole
+ * coordinate space, for a sparse workload, short primitives spread over a huge space, and a dense one,
+ * long primitives over a space a dense bitmap still fits. The sparse workload is also written with a
+ * memory cap that forces paging, and a 1920x1080 window is moved along some of its primitives the
+ * way CanvasView streams the visible tiles. The page file goes to the temporary directory.
+ * 
+ * @param sparseExtent The size of the sparse coordinate space on each axis.
+ * @param denseExtent The size of the dense coordinate space on each axis.
+ * @param primitiveCount The number of lines and of circles of each workload.
+ * @param memoryCap The memory cap of the paged canvas, in bytes.
+ */
+void Benchmark::sparseTiles(int sparseExtent, int denseExtent, unsigned int primitiveCount, size_t memoryCap)
+{
+	for (int workload = 0; workload < 2; workload++) {
+		bool sparse = workload == 0;
+		int extent = sparse ? sparseExtent : denseExtent;
+		int length = sparse ? 200 : extent / 2;
+		std::uniform_int_distribution<int> position(0, extent - 1);
+		std::uniform_int_distribution<int> offset(-length, length);
+		std::uniform_int_distribution<int> radius(1, length / 4);
+		std::vector<std::vector<glm::vec3> > rasterized(2 * primitiveCount);
+		size_t total = 0;
+		ClipRect space = { 0.0, 0.0, extent - 1.0, extent - 1.0 };
+		for (unsigned int i = 0; i < primitiveCount; i++) {
+			int x = position(rng), y = position(rng);
+			rasterized[2 * i] = mathGL.drawLineClipped(x, y, x + offset(rng), y + offset(rng), space);
+			rasterized[2 * i + 1] = mathGL.BresenhamCircleClipped(position(rng), position(rng), radius(rng), space);
+			total += rasterized[2 * i].size() + rasterized[2 * i + 1].size();
+		}
+
+		double denseBytes = (double)extent * extent / 8.0;
+		printf("[sparseTiles] %s: %u lines and %u circles in %dx%d, %zu pixels\n", sparse ? "sparse" : "dense",
+			primitiveCount, primitiveCount, extent, extent, total);
+
+		// A dense bitmap of the sparse space would take over 100 GB, it is only reported.
+		if (!sparse) {
+			auto start = std::chrono::high_resolution_clock::now();
+			std::vector<uint64_t> dense((size_t)extent * extent / 64);
+			for (size_t p = 0; p < rasterized.size(); p++) {
+				for (size_t i = 0; i < rasterized[p].size(); i++) {
+					size_t bit = (size_t)rasterized[p][i].y * extent + (size_t)rasterized[p][i].x;
+					dense[bit / 64] |= (uint64_t)1 << (bit % 64);
+				}
+			}
+			printf("  dense bitmap         : %10.3f ms, %10.1f MB\n", elapsedMs(start), denseBytes / 1048576.0);
+		}
+		else {
+			printf("  dense bitmap         : %10s     %10.1f MB (not allocated)\n", "-", denseBytes / 1048576.0);
+		}
+
+		std::string pagePath = TempFile::path("benchmark.pages");
+		for (int capped = 0; capped < 2; capped++) {
+			SparseCanvas canvas(capped ? memoryCap : (size_t)-1, pagePath.c_str());
+			auto start = std::chrono::high_resolution_clock::now();
+			for (size_t p = 0; p < rasterized.size(); p++) {
+				canvas.write(rasterized[p]);
+			}
+			double writeMs = elapsedMs(start);
+			printf("  sparse canvas%s: %10.3f ms, %10.1f MB resident, %zu tiles, %.1f MB paged out, %llu page-outs, %llu page-ins\n",
+				capped ? ", capped" : "        ", writeMs, canvas.getResidentBytes() / 1048576.0, canvas.getTileCount(),
+				canvas.getPagedBytes() / 1048576.0, canvas.getPageOuts(), canvas.getPageIns());
+
+			if (!sparse || !capped)
+				continue;
+
+			// Pan a 1920x1080 window along the first 20 primitives, centred on their pixels, collecting the
+			// pixels of the tiles it overlaps. A straight pan across the sparse space would cross almost
+			// no populated tile.
+			const int framesPerPrimitive = 10;
+			std::vector<size_t> route;
+			for (size_t p = 0; p < rasterized.size() && route.size() < 20; p++) {
+				if (!rasterized[p].empty())
+					route.push_back(p);
+			}
+			if (route.empty()) {
+				printf("  streaming            : no primitive inside the space, skipped\n");
+				continue;
+			}
+			const int frames = (int)route.size() * framesPerPrimitive;
+			std::vector<uint64_t> keys;
+			std::vector<glm::vec3> pixels;
+			size_t tilesStreamed = 0, pixelsStreamed = 0;
+			start = std::chrono::high_resolution_clock::now();
+			for (int f = 0; f < frames; f++) {
+				const std::vector<glm::vec3>& primitive = rasterized[route[f / framesPerPrimitive]];
+				const glm::vec3& centre = primitive[primitive.size() * (f % framesPerPrimitive) / framesPerPrimitive];
+				double x = centre.x - 960.0, y = centre.y - 540.0;
+				ClipRect window = { x, y, x + 1919.0, y + 1079.0 };
+				canvas.tilesIn(window, keys);
+				for (size_t k = 0; k < keys.size(); k++) {
+					pixels.clear();
+					pixelsStreamed += canvas.appendTilePixels(keys[k], pixels);
+				}
+				tilesStreamed += keys.size();
+			}
+			double streamMs = elapsedMs(start);
+			// Every window is centred on a pixel, so it overlaps at least the tile of that pixel.
+			if (tilesStreamed == 0) {
+				printf("  streaming            : ERROR, the windows met no populated tile\n");
+				continue;
+			}
+			printf("  streaming            : %10.3f ms/frame, %.2f tiles and %.0f pixels per frame, %llu page-ins\n",
+				streamMs / frames, (double)tilesStreamed / frames, (double)pixelsStreamed / frames, canvas.getPageIns());
+		}
+		remove(pagePath.c_str());
+	}
+}
+
+/**
+ * This function rasterizes long random lines with widths from 1 to 64 pixels as spans with
+ * thickLineSpans, against drawing as many drawLineOctant lines as the width, shifted along the minor
+ * axis, which is how a thick line is faked without spans. Spans cost one entry per row however wide
+ * the line is.
+ * 
+ * @param lineCount The number of random lines of each width.
+ * @param length The length of the lines in pixels.
+ */
+void Benchmark::thickLines(unsigned int lineCount, int length)
+{
+	std::uniform_real_distribution<double> angle(0.0, 6.28318530718);
+	std::uniform_int_distribution<int> coord(-length, length);
+	std::vector<glm::vec4> lines(lineCount);
+	for (unsigned int i = 0; i < lineCount; i++) {
+		double a = angle(rng);
+		double x = coord(rng), y = coord(rng);
+		lines[i] = glm::vec4(x, y, floor(x + length * cos(a)), floor(y + length * sin(a)));
+	}
+
+	printf("[thickLines] %u lines of %d pixels\n", lineCount, length);
+	std::vector<PixelSpan> spans;
+	std::vector<glm::vec3> pixels;
+	for (int width = 1; width <= 64; width *= 2) {
+		size_t spanCount = 0, spanPixels = 0;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (unsigned int i = 0; i < lineCount; i++) {
+			mathGL.thickLineSpans(lines[i].x, lines[i].y, lines[i].z, lines[i].w, width, spans);
+			spanCount += spans.size();
+			for (size_t s = 0; s < spans.size(); s++) {
+				spanPixels += spans[s].xEnd - spans[s].xStart + 1;
+			}
+		}
+		double spanMs = elapsedMs(start);
+
+		size_t offsetPixels = 0;
+		start = std::chrono::high_resolution_clock::now();
+		for (unsigned int i = 0; i < lineCount; i++) {
+			bool xMajor = fabs(lines[i].z - lines[i].x) >= fabs(lines[i].w - lines[i].y);
+			for (int o = -width / 2; o < width - width / 2; o++) {
+				float ox = xMajor ? 0.0f : (float)o, oy = xMajor ? (float)o : 0.0f;
+				mathGL.drawLineClipped(lines[i].x + ox, lines[i].y + oy, lines[i].z + ox, lines[i].w + oy,
+					ClipRect{ -1e9, -1e9, 1e9, 1e9 }, pixels);
+				offsetPixels += pixels.size();
+			}
+		}
+		double offsetMs = elapsedMs(start);
+
+		printf("  width %2d: spans %9.3f ms (%8zu spans, %9zu px, %7.1f Mpx/s) | offset lines %9.3f ms (%9zu px) | %.1fx\n",
+			width, spanMs, spanCount, spanPixels, spanPixels / (spanMs * 1000.0), offsetMs, offsetPixels, offsetMs / spanMs);
+	}
+}
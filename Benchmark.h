@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdio.h>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <string.h>
+
+#include <glm.hpp>
+
+#include "MathOGL.h"
+#include "PrimitiveQueue.h"
+#include "TileRasterizer.h"
+#include "PixelRange.h"
+#include "RasterFile.h"
+#include "PixelSet.h"
+#include "MortonIndex.h"
+#include "SpatialHash.h"
+#include "SparseCanvas.h"
+
+class Benchmark
+{
+public:
+	Benchmark();
+
+	void runAll();
+	void lineOctants(unsigned int lineCount, int maxLength);
+	void primitiveFeed(unsigned int producerCount, unsigned int primitivesPerProducer, int maxLength);
+	void vectorBatch(size_t vectorCount);
+	void transformBatch(size_t pointCount);
+	void clipping(unsigned int primitiveCount, int extent);
+	void tiledCanvas(int canvasSize, unsigned int lineCount, unsigned int circleCount, int tileSize);
+	void lazyPixels(double radius, double countOnlyRadius);
+	void polylineSimplify(unsigned int lineCount, int length);
+	void chainCodes(unsigned int lineCount, int maxLength, double radius);
+	void rasterExport(double radius);
+	void pixelDedup(unsigned int primitiveCount, int extent);
+	void mortonOrder(unsigned int primitiveCount, int extent, unsigned int queryCount);
+	void spatialQueries(unsigned int primitiveCount, int extent, unsigned int queryCount);
+	void sparseTiles(int sparseExtent, int denseExtent, unsigned int primitiveCount, size_t memoryCap);
+	void thickLines(unsigned int lineCount, int length);
+
+	~Benchmark();
+
+private:
+	MathOGL mathGL;
+	std::mt19937 rng;
+
+	static double elapsedMs(std::chrono::high_resolution_clock::time_point start);
+	static void printRate(const char* label, double ms, size_t count);
+	static size_t countInside(const std::vector<glm::vec3>& points, const ClipRect& rect);
+	static std::vector<glm::vec3> drawLineBranching(int x1, int y1, int x2, int y2);
+};
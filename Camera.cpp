@@ -19,9 +19,10 @@ Camera::Camera(glm::vec3 startPosition, glm::vec3 startUp, GLfloat startYaw, GLf
 	update();
 }
 
-void Camera::keyControl(bool* keys, GLfloat deltaTime)
+bool Camera::keyControl(bool* keys, GLfloat deltaTime)
 {
 	GLfloat velocity = moveSpeed * deltaTime;
+	glm::vec3 previous = position;
 
 	if (keys[GLFW_KEY_W])
 	{
@@ -42,10 +43,17 @@ void Camera::keyControl(bool* keys, GLfloat deltaTime)
 	{
 		position += right * velocity;
 	}
+
+	return position != previous;
 }
 
-void Camera::mouseControl(GLfloat xChange, GLfloat yChange)
+bool Camera::mouseControl(GLfloat xChange, GLfloat yChange)
 {
+	if (xChange == 0.0f && yChange == 0.0f)
+	{
+		return false;
+	}
+
 	xChange *= turnSpeed;
 	yChange *= turnSpeed;
 
@@ -63,6 +71,7 @@ void Camera::mouseControl(GLfloat xChange, GLfloat yChange)
 	}
 
 	update();
+	return true;
 }
 
 glm::mat4 Camera::calculateViewMatrix()
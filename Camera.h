@@ -12,11 +12,16 @@ public:
 	Camera();
 	Camera(glm::vec3 startPosition, glm::vec3 startUp, GLfloat startYaw, GLfloat startPitch, GLfloat startMoveSpeed, GLfloat startTurnSpeed);
 
-	void keyControl(bool* keys, GLfloat deltaTime);
-	void mouseControl(GLfloat xChange, GLfloat yChange);
+	bool keyControl(bool* keys, GLfloat deltaTime);
+	bool mouseControl(GLfloat xChange, GLfloat yChange);
 
 	glm::mat4 calculateViewMatrix();
 
+	glm::vec3 getPosition() const { return position; }
+	glm::vec3 getFront() const { return front; }
+	glm::vec3 getUp() const { return up; }
+	glm::vec3 getRight() const { return right; }
+
 	~Camera();
 
 private:
@@ -0,0 +1,201 @@
+#include "CanvasView.h"
+
+#include <float.h>
+#include <algorithm>
+
+/**
+ * The CanvasView constructor creates a view with no tile on the GPU. Tiles are uploaded by update,
+ * which needs a GL context.
+ * 
+ * @param canvas The canvas to draw.
+ * @param uploadsPerFrame The most tiles uploaded by one call to update.
+ */
+CanvasView::CanvasView(SparseCanvas& canvas, unsigned int uploadsPerFrame) : canvas(canvas)
+{
+	this->uploadsPerFrame = uploadsPerFrame;
+	uploads = 0;
+	uploadedBytes = 0;
+}
+
+/**
+ * This function returns the bounding box of the part of the z = 0 plane, where the pixels lie, seen
+ * through a camera. Each corner ray of the frustum is cut where it crosses the plane, or at the far
+ * plane when it doesn't reach it.
+ * 
+ * @param projection The projection matrix of the camera.
+ * @param view The view matrix of the camera.
+ * 
+ * @return the visible region of the plane.
+ */
+ClipRect CanvasView::visibleRect(const glm::mat4& projection, const glm::mat4& view)
+{
+	glm::mat4 inverse = glm::inverse(projection * view);
+	ClipRect visible = { DBL_MAX, DBL_MAX, -DBL_MAX, -DBL_MAX };
+	const float corners[4][2] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { -1.0f, 1.0f }, { 1.0f, 1.0f } };
+
+	for (int c = 0; c < 4; c++)
+	{
+		glm::vec4 nearClip = inverse * glm::vec4(corners[c][0], corners[c][1], -1.0f, 1.0f);
+		glm::vec4 farClip = inverse * glm::vec4(corners[c][0], corners[c][1], 1.0f, 1.0f);
+		glm::vec3 nearPoint(nearClip.x / nearClip.w, nearClip.y / nearClip.w, nearClip.z / nearClip.w);
+		glm::vec3 farPoint(farClip.x / farClip.w, farClip.y / farClip.w, farClip.z / farClip.w);
+
+		glm::vec3 point = farPoint;
+		if ((nearPoint.z > 0.0f) != (farPoint.z > 0.0f))
+		{
+			point = nearPoint + (farPoint - nearPoint) * (nearPoint.z / (nearPoint.z - farPoint.z));
+		}
+		visible.xMin = std::min(visible.xMin, (double)point.x);
+		visible.yMin = std::min(visible.yMin, (double)point.y);
+		visible.xMax = std::max(visible.xMax, (double)point.x);
+		visible.yMax = std::max(visible.yMax, (double)point.y);
+	}
+	return visible;
+}
+
+/**
+ * This function makes the GPU hold the tiles of the canvas overlapping a region. Tiles not uploaded
+ * yet or changed since their upload are uploaded, at most uploadsPerFrame of them, and tiles outside
+ * the region are released.
+ * 
+ * @param visible The region to show, in canvas coordinates.
+ * 
+ * @return the number of tiles of the region still waiting to be uploaded.
+ */
+unsigned int CanvasView::update(const ClipRect& visible)
+{
+	canvas.tilesIn(visible, visibleKeys);
+
+	for (std::unordered_map<uint64_t, GpuTile>::iterator it = gpuTiles.begin(); it != gpuTiles.end(); ++it)
+	{
+		it->second.visible = false;
+	}
+
+	unsigned int uploaded = 0, pending = 0;
+	for (size_t i = 0; i < visibleKeys.size(); i++)
+	{
+		std::unordered_map<uint64_t, GpuTile>::iterator found = gpuTiles.find(visibleKeys[i]);
+		if (found == gpuTiles.end())
+		{
+			GpuTile tile = { 0, 0, 0, 0, false };
+			found = gpuTiles.insert(std::make_pair(visibleKeys[i], tile)).first;
+		}
+		GpuTile& tile = found->second;
+		tile.visible = true;
+
+		if (tile.VAO != 0 && tile.version == canvas.getTileVersion(visibleKeys[i]))
+			continue;
+
+		if (uploaded < uploadsPerFrame)
+		{
+			upload(visibleKeys[i], tile);
+			uploaded++;
+		}
+		else
+		{
+			pending++;
+		}
+	}
+
+	for (std::unordered_map<uint64_t, GpuTile>::iterator it = gpuTiles.begin(); it != gpuTiles.end();)
+	{
+		if (it->second.visible)
+		{
+			++it;
+			continue;
+		}
+		release(it->second);
+		it = gpuTiles.erase(it);
+	}
+	return pending;
+}
+
+/**
+ * This function draws the uploaded tiles as points. A shader taking the model, view and projection
+ * matrices must be in use.
+ */
+void CanvasView::render()
+{
+	for (std::unordered_map<uint64_t, GpuTile>::iterator it = gpuTiles.begin(); it != gpuTiles.end(); ++it)
+	{
+		if (it->second.count == 0)
+			continue;
+
+		glBindVertexArray(it->second.VAO);
+		glDrawArrays(GL_POINTS, 0, it->second.count);
+	}
+	glBindVertexArray(0);
+}
+
+/**
+ * This function releases every tile held on the GPU.
+ */
+void CanvasView::clear()
+{
+	for (std::unordered_map<uint64_t, GpuTile>::iterator it = gpuTiles.begin(); it != gpuTiles.end(); ++it)
+	{
+		release(it->second);
+	}
+	gpuTiles.clear();
+}
+
+/**
+ * This function sends the pixels of a tile to its vertex buffer, creating it on the first upload.
+ * 
+ * @param key The key of the tile in the canvas.
+ * @param tile The GPU copy of the tile.
+ */
+void CanvasView::upload(uint64_t key, GpuTile& tile)
+{
+	pixels.clear();
+	canvas.appendTilePixels(key, pixels);
+
+	if (tile.VAO == 0)
+	{
+		glGenVertexArrays(1, &tile.VAO);
+		glBindVertexArray(tile.VAO);
+
+		glGenBuffers(1, &tile.VBO);
+		glBindBuffer(GL_ARRAY_BUFFER, tile.VBO);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+		glEnableVertexAttribArray(0);
+		glBindVertexArray(0);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, tile.VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * pixels.size(), pixels.empty() ? NULL : &pixels[0].x, GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	tile.count = (GLsizei)pixels.size();
+	tile.version = canvas.getTileVersion(key);
+	uploads++;
+	uploadedBytes += sizeof(glm::vec3) * pixels.size();
+}
+
+/**
+ * The function deletes the vertex buffer and vertex array of a tile.
+ * 
+ * @param tile The GPU copy of the tile.
+ */
+void CanvasView::release(GpuTile& tile)
+{
+	if (tile.VBO != 0)
+	{
+		glDeleteBuffers(1, &tile.VBO);
+		tile.VBO = 0;
+	}
+
+	if (tile.VAO != 0)
+	{
+		glDeleteVertexArrays(1, &tile.VAO);
+		tile.VAO = 0;
+	}
+}
+
+/**
+ * The destructor function for the CanvasView class that releases the tiles on the GPU.
+ */
+CanvasView::~CanvasView()
+{
+	clear();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <unordered_map>
+
+#include <GL\glew.h>
+#include <glm.hpp>
+
+#include "SparseCanvas.h"
+
+/**
+ * GPU side of a SparseCanvas. Only the tiles overlapping the region seen by the camera are kept on
+ * the GPU, each in its own vertex buffer of points. Tiles entering the view or changed since their
+ * upload are streamed in a few per frame, so moving over a huge canvas never stalls a frame on a
+ * big upload, and tiles leaving the view are released.
+ */
+class CanvasView
+{
+public:
+	CanvasView(SparseCanvas& canvas, unsigned int uploadsPerFrame);
+
+	static ClipRect visibleRect(const glm::mat4& projection, const glm::mat4& view);
+	unsigned int update(const ClipRect& visible);
+	void render();
+	void clear();
+
+	size_t getTileCount() const { return gpuTiles.size(); }
+	unsigned long long getUploadCount() const { return uploads; }
+	unsigned long long getUploadedBytes() const { return uploadedBytes; }
+
+	~CanvasView();
+
+private:
+	struct GpuTile
+	{
+		GLuint VAO, VBO;
+		GLsizei count;
+		unsigned int version;
+		bool visible;
+	};
+
+	SparseCanvas& canvas;
+	unsigned int uploadsPerFrame;
+	std::unordered_map<uint64_t, GpuTile> gpuTiles;
+	std::vector<uint64_t> visibleKeys;
+	std::vector<glm::vec3> pixels;
+	unsigned long long uploads;
+	unsigned long long uploadedBytes;
+
+	void upload(uint64_t key, GpuTile& tile);
+	static void release(GpuTile& tile);
+
+	CanvasView(const CanvasView&);
+	CanvasView& operator=(const CanvasView&);
+};
@@ -0,0 +1,195 @@
+#include "ChainCode.h"
+
+const int ChainCode::stepX[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+const int ChainCode::stepY[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+/**
+ * The ChainCode constructor creates an empty chain, with no pixels.
+ */
+ChainCode::ChainCode()
+{
+	clear();
+}
+
+/**
+ * The ChainCode constructor creates a chain holding a single pixel.
+ * 
+ * @param x The x-coordinate of the first pixel.
+ * @param y The y-coordinate of the first pixel.
+ */
+ChainCode::ChainCode(int x, int y)
+{
+	start(x, y);
+}
+
+/**
+ * This function empties the chain and sets its first pixel.
+ * 
+ * @param x The x-coordinate of the first pixel.
+ * @param y The y-coordinate of the first pixel.
+ */
+void ChainCode::start(int x, int y)
+{
+	clear();
+	startX = x;
+	startY = y;
+	started = true;
+}
+
+/**
+ * This function empties the chain, leaving no pixels.
+ */
+void ChainCode::clear()
+{
+	startX = 0;
+	startY = 0;
+	started = false;
+	stepCount = 0;
+	words.clear();
+}
+
+/**
+ * This function appends a pixel one step away from the last one. The chain must have been started.
+ * 
+ * @param direction The direction of the step, from 0 to 7.
+ */
+void ChainCode::push(int direction)
+{
+	size_t slot = stepCount % stepsPerWord;
+	if (slot == 0)
+	{
+		words.push_back(0);
+	}
+	words.back() |= (uint64_t)direction << (bitsPerStep * slot);
+	stepCount++;
+}
+
+/**
+ * This function appends a pixel given by its offset from the last one.
+ * 
+ * @param dx The x offset, -1, 0 or 1.
+ * @param dy The y offset, -1, 0 or 1.
+ * 
+ * @return false, leaving the chain untouched, if the pixel is not one of the 8 neighbours of the last
+ * one.
+ */
+bool ChainCode::pushStep(int dx, int dy)
+{
+	int d = direction(dx, dy);
+	if (d < 0)
+		return false;
+	push(d);
+	return true;
+}
+
+/**
+ * This function builds the chain code of a list of pixels, as given by the rasterizers of MathOGL.
+ * 
+ * @param points The pixels in drawing order, each one an 8-neighbour of the previous one.
+ * @param chain Receives the chain code.
+ * 
+ * @return false if two consecutive pixels are not neighbours, the chain then holds the pixels before
+ * them.
+ */
+bool ChainCode::encode(const std::vector<glm::vec3>& points, ChainCode& chain)
+{
+	chain.clear();
+	if (points.empty())
+		return true;
+
+	chain.start((int)points[0].x, (int)points[0].y);
+	for (size_t i = 1; i < points.size(); i++)
+	{
+		if (!chain.pushStep((int)points[i].x - (int)points[i - 1].x, (int)points[i].y - (int)points[i - 1].y))
+			return false;
+	}
+	return true;
+}
+
+/**
+ * This function writes the pixels of the chain. Every full word decodes its 21 steps in a loop of
+ * fixed length with table lookups and no branches, which the compiler unrolls.
+ * 
+ * @param out Destination buffer with room for getPixelCount() points.
+ * 
+ * @return the number of pixels written.
+ */
+size_t ChainCode::decode(glm::vec3* out) const
+{
+	if (!started)
+		return 0;
+
+	int x = startX, y = startY;
+	out[0] = glm::vec3(x, y, 0);
+	glm::vec3* next = out + 1;
+
+	size_t fullWords = stepCount / stepsPerWord;
+	for (size_t w = 0; w < fullWords; w++)
+	{
+		uint64_t word = words[w];
+		for (int i = 0; i < stepsPerWord; i++)
+		{
+			int d = (word >> (bitsPerStep * i)) & 7;
+			x += stepX[d];
+			y += stepY[d];
+			next[i] = glm::vec3(x, y, 0);
+		}
+		next += stepsPerWord;
+	}
+
+	size_t rest = stepCount % stepsPerWord;
+	uint64_t word = rest > 0 ? words[fullWords] : 0;
+	for (size_t i = 0; i < rest; i++)
+	{
+		int d = (word >> (bitsPerStep * i)) & 7;
+		x += stepX[d];
+		y += stepY[d];
+		next[i] = glm::vec3(x, y, 0);
+	}
+
+	return getPixelCount();
+}
+
+/**
+ * This function returns the pixels of the chain.
+ * 
+ * @return a vector of glm::vec3 points, the same ones the chain was built from.
+ */
+std::vector<glm::vec3> ChainCode::decode() const
+{
+	std::vector<glm::vec3> points(getPixelCount());
+	if (!points.empty())
+	{
+		decode(points.data());
+	}
+	return points;
+}
+
+/**
+ * This function returns the direction of a step between neighbouring pixels.
+ * 
+ * @param dx The x offset of the step.
+ * @param dy The y offset of the step.
+ * 
+ * @return the direction from 0 to 7, or -1 if the offset is not a step to one of the 8 neighbours.
+ */
+int ChainCode::direction(int dx, int dy)
+{
+	// Indexed by (dy + 1) * 3 + (dx + 1).
+	static const int directions[9] = { 5, 6, 7, 4, -1, 0, 3, 2, 1 };
+	if (dx < -1 || dx > 1 || dy < -1 || dy > 1)
+		return -1;
+	return directions[(dy + 1) * 3 + (dx + 1)];
+}
+
+/**
+ * This function returns the direction of one step of the chain.
+ * 
+ * @param step The index of the step, below getStepCount().
+ * 
+ * @return the direction from 0 to 7.
+ */
+int ChainCode::getDirection(size_t step) const
+{
+	return (words[step / stepsPerWord] >> (bitsPerStep * (step % stepsPerWord))) & 7;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include <glm.hpp>
+
+/**
+ * Freeman chain code of an 8-connected pixel curve: the first pixel and, for every following pixel,
+ * the direction of the step that reaches it. Directions take 3 bits and are packed 21 to a 64-bit
+ * word, so a pixel costs 3 bits instead of the 12 bytes of a glm::vec3.
+ *
+ * Direction d moves by (stepX[d], stepY[d]): 0 east, 1 north-east, 2 north, 3 north-west, 4 west,
+ * 5 south-west, 6 south and 7 south-east.
+ */
+class ChainCode
+{
+public:
+	enum { bitsPerStep = 3, stepsPerWord = 21 };
+
+	ChainCode();
+	ChainCode(int x, int y);
+
+	void start(int x, int y);
+	void clear();
+	void push(int direction);
+	bool pushStep(int dx, int dy);
+	static bool encode(const std::vector<glm::vec3>& points, ChainCode& chain);
+
+	size_t decode(glm::vec3* out) const;
+	std::vector<glm::vec3> decode() const;
+
+	static int direction(int dx, int dy);
+	int getDirection(size_t step) const;
+	int getStartX() const { return startX; }
+	int getStartY() const { return startY; }
+	size_t getPixelCount() const { return started ? stepCount + 1 : 0; }
+	size_t getStepCount() const { return stepCount; }
+	const std::vector<uint64_t>& getWords() const { return words; }
+	size_t getBytes() const { return sizeof(startX) + sizeof(startY) + sizeof(stepCount) + words.size() * sizeof(uint64_t); }
+
+	static const int stepX[8];
+	static const int stepY[8];
+
+private:
+	int startX, startY;
+	bool started;
+	size_t stepCount;
+	std::vector<uint64_t> words;
+};
@@ -0,0 +1,130 @@
+#include "FrameMonitor.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/**
+ * The FrameMonitor constructor reports every five seconds under a generic name.
+ */
+FrameMonitor::FrameMonitor()
+{
+	name = "frames";
+	reportInterval = 5.0;
+	resetInterval();
+}
+
+/**
+ * The FrameMonitor constructor sets the label of the reports and how often they are printed.
+ * 
+ * @param monitorName A label printed at the start of every report.
+ * @param secondsPerReport The number of seconds between two reports.
+ */
+FrameMonitor::FrameMonitor(const char* monitorName, double secondsPerReport)
+{
+	name = monitorName;
+	reportInterval = secondsPerReport;
+	resetInterval();
+}
+
+/**
+ * This function records a loop wake-up that did not need to draw anything.
+ */
+void FrameMonitor::frameSkipped()
+{
+	skipped++;
+}
+
+/**
+ * This function records a presented frame. It must be called right after swapping buffers.
+ * 
+ * @param inputTime The glfwGetTime() timestamp of the input that caused the frame, or a negative
+ * value when the frame was not caused by input.
+ */
+void FrameMonitor::framePresented(double inputTime)
+{
+	presented++;
+	if (inputTime >= 0.0)
+	{
+		double latency = glfwGetTime() - inputTime;
+		latencyTotal += latency;
+		latencySamples++;
+		if (latency > latencyMax)
+			latencyMax = latency;
+	}
+}
+
+/**
+ * This function prints the statistics of the current interval once it has elapsed and starts a
+ * new one.
+ */
+void FrameMonitor::update()
+{
+	double now = glfwGetTime();
+	double wall = now - intervalStart;
+	if (wall < reportInterval)
+		return;
+
+	double cpu = processCpuSeconds() - cpuStart;
+	printf("[%s] %.1f s: %u frames presented, %u wake-ups skipped, CPU %.1f%%", name, wall, presented, skipped,
+		100.0 * cpu / wall);
+	if (latencySamples > 0)
+	{
+		printf(", input-to-present avg %.2f ms max %.2f ms", 1000.0 * latencyTotal / latencySamples, 1000.0 * latencyMax);
+	}
+	printf("\n");
+
+	resetInterval();
+}
+
+/**
+ * The function returns the CPU time consumed by the process so far, user and kernel time of every
+ * thread included.
+ * 
+ * @return the CPU time in seconds.
+ */
+double FrameMonitor::processCpuSeconds()
+{
+#ifdef _WIN32
+	FILETIME creation, exit, kernel, user;
+	if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+		return 0.0;
+	ULARGE_INTEGER k, u;
+	k.LowPart = kernel.dwLowDateTime;
+	k.HighPart = kernel.dwHighDateTime;
+	u.LowPart = user.dwLowDateTime;
+	u.HighPart = user.dwHighDateTime;
+	// FILETIME counts 100 ns ticks.
+	return (k.QuadPart + u.QuadPart) * 1e-7;
+#else
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+#endif
+}
+
+/**
+ * This function starts a new measurement interval.
+ */
+void FrameMonitor::resetInterval()
+{
+	intervalStart = glfwGetTime();
+	cpuStart = processCpuSeconds();
+	presented = 0;
+	skipped = 0;
+	latencySamples = 0;
+	latencyTotal = 0.0;
+	latencyMax = 0.0;
+}
+
+/**
+ * This is a destructor for the FrameMonitor class.
+ */
+FrameMonitor::~FrameMonitor()
+{
+
+}
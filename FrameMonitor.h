@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdio.h>
+
+#include <GLFW\glfw3.h>
+
+/**
+ * Collects frame statistics of the render loop and prints them periodically: how many loop wake-ups
+ * ended in a presented frame, the CPU usage of the process over the interval, and the latency from
+ * the input that triggered a frame to the moment it was handed to the swap chain.
+ */
+class FrameMonitor
+{
+public:
+	FrameMonitor();
+	FrameMonitor(const char* monitorName, double secondsPerReport);
+
+	void frameSkipped();
+	void framePresented(double inputTime);
+	void update();
+
+	static double processCpuSeconds();
+
+	~FrameMonitor();
+
+private:
+	const char* name;
+	double reportInterval;
+
+	double intervalStart;
+	double cpuStart;
+	unsigned int presented;
+	unsigned int skipped;
+	unsigned int latencySamples;
+	double latencyTotal;
+	double latencyMax;
+
+	void resetInterval();
+};
@@ -0,0 +1,554 @@
+#include "GeometryStore.h"
+
+#include <stdio.h>
+#include <algorithm>
+
+/**
+ * The GeometryStore constructor initializes the GL handles to 0. Buffers are created on upload.
+ */
+GeometryStore::GeometryStore()
+{
+	VAO = 0;
+	VBO = 0;
+	IBO = 0;
+	indirectBuffer = 0;
+	mappedVAO = 0;
+	mappedVBO = 0;
+	useIndirect = false;
+	dirty = false;
+	meshLimit = UINT_MAX;
+	vertexBytesUploaded = 0;
+	vertexBytesReserved = 0;
+	indexBytesUploaded = 0;
+	indexBytesReserved = 0;
+	mappedVertexCount = 0;
+	mappedBytesUploaded = 0;
+	mappedBytesReserved = 0;
+}
+
+/**
+ * This function appends a mesh to the store. Its indices are rebased onto the shared vertex buffer so
+ * that every mesh can be drawn with a plain offset into the shared index buffer.
+ * 
+ * @param mode The primitive mode of the mesh, such as GL_TRIANGLES, GL_LINES or GL_POINTS.
+ * @param vertices An array of GLfloat values, three consecutive values (x, y, z) per vertex.
+ * @param numOfVertices The number of GLfloat values in the vertices array.
+ * @param indices The indices of the mesh, relative to its own vertices.
+ * @param numOfIndices The number of indices in the indices array.
+ * 
+ * @return the handle of the mesh inside the store.
+ */
+unsigned int GeometryStore::addMesh(GLenum mode, const GLfloat* vertices, unsigned int numOfVertices, const unsigned int* indices, unsigned int numOfIndices)
+{
+	GLuint baseVertex = this->vertices.size() / 3;
+
+	MeshRange range;
+	range.mode = mode;
+	range.mapped = false;
+	range.firstIndex = this->indices.size();
+	range.indexCount = numOfIndices;
+	range.baseVertex = baseVertex;
+	range.vertexCount = numOfVertices / 3;
+	meshes.push_back(range);
+
+	this->vertices.insert(this->vertices.end(), vertices, vertices + numOfVertices);
+	this->indices.reserve(this->indices.size() + numOfIndices);
+	for (unsigned int i = 0; i < numOfIndices; i++) {
+		this->indices.push_back(baseVertex + indices[i]);
+	}
+
+	dirty = true;
+	return meshes.size() - 1;
+}
+
+/**
+ * This function appends a list of points drawn as GL_POINTS.
+ * 
+ * @param points The positions of the points.
+ * 
+ * @return the handle of the mesh inside the store.
+ */
+unsigned int GeometryStore::addPoints(const std::vector<glm::vec3>& points)
+{
+	return addPoints(points.empty() ? NULL : points.data(), points.size());
+}
+
+/**
+ * This function appends a copy of an array of points drawn as GL_POINTS. Points are drawn straight
+ * from their vertices, so no indices are stored for them.
+ * 
+ * @param points The positions of the points.
+ * @param count The number of points.
+ * 
+ * @return the handle of the mesh inside the store.
+ */
+unsigned int GeometryStore::addPoints(const glm::vec3* points, size_t count)
+{
+	MeshRange range;
+	range.mode = GL_POINTS;
+	range.mapped = false;
+	range.firstIndex = indices.size();
+	range.indexCount = 0;
+	range.baseVertex = vertices.size() / 3;
+	range.vertexCount = count;
+	meshes.push_back(range);
+
+	if (count > 0) {
+		vertices.insert(vertices.end(), &points[0].x, &points[0].x + count * 3);
+	}
+
+	dirty = true;
+	return meshes.size() - 1;
+}
+
+/**
+ * This function appends an array of points drawn as GL_POINTS without copying it, such as the pixels
+ * of a mapped RasterFile. The next upload sends them from where they are to a buffer of their own, so
+ * the array must stay valid, and the file mapped, until then. They have no CPU copy, so they can't be
+ * passed to addInstance.
+ * 
+ * @param points The positions of the points.
+ * @param count The number of points.
+ * 
+ * @return the handle of the mesh inside the store.
+ */
+unsigned int GeometryStore::addMappedPoints(const glm::vec3* points, size_t count)
+{
+	MeshRange range;
+	range.mode = GL_POINTS;
+	range.mapped = true;
+	range.firstIndex = 0;
+	range.indexCount = 0;
+	range.baseVertex = mappedVertexCount;
+	range.vertexCount = count;
+	meshes.push_back(range);
+
+	if (count > 0) {
+		MappedPoints pending = { points, count, mappedVertexCount };
+		pendingMapped.push_back(pending);
+		mappedVertexCount += count;
+	}
+
+	dirty = true;
+	return meshes.size() - 1;
+}
+
+/**
+ * This function appends the segments joining consecutive points as one GL_LINES mesh, so a whole
+ * polyline is drawn with a single call.
+ * 
+ * @param points The vertices of the polyline, in drawing order.
+ * @param closed Whether the last point is also joined to the first one.
+ * 
+ * @return the handle of the mesh inside the store.
+ */
+unsigned int GeometryStore::addPolyline(const std::vector<glm::vec3>& points, bool closed)
+{
+	std::vector<unsigned int> lineIndices;
+	unsigned int numberOfPoints = points.size();
+	lineIndices.reserve(numberOfPoints * 2);
+	for (unsigned int i = 1; i < numberOfPoints; i++) {
+		lineIndices.push_back(i - 1);
+		lineIndices.push_back(i);
+	}
+	if (closed && numberOfPoints > 2) {
+		lineIndices.push_back(numberOfPoints - 1);
+		lineIndices.push_back(0);
+	}
+	return addMesh(GL_LINES, points.empty() ? NULL : &points[0].x, numberOfPoints * 3, lineIndices.data(), lineIndices.size());
+}
+
+/**
+ * This function appends spans of pixels, such as those of MathOGL::thickLineSpans, as one
+ * GL_TRIANGLES mesh with a quad covering each span, so thick lines don't rely on glLineWidth.
+ * 
+ * @param spans The spans, each covering its pixels from half a pixel before xStart to half a pixel
+ * after xEnd.
+ * 
+ * @return the handle of the mesh inside the store.
+ */
+unsigned int GeometryStore::addSpans(const std::vector<PixelSpan>& spans)
+{
+	std::vector<GLfloat> spanVertices;
+	std::vector<unsigned int> spanIndices;
+	spanVertices.reserve(spans.size() * 12);
+	spanIndices.reserve(spans.size() * 6);
+	for (unsigned int i = 0; i < spans.size(); i++) {
+		GLfloat left = spans[i].xStart - 0.5f, right = spans[i].xEnd + 0.5f;
+		GLfloat bottom = spans[i].y - 0.5f, top = spans[i].y + 0.5f;
+		GLfloat quad[12] = { left, bottom, 0.0f, right, bottom, 0.0f, right, top, 0.0f, left, top, 0.0f };
+		spanVertices.insert(spanVertices.end(), quad, quad + 12);
+
+		unsigned int corners[6] = { 4 * i, 4 * i + 1, 4 * i + 2, 4 * i, 4 * i + 2, 4 * i + 3 };
+		spanIndices.insert(spanIndices.end(), corners, corners + 6);
+	}
+	return addMesh(GL_TRIANGLES, spanVertices.data(), spanVertices.size(), spanIndices.data(), spanIndices.size());
+}
+
+/**
+ * This function appends a transformed copy of a mesh already in the store, reusing its pixels instead
+ * of running the rasterizer again.
+ * 
+ * @param mesh The handle of the mesh to copy.
+ * @param transform The transformation applied to the vertices of the copy.
+ * 
+ * @return the handle of the copy inside the store, or UINT_MAX for a mesh of addMappedPoints.
+ */
+unsigned int GeometryStore::addInstance(unsigned int mesh, const glm::mat4& transform)
+{
+	MeshRange source = meshes[mesh];
+	if (source.mapped)
+	{
+		printf("Error instancing mesh %u: its points are only on the GPU\n", mesh);
+		return UINT_MAX;
+	}
+
+	std::vector<GLfloat> instanceVertices(vertices.begin() + source.baseVertex * 3,
+		vertices.begin() + (source.baseVertex + source.vertexCount) * 3);
+	mathGL.transformPoints(transform, (glm::vec3*)instanceVertices.data(), source.vertexCount);
+
+	std::vector<unsigned int> instanceIndices(indices.begin() + source.firstIndex,
+		indices.begin() + source.firstIndex + source.indexCount);
+	for (size_t i = 0; i < instanceIndices.size(); i++) {
+		instanceIndices[i] -= source.baseVertex;
+	}
+
+	return addMesh(source.mode, instanceVertices.data(), instanceVertices.size(), instanceIndices.data(), instanceIndices.size());
+}
+
+/**
+ * This function makes room for more vertices and indices, such as the pixels MathOGL counts for the
+ * primitives about to be added. The GPU buffers are sized from the same room on the next upload, so
+ * neither the CPU copy nor the buffers grow step by step while the primitives are added.
+ * 
+ * @param vertexCount The number of vertices expected on top of the current ones.
+ * @param indexCount The number of indices expected on top of the current ones.
+ */
+void GeometryStore::reserve(size_t vertexCount, size_t indexCount)
+{
+	vertices.reserve(vertices.size() + 3 * vertexCount);
+	indices.reserve(indices.size() + indexCount);
+}
+
+/**
+ * This function hides every mesh from the given handle on, including the ones added later, so that a
+ * different renderer can draw the same primitives instead. The draw commands are rebuilt on the next
+ * render; no geometry is sent again.
+ * 
+ * @param limit The handle of the first hidden mesh, UINT_MAX to draw them all.
+ */
+void GeometryStore::setMeshLimit(unsigned int limit)
+{
+	if (limit != meshLimit)
+	{
+		meshLimit = limit;
+		dirty = true;
+	}
+}
+
+/**
+ * This function sends the stored geometry and the draw commands to the GPU. It must be called with
+ * a current GL context after meshes are added and before rendering them. Meshes added since the
+ * previous upload are appended to the buffers, which are reallocated with the capacity of the CPU
+ * copy when they run out of room.
+ */
+void GeometryStore::upload()
+{
+	useIndirect = GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect;
+
+	if (VAO == 0)
+	{
+		glGenVertexArrays(1, &VAO);
+		glGenBuffers(1, &VBO);
+		glGenBuffers(1, &IBO);
+	}
+
+	glBindVertexArray(VAO);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+	uploadTail(GL_ELEMENT_ARRAY_BUFFER, indices.data(), sizeof(GLuint) * indices.size(), sizeof(GLuint) * indices.capacity(),
+		indexBytesUploaded, indexBytesReserved);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	uploadTail(GL_ARRAY_BUFFER, vertices.data(), sizeof(GLfloat) * vertices.size(), sizeof(GLfloat) * vertices.capacity(),
+		vertexBytesUploaded, vertexBytesReserved);
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+	glEnableVertexAttribArray(0);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	uploadMapped();
+
+	std::vector<DrawCommand> commands;
+	buildBatches(commands);
+
+	if (useIndirect)
+	{
+		if (indirectBuffer == 0)
+		{
+			glGenBuffers(1, &indirectBuffer);
+		}
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(DrawCommand) * commands.size(), commands.data(), GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+
+	dirty = false;
+}
+
+/**
+ * This function sends the bytes of data past bytesUploaded to the buffer bound to target. When data
+ * no longer fits, the buffer is reallocated with the capacity of the CPU copy, which reserve sizes
+ * from the predicted pixel counts and which otherwise grows geometrically, and sent again whole.
+ * 
+ * @param target The binding point of the buffer, such as GL_ARRAY_BUFFER.
+ * @param data The CPU copy of the whole buffer contents.
+ * @param bytes The size of data in bytes.
+ * @param capacityBytes The room allocated for the CPU copy, in bytes.
+ * @param bytesUploaded The number of leading bytes of data already on the GPU, updated on return.
+ * @param bytesReserved The allocated size of the GPU buffer, updated on return.
+ */
+void GeometryStore::uploadTail(GLenum target, const void* data, size_t bytes, size_t capacityBytes, size_t& bytesUploaded, size_t& bytesReserved)
+{
+	if (bytes > bytesReserved)
+	{
+		bytesReserved = std::max(bytes, capacityBytes);
+		glBufferData(target, bytesReserved, NULL, GL_DYNAMIC_DRAW);
+		bytesUploaded = 0;
+	}
+
+	if (bytes > bytesUploaded)
+	{
+		glBufferSubData(target, bytesUploaded, bytes - bytesUploaded, (const char*)data + bytesUploaded);
+	}
+	bytesUploaded = bytes;
+}
+
+/**
+ * This function sends the points of addMappedPoints added since the previous upload from their
+ * mappings to the mapped buffer. When they don't fit, the buffer is replaced by a larger one and the
+ * points sent before are copied over on the GPU, since their mappings may be gone.
+ */
+void GeometryStore::uploadMapped()
+{
+	if (pendingMapped.empty())
+		return;
+
+	size_t bytes = sizeof(glm::vec3) * mappedVertexCount;
+	if (bytes > mappedBytesReserved)
+	{
+		GLuint buffer;
+		glGenBuffers(1, &buffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		glBufferData(GL_COPY_WRITE_BUFFER, bytes, NULL, GL_STATIC_DRAW);
+		if (mappedBytesUploaded > 0)
+		{
+			glBindBuffer(GL_COPY_READ_BUFFER, mappedVBO);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, mappedBytesUploaded);
+			glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		}
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		if (mappedVBO != 0)
+		{
+			glDeleteBuffers(1, &mappedVBO);
+		}
+		mappedVBO = buffer;
+		mappedBytesReserved = bytes;
+	}
+
+	if (mappedVAO == 0)
+	{
+		glGenVertexArrays(1, &mappedVAO);
+	}
+	glBindVertexArray(mappedVAO);
+	glBindBuffer(GL_ARRAY_BUFFER, mappedVBO);
+	for (size_t i = 0; i < pendingMapped.size(); i++)
+	{
+		const MappedPoints& pending = pendingMapped[i];
+		glBufferSubData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * pending.baseVertex, sizeof(glm::vec3) * pending.count, pending.points);
+	}
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+	glEnableVertexAttribArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	mappedBytesUploaded = bytes;
+	pendingMapped.clear();
+}
+
+/**
+ * This function draws every mesh of the store with one multi-draw call per primitive mode, and one
+ * more for the points of addMappedPoints, which are drawn last from their own VAO.
+ */
+void GeometryStore::render()
+{
+	if (dirty)
+	{
+		upload();
+	}
+
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+	if (useIndirect)
+	{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+	}
+
+	for (size_t i = 0; i < batches.size(); i++)
+	{
+		const Batch& batch = batches[i];
+		if (batch.mapped)
+		{
+			glBindVertexArray(mappedVAO);
+		}
+
+		const void* offset = (const void*)(sizeof(DrawCommand) * batch.firstCommand);
+		if (batch.indexed && useIndirect)
+		{
+			glMultiDrawElementsIndirect(batch.mode, GL_UNSIGNED_INT, offset, batch.counts.size(), 0);
+		}
+		else if (batch.indexed)
+		{
+			glMultiDrawElements(batch.mode, batch.counts.data(), GL_UNSIGNED_INT, batch.offsets.data(), batch.counts.size());
+		}
+		else if (useIndirect)
+		{
+			glMultiDrawArraysIndirect(batch.mode, offset, batch.counts.size(), sizeof(DrawCommand));
+		}
+		else
+		{
+			glMultiDrawArrays(batch.mode, batch.firsts.data(), batch.counts.data(), batch.counts.size());
+		}
+	}
+
+	if (useIndirect)
+	{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+/**
+ * This function groups the meshes by primitive mode, keeping triangles, lines and points in that
+ * drawing order, and fills the indirect commands and the glMultiDrawElements or glMultiDrawArrays
+ * arrays of each group. Points without indices form groups of their own, the mapped ones last of all.
+ * 
+ * @param commands Receives the indirect draw commands, grouped by batch.
+ */
+void GeometryStore::buildBatches(std::vector<DrawCommand>& commands)
+{
+	static const GLenum modeOrder[] = { GL_TRIANGLES, GL_LINES, GL_POINTS };
+
+	batches.clear();
+	commands.clear();
+	commands.reserve(meshes.size());
+
+	for (size_t m = 0; m < sizeof(modeOrder) / sizeof(modeOrder[0]); m++)
+	{
+		// Indexed meshes, then points drawn from the VBO, then points drawn from the mapped buffer.
+		for (int kind = 0; kind < 3; kind++)
+		{
+			Batch batch;
+			batch.mode = modeOrder[m];
+			batch.indexed = kind == 0;
+			batch.mapped = kind == 2;
+			batch.firstCommand = commands.size();
+
+			for (size_t i = 0; i < meshes.size() && i < meshLimit; i++)
+			{
+				const MeshRange& range = meshes[i];
+				if (range.mode != batch.mode || range.mapped != batch.mapped)
+					continue;
+
+				if (batch.indexed && range.indexCount > 0)
+				{
+					DrawCommand command = { range.indexCount, 1, range.firstIndex, 0, 0 };
+					commands.push_back(command);
+					batch.counts.push_back(range.indexCount);
+					batch.offsets.push_back((const void*)(sizeof(GLuint) * range.firstIndex));
+				}
+				else if (!batch.indexed && range.mode == GL_POINTS && range.indexCount == 0 && range.vertexCount > 0)
+				{
+					DrawCommand command = { range.vertexCount, 1, range.baseVertex, 0, 0 };
+					commands.push_back(command);
+					batch.counts.push_back(range.vertexCount);
+					batch.firsts.push_back(range.baseVertex);
+				}
+			}
+
+			if (!batch.counts.empty())
+			{
+				batches.push_back(batch);
+			}
+		}
+	}
+}
+
+/**
+ * The function deletes the GL objects of the store and forgets every mesh.
+ */
+void GeometryStore::clear()
+{
+	if (indirectBuffer != 0)
+	{
+		glDeleteBuffers(1, &indirectBuffer);
+		indirectBuffer = 0;
+	}
+
+	if (IBO != 0)
+	{
+		glDeleteBuffers(1, &IBO);
+		IBO = 0;
+	}
+
+	if (mappedVBO != 0)
+	{
+		glDeleteBuffers(1, &mappedVBO);
+		mappedVBO = 0;
+	}
+
+	if (mappedVAO != 0)
+	{
+		glDeleteVertexArrays(1, &mappedVAO);
+		mappedVAO = 0;
+	}
+
+	if (VBO != 0)
+	{
+		glDeleteBuffers(1, &VBO);
+		VBO = 0;
+	}
+
+	if (VAO != 0)
+	{
+		glDeleteVertexArrays(1, &VAO);
+		VAO = 0;
+	}
+
+	vertices.clear();
+	indices.clear();
+	meshes.clear();
+	batches.clear();
+	pendingMapped.clear();
+	dirty = false;
+	meshLimit = UINT_MAX;
+	vertexBytesUploaded = 0;
+	vertexBytesReserved = 0;
+	indexBytesUploaded = 0;
+	indexBytesReserved = 0;
+	mappedVertexCount = 0;
+	mappedBytesUploaded = 0;
+	mappedBytesReserved = 0;
+}
+
+/**
+ * The destructor function for the GeometryStore class that clears the store.
+ */
+GeometryStore::~GeometryStore()
+{
+	clear();
+}
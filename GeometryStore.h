@@ -0,0 +1,143 @@
+#pragma once
+
+#include <vector>
+#include <limits.h>
+
+#include <GL\glew.h>
+#include <glm.hpp>
+
+#include "MathOGL.h"
+#include "PixelRange.h"
+
+/**
+ * Shared vertex and index storage for every primitive of the scene. Each mesh is a sub-allocation of
+ * one VBO/IBO pair behind a single VAO, and a frame is submitted with one multi-draw per primitive
+ * mode: glMultiDrawElementsIndirect when the context supports it, glMultiDrawElements otherwise.
+ * Points need no indices, so they are drawn straight from their vertices with glMultiDrawArrays and
+ * glMultiDrawArraysIndirect. Points borrowed from a mapped RasterFile live in a buffer of their own,
+ * sent from the mapping on upload without a CPU copy.
+ */
+class GeometryStore
+{
+public:
+	GeometryStore();
+
+	unsigned int addMesh(GLenum mode, const GLfloat* vertices, unsigned int numOfVertices, const unsigned int* indices, unsigned int numOfIndices);
+	unsigned int addPoints(const std::vector<glm::vec3>& points);
+	unsigned int addPoints(const glm::vec3* points, size_t count);
+	unsigned int addMappedPoints(const glm::vec3* points, size_t count);
+	template <typename Source>
+	unsigned int addPixels(Source& source);
+	unsigned int addPolyline(const std::vector<glm::vec3>& points, bool closed);
+	unsigned int addSpans(const std::vector<PixelSpan>& spans);
+	unsigned int addInstance(unsigned int mesh, const glm::mat4& transform);
+	void reserve(size_t vertexCount, size_t indexCount);
+	void setMeshLimit(unsigned int limit);
+	void upload();
+	void render();
+	void clear();
+
+	unsigned int getMeshCount() { return meshes.size(); }
+	unsigned int getDrawCallCount() { return batches.size(); }
+	bool usesIndirect() { return useIndirect; }
+
+	~GeometryStore();
+
+private:
+	// Layout mandated by glMultiDrawElementsIndirect. Commands of glMultiDrawArraysIndirect share the
+	// buffer and the stride: count, instanceCount, first and baseInstance fill the first four fields.
+	struct DrawCommand
+	{
+		GLuint count;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
+
+	// Points have no indices and are drawn from baseVertex, in the mapped buffer when mapped is set.
+	struct MeshRange
+	{
+		GLenum mode;
+		bool mapped;
+		GLuint firstIndex;
+		GLuint indexCount;
+		GLuint baseVertex;
+		GLuint vertexCount;
+	};
+
+	// Meshes drawn with one multi-draw: indexed ones with offsets into the IBO, points with firsts.
+	struct Batch
+	{
+		GLenum mode;
+		bool indexed;
+		bool mapped;
+		GLsizei firstCommand;
+		std::vector<GLsizei> counts;
+		std::vector<const void*> offsets;
+		std::vector<GLint> firsts;
+	};
+
+	// Points of addMappedPoints not on the GPU yet, read from the mapping on the next upload.
+	struct MappedPoints
+	{
+		const glm::vec3* points;
+		size_t count;
+		GLuint baseVertex;
+	};
+
+	MathOGL mathGL;
+	GLuint VAO, VBO, IBO, indirectBuffer;
+	GLuint mappedVAO, mappedVBO;
+	bool useIndirect;
+	bool dirty;
+	// Only the meshes with a handle below it are drawn.
+	unsigned int meshLimit;
+
+	std::vector<GLfloat> vertices;
+	std::vector<GLuint> indices;
+	std::vector<MeshRange> meshes;
+	std::vector<Batch> batches;
+	std::vector<MappedPoints> pendingMapped;
+	GLuint mappedVertexCount;
+
+	// Bytes already on the GPU and bytes allocated for each buffer, so appends only send the new tail.
+	size_t vertexBytesUploaded, vertexBytesReserved;
+	size_t indexBytesUploaded, indexBytesReserved;
+	size_t mappedBytesUploaded, mappedBytesReserved;
+
+	void buildBatches(std::vector<DrawCommand>& commands);
+	void uploadMapped();
+	static void uploadTail(GLenum target, const void* data, size_t bytes, size_t capacityBytes, size_t& bytesUploaded, size_t& bytesReserved);
+};
+
+/**
+ * This function appends the pixels of a PixelRange.h source drawn as GL_POINTS. They are pulled in
+ * chunks straight into the shared vertex storage, so no vector of the whole primitive is built first.
+ * 
+ * @param source The source to drain.
+ * 
+ * @return the handle of the mesh inside the store.
+ */
+template <typename Source>
+unsigned int GeometryStore::addPixels(Source& source)
+{
+	MeshRange range;
+	range.mode = GL_POINTS;
+	range.mapped = false;
+	range.firstIndex = indices.size();
+	range.indexCount = 0;
+	range.baseVertex = vertices.size() / 3;
+
+	glm::vec3 chunk[256];
+	size_t pulled;
+	while ((pulled = pullPixels(source, chunk, 256)) > 0) {
+		vertices.insert(vertices.end(), &chunk[0].x, &chunk[0].x + pulled * 3);
+	}
+
+	range.vertexCount = vertices.size() / 3 - range.baseVertex;
+	meshes.push_back(range);
+
+	dirty = true;
+	return meshes.size() - 1;
+}
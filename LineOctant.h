@@ -0,0 +1,63 @@
+#pragma once
+#include <glm.hpp>
+
+/**
+ * Bresenham line kernel specialized at compile time for one octant. StepX and StepY are the signs
+ * of the walk (+1 or -1) and XMajor tells whether x is the axis advanced on every pixel, so the
+ * direction is resolved once per line and the inner loop carries no direction branches.
+ */
+template <int StepX, int StepY, bool XMajor>
+struct LineOctant
+{
+	/**
+	 * The function writes the dMajor + 1 pixels of the line starting at (x, y) into out.
+	 *
+	 * @param x The x-coordinate of the starting pixel.
+	 * @param y The y-coordinate of the starting pixel.
+	 * @param dMajor The absolute distance along the major axis.
+	 * @param dMinor The absolute distance along the minor axis.
+	 * @param out Destination buffer with room for dMajor + 1 points.
+	 */
+	static void rasterize(int x, int y, int dMajor, int dMinor, glm::vec3* out)
+	{
+		rasterizeSpan(x, y, 2 * dMinor - dMajor, dMajor + 1, dMajor, dMinor, out);
+	}
+
+	/**
+	 * The function writes count pixels of a line, resuming the walk from any of its pixels. Starting
+	 * with the error term the walk has at that pixel gives exactly the pixels of the whole line.
+	 *
+	 * @param x The x-coordinate of the first pixel to write.
+	 * @param y The y-coordinate of the first pixel to write.
+	 * @param err The error term of the walk at that pixel, 2 * dMinor - dMajor for the first one.
+	 * @param count The number of pixels to write.
+	 * @param dMajor The absolute distance along the major axis of the whole line.
+	 * @param dMinor The absolute distance along the minor axis of the whole line.
+	 * @param out Destination buffer with room for count points.
+	 */
+	static void rasterizeSpan(int x, int y, int err, int count, int dMajor, int dMinor, glm::vec3* out)
+	{
+		const int stepMinor = 2 * dMinor;
+		const int stepBoth = 2 * dMinor - 2 * dMajor;
+
+		for (int i = 0; i < count; i++)
+		{
+			out[i] = glm::vec3(x, y, 0);
+
+			// 1 when the minor axis advances on this step, 0 otherwise.
+			int minor = err > 0;
+			err += minor ? stepBoth : stepMinor;
+
+			if (XMajor)
+			{
+				x += StepX;
+				y += StepY * minor;
+			}
+			else
+			{
+				y += StepY;
+				x += StepX * minor;
+			}
+		}
+	}
+};
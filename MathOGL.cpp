@@ -1,4 +1,12 @@
 #include "MathOGL.h"
+#include "LineOctant.h"
+#include "SimdFloat.h"
+
+#include <thread>
+#include <functional>
+#include <climits>
+#include <cfloat>
+#include <utility>
 
 /**
  * This is the constructor for the MathOGL class in C++.
@@ -169,227 +177,1979 @@ glm::mat4 MathOGL::translate(glm::vec3 t) {
 }
 
 /**
- * This function draws a basic line using the Basic's algorithm and returns a vector of points.
+ * The function returns a 4x4 matrix that scales each axis by the matching component of s.
  * 
- * @param x1 The x-coordinate of the starting point of the line.
- * @param y1 The y-coordinate of the starting point of the line.
- * @param x2 The x-coordinate of the end point of the line.
- * @param y2 The y-coordinate of the end point of the line.
+ * @param s The scale factors in the x, y, and z directions.
  * 
- * @return A vector of glm::vec3 points representing a basic line drawn between two given points (x1,
- * y1) and (x2, y2).
+ * @return a scale transformation matrix.
  */
-std::vector<glm::vec3> MathOGL::drawLineBasic(double x1, double y1, double x2, double y2) 
+glm::mat4 MathOGL::scale(glm::vec3 s)
 {
-	std::vector<glm::vec3> points;
-	double dx = abs(x2 - x1);
-	double dy = abs(y2 - y1);
-	double m = dy / dx;
-	double xi, yi;
-	int i = x1;
-	yi = y1;
-	points.push_back(glm::vec3(i, yi, 0));
-	while (i < x2) {
-		i = i + 1;
-		xi = i;
-		yi = roundf(yi + m);
-		points.push_back(glm::vec3(xi, yi, 0));
-	}
-	return points;
+	glm::mat4 result(1.0f);
+	result[0][0] = s.x;
+	result[1][1] = s.y;
+	result[2][2] = s.z;
+	return result;
 }
 
 /**
- * This function uses Bresenham's line algorithm to draw a line between two points and returns a vector
- * of points along the line.
+ * The function returns a 4x4 matrix that rotates around an axis through the origin, built with
+ * Rodrigues' rotation formula.
  * 
- * @param x1 The x-coordinate of the starting point of the line.
- * @param y1 The y-coordinate of the starting point of the line.
- * @param x2 The x-coordinate of the end point of the line.
- * @param y2 The y-coordinate of the end point of the line.
+ * @param angle The angle of the rotation in radians, counterclockwise when looking down the axis.
+ * @param axis The axis of the rotation, it doesn't need to be normalized.
  * 
- * @return A vector of glm::vec3 points representing a line drawn using Bresenham's line algorithm
- * between the points (x1, y1) and (x2, y2).
+ * @return a rotation transformation matrix.
  */
-std::vector<glm::vec3> MathOGL::drawLineBres(double x1, double y1, double x2, double y2)
+glm::mat4 MathOGL::rotate(double angle, glm::vec3 axis)
 {
-	std::vector<glm::vec3> points;
-	double dx = x2 - x1;
-	double dy = y2 - y1;
-	double pk = 2 * dy - dx;
+	glm::vec3 u = normalize(axis);
+	float c = (float)cos(angle);
+	float s = (float)sin(angle);
+	float t = 1.0f - c;
 
-	for (int x = x1, y = y1; x <= x2; x++) {
+	glm::mat4 result(1.0f);
+	result[0] = glm::vec4(t * u.x * u.x + c, t * u.x * u.y + s * u.z, t * u.x * u.z - s * u.y, 0.0f);
+	result[1] = glm::vec4(t * u.x * u.y - s * u.z, t * u.y * u.y + c, t * u.y * u.z + s * u.x, 0.0f);
+	result[2] = glm::vec4(t * u.x * u.z + s * u.y, t * u.y * u.z - s * u.x, t * u.z * u.z + c, 0.0f);
+	return result;
+}
 
-		points.push_back(glm::vec3(x, y, 0));
+/**
+ * The function combines two transformations into one matrix.
+ * 
+ * @param first The transformation applied first.
+ * @param second The transformation applied to the result of first.
+ * 
+ * @return the matrix that applies first and then second.
+ */
+glm::mat4 MathOGL::compose(const glm::mat4& first, const glm::mat4& second)
+{
+	return second * first;
+}
 
-		dx = x2 - x;
-		dy = y2 - y;
+/**
+ * The function applies a transformation to a buffer of points in place, so rasterized shapes can be
+ * moved or instanced without rasterizing them again. Pure translations and transformations of the
+ * xy plane take cheaper paths than a full matrix product, projective matrices divide by w, and large
+ * buffers are split across threads.
+ * 
+ * @param transform The transformation matrix.
+ * @param points The points to transform.
+ * @param count The number of points.
+ */
+void MathOGL::transformPoints(const glm::mat4& transform, glm::vec3* points, size_t count)
+{
+	TransformKind kind = classifyTransform(transform);
+	if (kind == transformIdentity || count == 0)
+		return;
 
-		if (pk >= 0)
-		{
-			pk = pk + 2 * dy - 2 * dx;
-			y++;
-		}
-		else
-		{
-			pk = pk + 2 * dy;
-		}
+	size_t threadCount = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), count / transformPointsPerThread));
+	size_t perThread = (count + threadCount - 1) / threadCount;
 
+	std::vector<std::thread> workers;
+	for (size_t t = 1; t < threadCount; t++)
+	{
+		size_t start = t * perThread;
+		size_t n = std::min(perThread, count - start);
+		workers.push_back(std::thread(transformRange, std::cref(transform), kind, points + start, n));
+	}
+	transformRange(transform, kind, points, std::min(perThread, count));
+
+	for (size_t t = 0; t < workers.size(); t++)
+	{
+		workers[t].join();
 	}
-	return points;
 }
 
 /**
- * This function uses the DDA algorithm to draw a line between two points and returns a vector of
- * points along the line.
+ * The function applies a transformation to a vector of points in place.
  * 
- * @param x1 The x-coordinate of the starting point of the line.
- * @param y1 The y-coordinate of the starting point of the line.
- * @param x2 The x-coordinate of the end point of the line.
- * @param y2 The y-coordinate of the end point of the line to be drawn using the DDA algorithm.
+ * @param transform The transformation matrix.
+ * @param points The points to transform.
+ */
+void MathOGL::transformPoints(const glm::mat4& transform, std::vector<glm::vec3>& points)
+{
+	transformPoints(transform, points.data(), points.size());
+}
+
+/**
+ * The function finds the cheapest kind of transformation that gives the same result as m.
  * 
- * @return A vector of glm::vec3 points representing a line drawn using the DDA algorithm between the
- * points (x1, y1) and (x2, y2).
+ * @param m The transformation matrix.
+ * 
+ * @return the kind of transformation.
  */
-std::vector<glm::vec3> MathOGL::drawLineDDA(double x1, double y1, double x2, double y2)
+MathOGL::TransformKind MathOGL::classifyTransform(const glm::mat4& m)
 {
-	std::vector<glm::vec3> points;
-	float dy = 0;
-	float dx = 0;
-	int xi, yi;
-	float step = 0;
-	int i = 1;
+	bool affine = m[0][3] == 0.0f && m[1][3] == 0.0f && m[2][3] == 0.0f && m[3][3] == 1.0f;
+	if (!affine)
+		return transformProjective;
 
-	xi = x1;
-	yi = y1;
-	points.push_back(glm::vec3(xi, yi, 0));
+	// z is left untouched and doesn't feed x or y.
+	bool keepsZ = m[0][2] == 0.0f && m[1][2] == 0.0f && m[2][0] == 0.0f && m[2][1] == 0.0f && m[2][2] == 1.0f && m[3][2] == 0.0f;
+	if (!keepsZ)
+		return transformAffine;
 
-	while (xi < x2 || yi < x2) {
+	bool linearIdentity = m[0][0] == 1.0f && m[0][1] == 0.0f && m[1][0] == 0.0f && m[1][1] == 1.0f;
+	if (!linearIdentity)
+		return transformAffine2D;
 
-		dy = abs(y2 - yi);
-		dx = abs(x2 - xi);
+	return (m[3][0] == 0.0f && m[3][1] == 0.0f) ? transformIdentity : transformTranslation;
+}
 
-		if (dx > dy)
-		{
-			step = dx;
-			dx = dx / step;
-			xi = xi + dx;
-		}
-		else
-		{
-			step = dy;
-			dy = dy / step;
-			yi = yi + dy;
-		}
-			
-		points.push_back(glm::vec3(xi, yi, 0));
+/**
+ * The function applies a classified transformation to a range of points in place. Points are
+ * transposed to SoA in small chunks for the SIMD kernels, except for translations, which don't need it.
+ * 
+ * @param m The transformation matrix.
+ * @param kind The kind of m, as returned by classifyTransform.
+ * @param points The points to transform.
+ * @param count The number of points.
+ */
+void MathOGL::transformRange(const glm::mat4& m, TransformKind kind, glm::vec3* points, size_t count)
+{
+	if (kind == transformTranslation)
+	{
+		translateRange(glm::vec3(m[3][0], m[3][1], m[3][2]), points, count);
+		return;
+	}
 
-		i = i + 1;
+	float x[aosChunk], y[aosChunk], z[aosChunk];
+	for (size_t start = 0; start < count; start += aosChunk)
+	{
+		size_t n = std::min<size_t>(aosChunk, count - start);
+		toSoA(points + start, n, x, y, z);
+		transformSoA(m, kind, x, y, z, n);
+		fromSoA(x, y, z, n, points + start);
 	}
-	return points;
 }
 
 /**
- * The function draws a circle using the midpoint algorithm and returns a vector of points.
- * 
- * @param x_centre The x-coordinate of the center of the circle.
- * @param y_centre The y-coordinate of the center point of the circle.
- * @param r The radius of the circle to be drawn.
+ * The function adds the same offset to a range of points in place. The x, y, z pattern of the offset
+ * repeats every 3 registers, so the points are processed as flat floats without transposing them.
  * 
- * @return A vector of glm::vec3 points representing the perimeter of a circle with the given center
- * coordinates and radius.
+ * @param t The offset.
+ * @param points The points to translate.
+ * @param count The number of points.
  */
-std::vector<glm::vec3> MathOGL::midPointCircleDraw(double x_centre, double y_centre, double r)
+void MathOGL::translateRange(const glm::vec3& t, glm::vec3* points, size_t count)
 {
-	std::vector<glm::vec3> points;
-	int x = r, y = 0;
-
-	// Storing the initial point on the axes
-	// after translation
+	float pattern[3 * SimdFloat::width];
+	for (size_t i = 0; i < 3 * SimdFloat::width; i++)
+	{
+		pattern[i] = t[i % 3];
+	}
+	const SimdFloat::Register offset0 = SimdFloat::load(pattern);
+	const SimdFloat::Register offset1 = SimdFloat::load(pattern + SimdFloat::width);
+	const SimdFloat::Register offset2 = SimdFloat::load(pattern + 2 * SimdFloat::width);
 
-	// When radius is zero only a single
-	// point will be printed
-	if (r > 0)
+	float* values = &points[0].x;
+	size_t floatCount = count * 3;
+	size_t i = 0;
+	for (; i + 3 * SimdFloat::width <= floatCount; i += 3 * SimdFloat::width)
 	{
-		points.push_back(glm::vec3((r + x_centre), (y_centre), 0));
-		points.push_back(glm::vec3((x_centre), (r + y_centre), 0));
+		SimdFloat::store(values + i, SimdFloat::add(SimdFloat::load(values + i), offset0));
+		SimdFloat::store(values + i + SimdFloat::width, SimdFloat::add(SimdFloat::load(values + i + SimdFloat::width), offset1));
+		SimdFloat::store(values + i + 2 * SimdFloat::width, SimdFloat::add(SimdFloat::load(values + i + 2 * SimdFloat::width), offset2));
 	}
-	else
+	for (; i < floatCount; i++)
 	{
-		points.push_back(glm::vec3((x_centre), (y_centre), 0));
+		values[i] += t[i % 3];
 	}
+}
 
-	// Initialising the value of P
-	int P = 1 - r;
-	while (x > y)
+/**
+ * The function applies a classified transformation to points stored as one array per component.
+ * 
+ * @param m The transformation matrix.
+ * @param kind The kind of m, as returned by classifyTransform.
+ * @param x The x components, transformed in place.
+ * @param y The y components, transformed in place.
+ * @param z The z components, transformed in place.
+ * @param count The number of points.
+ */
+void MathOGL::transformSoA(const glm::mat4& m, TransformKind kind, float* x, float* y, float* z, size_t count)
+{
+	const SimdFloat::Register m00 = SimdFloat::set(m[0][0]), m01 = SimdFloat::set(m[0][1]), m02 = SimdFloat::set(m[0][2]), m03 = SimdFloat::set(m[0][3]);
+	const SimdFloat::Register m10 = SimdFloat::set(m[1][0]), m11 = SimdFloat::set(m[1][1]), m12 = SimdFloat::set(m[1][2]), m13 = SimdFloat::set(m[1][3]);
+	const SimdFloat::Register m20 = SimdFloat::set(m[2][0]), m21 = SimdFloat::set(m[2][1]), m22 = SimdFloat::set(m[2][2]), m23 = SimdFloat::set(m[2][3]);
+	const SimdFloat::Register m30 = SimdFloat::set(m[3][0]), m31 = SimdFloat::set(m[3][1]), m32 = SimdFloat::set(m[3][2]), m33 = SimdFloat::set(m[3][3]);
+
+	size_t i = 0;
+	for (; i + SimdFloat::width <= count; i += SimdFloat::width)
 	{
-		y++;
-		// Mid-point is inside or on the perimeter
-		if (P <= 0)
-			P = P + 2 * y + 1;
-		// Mid-point is outside the perimeter
-		else
+		SimdFloat::Register px = SimdFloat::load(x + i), py = SimdFloat::load(y + i);
+		SimdFloat::Register rx = SimdFloat::add(SimdFloat::add(SimdFloat::mul(m00, px), SimdFloat::mul(m10, py)), m30);
+		SimdFloat::Register ry = SimdFloat::add(SimdFloat::add(SimdFloat::mul(m01, px), SimdFloat::mul(m11, py)), m31);
+
+		if (kind == transformAffine2D)
 		{
-			x--;
-			P = P + 2 * y - 2 * x + 1;
+			SimdFloat::store(x + i, rx);
+			SimdFloat::store(y + i, ry);
+			continue;
 		}
 
-		// All the perimeter points have already been printed
-		if (x < y)
-			break;
+		SimdFloat::Register pz = SimdFloat::load(z + i);
+		rx = SimdFloat::add(rx, SimdFloat::mul(m20, pz));
+		ry = SimdFloat::add(ry, SimdFloat::mul(m21, pz));
+		SimdFloat::Register rz = SimdFloat::add(SimdFloat::add(SimdFloat::add(SimdFloat::mul(m02, px), SimdFloat::mul(m12, py)), SimdFloat::mul(m22, pz)), m32);
 
-		// Printing the generated point and its reflection
-		// in the other octants after translation
-		points.push_back(glm::vec3((x + x_centre), (y + y_centre), 0));
+		if (kind == transformProjective)
+		{
+			SimdFloat::Register w = SimdFloat::add(SimdFloat::add(SimdFloat::add(SimdFloat::mul(m03, px), SimdFloat::mul(m13, py)), SimdFloat::mul(m23, pz)), m33);
+			rx = SimdFloat::div(rx, w);
+			ry = SimdFloat::div(ry, w);
+			rz = SimdFloat::div(rz, w);
+		}
 
-		// If the generated point is on the line x = y then
-		// the perimeter points have already been printed
-		if (x != y) {
-			points.push_back(glm::vec3((y + x_centre), (x + y_centre), 0));
+		SimdFloat::store(x + i, rx);
+		SimdFloat::store(y + i, ry);
+		SimdFloat::store(z + i, rz);
+	}
+	for (; i < count; i++)
+	{
+		glm::vec4 p = m * glm::vec4(x[i], y[i], kind == transformAffine2D ? 0.0f : z[i], 1.0f);
+		float w = kind == transformProjective ? p.w : 1.0f;
+		x[i] = p.x / w;
+		y[i] = p.y / w;
+		if (kind != transformAffine2D)
+		{
+			z[i] = p.z / w;
 		}
 	}
-	return points;
 }
 
 /**
- * The function uses Bresenham's algorithm to generate a vector of points that form a circle with a
- * given center and radius.
+ * The function adds two point clouds vector by vector.
  * 
- * @param x_center The x-coordinate of the center of the circle.
- * @param y_center The y-coordinate of the center of the circle.
- * @param r The radius of the circle.
+ * @param vec1 The first vectors.
+ * @param vec2 The vectors added to vec1, at least as many as in vec1.
+ * @param out Receives vec1.count sums.
+ */
+void MathOGL::vecSum(const Vec3SoA& vec1, const Vec3SoA& vec2, Vec3SoA& out)
+{
+	addFloats(vec1.x, vec2.x, out.x, vec1.count);
+	addFloats(vec1.y, vec2.y, out.y, vec1.count);
+	addFloats(vec1.z, vec2.z, out.z, vec1.count);
+}
+
+/**
+ * The function subtracts two point clouds vector by vector.
  * 
- * @return A vector of glm::vec3 points representing the pixels of a circle drawn using the Bresenham's
- * algorithm, with the center at (x_center, y_center) and radius r.
+ * @param vec1 The vectors to subtract from.
+ * @param vec2 The vectors subtracted from vec1, at least as many as in vec1.
+ * @param out Receives vec1.count differences.
  */
-std::vector<glm::vec3> MathOGL::BresenhamCircle(double x_center, double y_center, double r)
+void MathOGL::vectorSubtraction(const Vec3SoA& vec1, const Vec3SoA& vec2, Vec3SoA& out)
 {
-	std::vector<glm::vec3> points;
-	int x = 0;
-	int y = r;
-	int d = 3 - 2 * y;
+	subtractFloats(vec1.x, vec2.x, out.x, vec1.count);
+	subtractFloats(vec1.y, vec2.y, out.y, vec1.count);
+	subtractFloats(vec1.z, vec2.z, out.z, vec1.count);
+}
 
-    while (y >= x)
-    {
-		BresenhamCirclePoints(x_center, y_center, x, y, points);
-        x++;
-        if (d > 0)
-        {
-            y--;
-            d = d + 4 * (x - y) + 10;
-        }
-        else
-            d = d + 4 * x + 6;
-    }
+/**
+ * The function multiplies every vector of a point cloud by the same scalar.
+ * 
+ * @param vec1 The vectors to scale.
+ * @param escalar The scalar value, applied in float precision.
+ * @param out Receives vec1.count scaled vectors.
+ */
+void MathOGL::scalarMultiplication(const Vec3SoA& vec1, double escalar, Vec3SoA& out)
+{
+	scaleFloats(vec1.x, (float)escalar, out.x, vec1.count);
+	scaleFloats(vec1.y, (float)escalar, out.y, vec1.count);
+	scaleFloats(vec1.z, (float)escalar, out.z, vec1.count);
+}
 
-	// Order the vector so that duplicated elements remain together
-	//std::sort(points.begin(), points.end());
-	std::sort(points.begin(), points.end(), &MathOGL::compareVecByElems);
+/**
+ * The function calculates the cross product of two point clouds vector by vector.
+ * 
+ * @param vec1 The first vectors of the products.
+ * @param vec2 The second vectors of the products, at least as many as in vec1.
+ * @param out Receives vec1.count cross products.
+ */
+void MathOGL::crossProduct(const Vec3SoA& vec1, const Vec3SoA& vec2, Vec3SoA& out)
+{
+	size_t i = 0;
+	for (; i + SimdFloat::width <= vec1.count; i += SimdFloat::width)
+	{
+		SimdFloat::Register ax = SimdFloat::load(vec1.x + i), ay = SimdFloat::load(vec1.y + i), az = SimdFloat::load(vec1.z + i);
+		SimdFloat::Register bx = SimdFloat::load(vec2.x + i), by = SimdFloat::load(vec2.y + i), bz = SimdFloat::load(vec2.z + i);
+		SimdFloat::store(out.x + i, SimdFloat::sub(SimdFloat::mul(ay, bz), SimdFloat::mul(az, by)));
+		SimdFloat::store(out.y + i, SimdFloat::sub(SimdFloat::mul(az, bx), SimdFloat::mul(ax, bz)));
+		SimdFloat::store(out.z + i, SimdFloat::sub(SimdFloat::mul(ax, by), SimdFloat::mul(ay, bx)));
+	}
+	for (; i < vec1.count; i++)
+	{
+		float ax = vec1.x[i], ay = vec1.y[i], az = vec1.z[i];
+		float bx = vec2.x[i], by = vec2.y[i], bz = vec2.z[i];
+		out.x[i] = ay * bz - az * by;
+		out.y[i] = az * bx - ax * bz;
+		out.z[i] = ax * by - ay * bx;
+	}
+}
 
-	// Remove duplicated elements
-	auto it = std::unique(points.begin(), points.end());
-	points.erase(it, points.end());
+/**
+ * The function calculates the dot product of two point clouds vector by vector.
+ * 
+ * @param vec1 The first vectors of the products.
+ * @param vec2 The second vectors of the products, at least as many as in vec1.
+ * @param out Receives vec1.count dot products.
+ */
+void MathOGL::dotProduct(const Vec3SoA& vec1, const Vec3SoA& vec2, float* out)
+{
+	size_t i = 0;
+	for (; i + SimdFloat::width <= vec1.count; i += SimdFloat::width)
+	{
+		SimdFloat::Register dot = SimdFloat::mul(SimdFloat::load(vec1.x + i), SimdFloat::load(vec2.x + i));
+		dot = SimdFloat::add(dot, SimdFloat::mul(SimdFloat::load(vec1.y + i), SimdFloat::load(vec2.y + i)));
+		dot = SimdFloat::add(dot, SimdFloat::mul(SimdFloat::load(vec1.z + i), SimdFloat::load(vec2.z + i)));
+		SimdFloat::store(out + i, dot);
+	}
+	for (; i < vec1.count; i++)
+	{
+		out[i] = vec1.x[i] * vec2.x[i] + vec1.y[i] * vec2.y[i] + vec1.z[i] * vec2.z[i];
+	}
+}
 
-	return points;
+/**
+ * The function normalizes every vector of a point cloud. As with normalize, null vectors turn into NaN.
+ * 
+ * @param vec1 The vectors to normalize.
+ * @param out Receives vec1.count unit vectors.
+ */
+void MathOGL::normalize(const Vec3SoA& vec1, Vec3SoA& out)
+{
+	size_t i = 0;
+	for (; i + SimdFloat::width <= vec1.count; i += SimdFloat::width)
+	{
+		SimdFloat::Register x = SimdFloat::load(vec1.x + i), y = SimdFloat::load(vec1.y + i), z = SimdFloat::load(vec1.z + i);
+		SimdFloat::Register length = SimdFloat::sqrt(SimdFloat::add(SimdFloat::add(SimdFloat::mul(x, x), SimdFloat::mul(y, y)), SimdFloat::mul(z, z)));
+		SimdFloat::store(out.x + i, SimdFloat::div(x, length));
+		SimdFloat::store(out.y + i, SimdFloat::div(y, length));
+		SimdFloat::store(out.z + i, SimdFloat::div(z, length));
+	}
+	for (; i < vec1.count; i++)
+	{
+		float x = vec1.x[i], y = vec1.y[i], z = vec1.z[i];
+		float length = sqrtf(x * x + y * y + z * z);
+		out.x[i] = x / length;
+		out.y[i] = y / length;
+		out.z[i] = z / length;
+	}
+}
+
+/**
+ * The function calculates the angle between two point clouds vector by vector. The cosines are
+ * computed with SIMD and clamped to [-1, 1], so float rounding never makes acos return NaN for
+ * parallel vectors; acos itself runs per element.
+ * 
+ * @param vec1 The first vectors.
+ * @param vec2 The second vectors, at least as many as in vec1.
+ * @param out Receives vec1.count angles in radians.
+ */
+void MathOGL::angleBetween(const Vec3SoA& vec1, const Vec3SoA& vec2, float* out)
+{
+	size_t i = 0;
+	const SimdFloat::Register one = SimdFloat::set(1.0f);
+	const SimdFloat::Register minusOne = SimdFloat::set(-1.0f);
+	for (; i + SimdFloat::width <= vec1.count; i += SimdFloat::width)
+	{
+		SimdFloat::Register ax = SimdFloat::load(vec1.x + i), ay = SimdFloat::load(vec1.y + i), az = SimdFloat::load(vec1.z + i);
+		SimdFloat::Register bx = SimdFloat::load(vec2.x + i), by = SimdFloat::load(vec2.y + i), bz = SimdFloat::load(vec2.z + i);
+		SimdFloat::Register dot = SimdFloat::add(SimdFloat::add(SimdFloat::mul(ax, bx), SimdFloat::mul(ay, by)), SimdFloat::mul(az, bz));
+		SimdFloat::Register len1 = SimdFloat::add(SimdFloat::add(SimdFloat::mul(ax, ax), SimdFloat::mul(ay, ay)), SimdFloat::mul(az, az));
+		SimdFloat::Register len2 = SimdFloat::add(SimdFloat::add(SimdFloat::mul(bx, bx), SimdFloat::mul(by, by)), SimdFloat::mul(bz, bz));
+		SimdFloat::Register cosTheta = SimdFloat::div(dot, SimdFloat::sqrt(SimdFloat::mul(len1, len2)));
+		SimdFloat::store(out + i, SimdFloat::max(minusOne, SimdFloat::min(one, cosTheta)));
+	}
+	for (; i < vec1.count; i++)
+	{
+		float dot = vec1.x[i] * vec2.x[i] + vec1.y[i] * vec2.y[i] + vec1.z[i] * vec2.z[i];
+		float len1 = vec1.x[i] * vec1.x[i] + vec1.y[i] * vec1.y[i] + vec1.z[i] * vec1.z[i];
+		float len2 = vec2.x[i] * vec2.x[i] + vec2.y[i] * vec2.y[i] + vec2.z[i] * vec2.z[i];
+		float cosTheta = dot / sqrtf(len1 * len2);
+		out[i] = cosTheta > 1.0f ? 1.0f : (cosTheta < -1.0f ? -1.0f : cosTheta);
+	}
+	for (i = 0; i < vec1.count; i++)
+	{
+		out[i] = acosf(out[i]);
+	}
+}
+
+/**
+ * The function adds two arrays of glm::vec3 vector by vector.
+ * 
+ * @param vec1 The first vectors.
+ * @param vec2 The vectors added to vec1.
+ * @param out Receives count sums.
+ * @param count The number of vectors.
+ */
+void MathOGL::vecSum(const glm::vec3* vec1, const glm::vec3* vec2, glm::vec3* out, size_t count)
+{
+	// Component-wise operations don't care about the layout, the arrays are plain floats.
+	addFloats(&vec1[0].x, &vec2[0].x, &out[0].x, count * 3);
+}
+
+/**
+ * The function subtracts two arrays of glm::vec3 vector by vector.
+ * 
+ * @param vec1 The vectors to subtract from.
+ * @param vec2 The vectors subtracted from vec1.
+ * @param out Receives count differences.
+ * @param count The number of vectors.
+ */
+void MathOGL::vectorSubtraction(const glm::vec3* vec1, const glm::vec3* vec2, glm::vec3* out, size_t count)
+{
+	subtractFloats(&vec1[0].x, &vec2[0].x, &out[0].x, count * 3);
+}
+
+/**
+ * The function multiplies every vector of an array of glm::vec3 by the same scalar.
+ * 
+ * @param vec1 The vectors to scale.
+ * @param escalar The scalar value, applied in float precision.
+ * @param out Receives count scaled vectors.
+ * @param count The number of vectors.
+ */
+void MathOGL::scalarMultiplication(const glm::vec3* vec1, double escalar, glm::vec3* out, size_t count)
+{
+	scaleFloats(&vec1[0].x, (float)escalar, &out[0].x, count * 3);
+}
+
+/**
+ * The function calculates the cross product of two arrays of glm::vec3 vector by vector. The vectors
+ * are transposed to SoA in small chunks that stay in the L1 cache and sent through the SoA version.
+ * 
+ * @param vec1 The first vectors of the products.
+ * @param vec2 The second vectors of the products.
+ * @param out Receives count cross products.
+ * @param count The number of vectors.
+ */
+void MathOGL::crossProduct(const glm::vec3* vec1, const glm::vec3* vec2, glm::vec3* out, size_t count)
+{
+	float a[3][aosChunk], b[3][aosChunk];
+	for (size_t start = 0; start < count; start += aosChunk)
+	{
+		size_t n = std::min<size_t>(aosChunk, count - start);
+		toSoA(vec1 + start, n, a[0], a[1], a[2]);
+		toSoA(vec2 + start, n, b[0], b[1], b[2]);
+		Vec3SoA soa1 = { a[0], a[1], a[2], n };
+		Vec3SoA soa2 = { b[0], b[1], b[2], n };
+		crossProduct(soa1, soa2, soa1);
+		fromSoA(a[0], a[1], a[2], n, out + start);
+	}
+}
+
+/**
+ * The function calculates the dot product of two arrays of glm::vec3 vector by vector.
+ * 
+ * @param vec1 The first vectors of the products.
+ * @param vec2 The second vectors of the products.
+ * @param out Receives count dot products.
+ * @param count The number of vectors.
+ */
+void MathOGL::dotProduct(const glm::vec3* vec1, const glm::vec3* vec2, float* out, size_t count)
+{
+	float a[3][aosChunk], b[3][aosChunk];
+	for (size_t start = 0; start < count; start += aosChunk)
+	{
+		size_t n = std::min<size_t>(aosChunk, count - start);
+		toSoA(vec1 + start, n, a[0], a[1], a[2]);
+		toSoA(vec2 + start, n, b[0], b[1], b[2]);
+		Vec3SoA soa1 = { a[0], a[1], a[2], n };
+		Vec3SoA soa2 = { b[0], b[1], b[2], n };
+		dotProduct(soa1, soa2, out + start);
+	}
+}
+
+/**
+ * The function normalizes every vector of an array of glm::vec3.
+ * 
+ * @param vec1 The vectors to normalize.
+ * @param out Receives count unit vectors.
+ * @param count The number of vectors.
+ */
+void MathOGL::normalize(const glm::vec3* vec1, glm::vec3* out, size_t count)
+{
+	float a[3][aosChunk];
+	for (size_t start = 0; start < count; start += aosChunk)
+	{
+		size_t n = std::min<size_t>(aosChunk, count - start);
+		toSoA(vec1 + start, n, a[0], a[1], a[2]);
+		Vec3SoA soa = { a[0], a[1], a[2], n };
+		normalize(soa, soa);
+		fromSoA(a[0], a[1], a[2], n, out + start);
+	}
+}
+
+/**
+ * The function calculates the angle between two arrays of glm::vec3 vector by vector.
+ * 
+ * @param vec1 The first vectors.
+ * @param vec2 The second vectors.
+ * @param out Receives count angles in radians.
+ * @param count The number of vectors.
+ */
+void MathOGL::angleBetween(const glm::vec3* vec1, const glm::vec3* vec2, float* out, size_t count)
+{
+	float a[3][aosChunk], b[3][aosChunk];
+	for (size_t start = 0; start < count; start += aosChunk)
+	{
+		size_t n = std::min<size_t>(aosChunk, count - start);
+		toSoA(vec1 + start, n, a[0], a[1], a[2]);
+		toSoA(vec2 + start, n, b[0], b[1], b[2]);
+		Vec3SoA soa1 = { a[0], a[1], a[2], n };
+		Vec3SoA soa2 = { b[0], b[1], b[2], n };
+		angleBetween(soa1, soa2, out + start);
+	}
+}
+
+/**
+ * The function splits an array of glm::vec3 into one array per component.
+ * 
+ * @param vectors The vectors to split.
+ * @param count The number of vectors.
+ * @param x Receives the x components.
+ * @param y Receives the y components.
+ * @param z Receives the z components.
+ */
+void MathOGL::toSoA(const glm::vec3* vectors, size_t count, float* x, float* y, float* z)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		x[i] = vectors[i].x;
+		y[i] = vectors[i].y;
+		z[i] = vectors[i].z;
+	}
+}
+
+/**
+ * The function joins one array per component back into an array of glm::vec3.
+ * 
+ * @param x The x components.
+ * @param y The y components.
+ * @param z The z components.
+ * @param count The number of vectors.
+ * @param vectors Receives the vectors.
+ */
+void MathOGL::fromSoA(const float* x, const float* y, const float* z, size_t count, glm::vec3* vectors)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		vectors[i] = glm::vec3(x[i], y[i], z[i]);
+	}
+}
+
+/**
+ * The function adds two float arrays element by element.
+ * 
+ * @param a The first array.
+ * @param b The second array.
+ * @param out Receives the sums, may be a or b.
+ * @param count The number of elements.
+ */
+void MathOGL::addFloats(const float* a, const float* b, float* out, size_t count)
+{
+	size_t i = 0;
+	for (; i + SimdFloat::width <= count; i += SimdFloat::width)
+	{
+		SimdFloat::store(out + i, SimdFloat::add(SimdFloat::load(a + i), SimdFloat::load(b + i)));
+	}
+	for (; i < count; i++)
+	{
+		out[i] = a[i] + b[i];
+	}
+}
+
+/**
+ * The function subtracts two float arrays element by element.
+ * 
+ * @param a The array to subtract from.
+ * @param b The array subtracted from a.
+ * @param out Receives the differences, may be a or b.
+ * @param count The number of elements.
+ */
+void MathOGL::subtractFloats(const float* a, const float* b, float* out, size_t count)
+{
+	size_t i = 0;
+	for (; i + SimdFloat::width <= count; i += SimdFloat::width)
+	{
+		SimdFloat::store(out + i, SimdFloat::sub(SimdFloat::load(a + i), SimdFloat::load(b + i)));
+	}
+	for (; i < count; i++)
+	{
+		out[i] = a[i] - b[i];
+	}
+}
+
+/**
+ * The function multiplies every element of a float array by the same value.
+ * 
+ * @param a The array to scale.
+ * @param scale The factor.
+ * @param out Receives the products, may be a.
+ * @param count The number of elements.
+ */
+void MathOGL::scaleFloats(const float* a, float scale, float* out, size_t count)
+{
+	size_t i = 0;
+	const SimdFloat::Register factor = SimdFloat::set(scale);
+	for (; i + SimdFloat::width <= count; i += SimdFloat::width)
+	{
+		SimdFloat::store(out + i, SimdFloat::mul(SimdFloat::load(a + i), factor));
+	}
+	for (; i < count; i++)
+	{
+		out[i] = a[i] * scale;
+	}
+}
+
+/**
+ * This function draws a basic line using the Basic's algorithm and returns a vector of points.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line.
+ * 
+ * @return A vector of glm::vec3 points representing a basic line drawn between two given points (x1,
+ * y1) and (x2, y2).
+ */
+std::vector<glm::vec3> MathOGL::drawLineBasic(double x1, double y1, double x2, double y2) 
+{
+	std::vector<glm::vec3> points;
+	points.reserve(countLineBasic(x1, y1, x2, y2));
+	double dx = abs(x2 - x1);
+	double dy = abs(y2 - y1);
+	double m = dy / dx;
+	double xi, yi;
+	int i = x1;
+	yi = y1;
+	points.push_back(glm::vec3(i, yi, 0));
+	while (i < x2) {
+		i = i + 1;
+		xi = i;
+		yi = roundf(yi + m);
+		points.push_back(glm::vec3(xi, yi, 0));
+	}
+	return points;
+}
+
+/**
+ * This function uses Bresenham's line algorithm to draw a line between two points and returns a vector
+ * of points along the line.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line.
+ * 
+ * @return A vector of glm::vec3 points representing a line drawn using Bresenham's line algorithm
+ * between the points (x1, y1) and (x2, y2).
+ */
+std::vector<glm::vec3> MathOGL::drawLineBres(double x1, double y1, double x2, double y2)
+{
+	std::vector<glm::vec3> points;
+	points.reserve(countLineBres(x1, y1, x2, y2));
+	double dx = x2 - x1;
+	double dy = y2 - y1;
+	double pk = 2 * dy - dx;
+
+	for (int x = x1, y = y1; x <= x2; x++) {
+
+		points.push_back(glm::vec3(x, y, 0));
+
+		dx = x2 - x;
+		dy = y2 - y;
+
+		if (pk >= 0)
+		{
+			pk = pk + 2 * dy - 2 * dx;
+			y++;
+		}
+		else
+		{
+			pk = pk + 2 * dy;
+		}
+
+	}
+	return points;
+}
+
+/**
+ * This function uses the DDA algorithm to draw a line between two points and returns a vector of
+ * points along the line.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line to be drawn using the DDA algorithm.
+ * 
+ * @return A vector of glm::vec3 points representing a line drawn using the DDA algorithm between the
+ * points (x1, y1) and (x2, y2).
+ */
+std::vector<glm::vec3> MathOGL::drawLineDDA(double x1, double y1, double x2, double y2)
+{
+	std::vector<glm::vec3> points;
+	size_t expected = countLineDDA(x1, y1, x2, y2);
+	if (expected != rasterUnbounded)
+	{
+		points.reserve(expected);
+	}
+	float dy = 0;
+	float dx = 0;
+	int xi, yi;
+	float step = 0;
+	int i = 1;
+
+	xi = x1;
+	yi = y1;
+	points.push_back(glm::vec3(xi, yi, 0));
+
+	while (xi < x2 || yi < x2) {
+
+		dy = abs(y2 - yi);
+		dx = abs(x2 - xi);
+
+		if (dx > dy)
+		{
+			step = dx;
+			dx = dx / step;
+			xi = xi + dx;
+		}
+		else
+		{
+			step = dy;
+			dy = dy / step;
+			yi = yi + dy;
+		}
+			
+		points.push_back(glm::vec3(xi, yi, 0));
+
+		i = i + 1;
+	}
+	return points;
+}
+
+/**
+ * The function draws a circle using the midpoint algorithm and returns a vector of points.
+ * 
+ * @param x_centre The x-coordinate of the center of the circle.
+ * @param y_centre The y-coordinate of the center point of the circle.
+ * @param r The radius of the circle to be drawn.
+ * 
+ * @return A vector of glm::vec3 points representing the perimeter of a circle with the given center
+ * coordinates and radius.
+ */
+std::vector<glm::vec3> MathOGL::midPointCircleDraw(double x_centre, double y_centre, double r)
+{
+	std::vector<glm::vec3> points;
+	points.reserve(countMidPointCircle(x_centre, y_centre, r));
+	int x = r, y = 0;
+
+	// Storing the initial point on the axes
+	// after translation
+
+	// When radius is zero only a single
+	// point will be printed
+	if (r > 0)
+	{
+		points.push_back(glm::vec3((r + x_centre), (y_centre), 0));
+		points.push_back(glm::vec3((x_centre), (r + y_centre), 0));
+	}
+	else
+	{
+		points.push_back(glm::vec3((x_centre), (y_centre), 0));
+	}
+
+	// Initialising the value of P
+	int P = 1 - r;
+	while (x > y)
+	{
+		y++;
+		// Mid-point is inside or on the perimeter
+		if (P <= 0)
+			P = P + 2 * y + 1;
+		// Mid-point is outside the perimeter
+		else
+		{
+			x--;
+			P = P + 2 * y - 2 * x + 1;
+		}
+
+		// All the perimeter points have already been printed
+		if (x < y)
+			break;
+
+		// Printing the generated point and its reflection
+		// in the other octants after translation
+		points.push_back(glm::vec3((x + x_centre), (y + y_centre), 0));
+
+		// If the generated point is on the line x = y then
+		// the perimeter points have already been printed
+		if (x != y) {
+			points.push_back(glm::vec3((y + x_centre), (x + y_centre), 0));
+		}
+	}
+	return points;
+}
+
+/**
+ * The function uses Bresenham's algorithm to generate a vector of points that form a circle with a
+ * given center and radius.
+ * 
+ * @param x_center The x-coordinate of the center of the circle.
+ * @param y_center The y-coordinate of the center of the circle.
+ * @param r The radius of the circle.
+ * 
+ * @return A vector of glm::vec3 points representing the pixels of a circle drawn using the Bresenham's
+ * algorithm, with the center at (x_center, y_center) and radius r.
+ */
+std::vector<glm::vec3> MathOGL::BresenhamCircle(double x_center, double y_center, double r)
+{
+	std::vector<glm::vec3> points;
+	points.reserve(countBresenhamCircleSteps(r));
+	int x = 0;
+	int y = r;
+	int d = 3 - 2 * y;
+
+    while (y >= x)
+    {
+		BresenhamCirclePoints(x_center, y_center, x, y, points);
+        x++;
+        if (d > 0)
+        {
+            y--;
+            d = d + 4 * (x - y) + 10;
+        }
+        else
+            d = d + 4 * x + 6;
+    }
+
+	// Order the vector so that duplicated elements remain together
+	//std::sort(points.begin(), points.end());
+	std::sort(points.begin(), points.end(), &MathOGL::compareVecByElems);
+
+	// Remove duplicated elements
+	auto it = std::unique(points.begin(), points.end());
+	points.erase(it, points.end());
+
+	return points;
+}
+
+/**
+ * This function draws a line in any of the eight octants with Bresenham's algorithm. The octant is
+ * resolved once and the line is handed to a LineOctant kernel specialized for it, so the per-pixel
+ * loop has no direction branches.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line.
+ * 
+ * @return A vector of glm::vec3 points going from (x1, y1) to (x2, y2), both included.
+ */
+std::vector<glm::vec3> MathOGL::drawLineOctant(double x1, double y1, double x2, double y2)
+{
+	typedef void (*OctantKernel)(int, int, int, int, glm::vec3*);
+	// Indexed by (x-major ? 4 : 0) + (x decreasing ? 2 : 0) + (y decreasing ? 1 : 0).
+	static const OctantKernel kernels[8] = {
+		&LineOctant<1, 1, false>::rasterize,
+		&LineOctant<1, -1, false>::rasterize,
+		&LineOctant<-1, 1, false>::rasterize,
+		&LineOctant<-1, -1, false>::rasterize,
+		&LineOctant<1, 1, true>::rasterize,
+		&LineOctant<1, -1, true>::rasterize,
+		&LineOctant<-1, 1, true>::rasterize,
+		&LineOctant<-1, -1, true>::rasterize,
+	};
+
+	int xStart = x1, yStart = y1;
+	int dx = (int)x2 - xStart;
+	int dy = (int)y2 - yStart;
+	int adx = abs(dx);
+	int ady = abs(dy);
+	bool xMajor = adx > ady;
+
+	std::vector<glm::vec3> points(countLineOctant(x1, y1, x2, y2));
+	int octant = (xMajor ? 4 : 0) + (dx < 0 ? 2 : 0) + (dy < 0 ? 1 : 0);
+	if (xMajor)
+		kernels[octant](xStart, yStart, adx, ady, points.data());
+	else
+		kernels[octant](xStart, yStart, ady, adx, points.data());
+
+	return points;
+}
+
+/**
+ * This function walks the midpoint circle algorithm of midPointCircleDraw over the octant going from
+ * (r, 0) to the diagonal. The 8 reflections of these offsets around the centre, swapping x and y and
+ * changing their signs, are the pixels of the whole circle.
+ * 
+ * @param r The radius of the circle.
+ * 
+ * @return the offsets of the octant pixels from the centre, in drawing order.
+ */
+std::vector<glm::vec3> MathOGL::midPointCircleOctant(double r)
+{
+	std::vector<glm::vec3> points;
+	int x = r, y = 0;
+
+	if (r > 0)
+		points.push_back(glm::vec3(r, 0, 0));
+	else
+		points.push_back(glm::vec3(0, 0, 0));
+
+	int P = 1 - r;
+	while (x > y)
+	{
+		y++;
+		if (P <= 0)
+			P = P + 2 * y + 1;
+		else
+		{
+			x--;
+			P = P + 2 * y - 2 * x + 1;
+		}
+
+		if (x < y)
+			break;
+
+		points.push_back(glm::vec3(x, y, 0));
+	}
+	return points;
+}
+
+/**
+ * This function walks Bresenham's circle algorithm of BresenhamCircle over the octant going from
+ * (0, r) to the diagonal. The 8 reflections of these offsets around the centre are the pixels of the
+ * whole circle.
+ * 
+ * @param r The radius of the circle.
+ * 
+ * @return the offsets of the octant pixels from the centre, in drawing order.
+ */
+std::vector<glm::vec3> MathOGL::BresenhamCircleOctant(double r)
+{
+	std::vector<glm::vec3> points;
+	// One point per step, the whole circle takes eight.
+	points.reserve(countBresenhamCircleSteps(r) / 8);
+	int x = 0;
+	int y = r;
+	int d = 3 - 2 * y;
+
+	while (y >= x)
+	{
+		points.push_back(glm::vec3(x, y, 0));
+		x++;
+		if (d > 0)
+		{
+			y--;
+			d = d + 4 * (x - y) + 10;
+		}
+		else
+			d = d + 4 * x + 6;
+	}
+	return points;
+}
+
+/**
+ * This function returns the chain code of the line drawn by drawLineOctant.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line.
+ * 
+ * @return the chain code going from (x1, y1) to (x2, y2).
+ */
+ChainCode MathOGL::chainLineOctant(double x1, double y1, double x2, double y2)
+{
+	ChainCode chain;
+	chainSpan(lineSpan(x1, y1, x2, y2), chain);
+	return chain;
+}
+
+/**
+ * This function returns the chain code of the line drawn by drawLineClipped, the part of the line
+ * inside a rectangle.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line.
+ * @param rect The visible rectangle.
+ * 
+ * @return the chain code of the visible pixels, empty if there are none.
+ */
+ChainCode MathOGL::chainLineClipped(double x1, double y1, double x2, double y2, const ClipRect& rect)
+{
+	ChainCode chain;
+	LineSpan span;
+	if (clipLineSpan(x1, y1, x2, y2, rect, span))
+	{
+		chainSpan(span, chain);
+	}
+	return chain;
+}
+
+/**
+ * This function returns the chain code of the octant walked by BresenhamCircleOctant. Every step goes
+ * east or south-east.
+ * 
+ * @param r The radius of the circle.
+ * 
+ * @return the chain code of the octant offsets from the centre, starting at (0, r).
+ */
+ChainCode MathOGL::chainBresenhamCircleOctant(double r)
+{
+	int x = 0;
+	int y = r;
+	int d = 3 - 2 * y;
+	ChainCode chain(x, y);
+
+	while (true)
+	{
+		x++;
+		int down = 0;
+		if (d > 0)
+		{
+			y--;
+			down = 1;
+			d = d + 4 * (x - y) + 10;
+		}
+		else
+			d = d + 4 * x + 6;
+
+		if (y < x)
+			break;
+		// 0 = east, 7 = south-east.
+		chain.push(down ? 7 : 0);
+	}
+	return chain;
+}
+
+/**
+ * This function clips a line segment to a rectangle with the Liang-Barsky algorithm, which intersects
+ * the parametric form of the line with the four borders in one pass.
+ * 
+ * @param x1 The x-coordinate of the starting point, moved to the clipped starting point.
+ * @param y1 The y-coordinate of the starting point, moved to the clipped starting point.
+ * @param x2 The x-coordinate of the end point, moved to the clipped end point.
+ * @param y2 The y-coordinate of the end point, moved to the clipped end point.
+ * @param rect The visible rectangle.
+ * 
+ * @return false if no part of the segment is inside the rectangle, the points are left untouched then.
+ */
+bool MathOGL::clipLineLiangBarsky(double& x1, double& y1, double& x2, double& y2, const ClipRect& rect)
+{
+	double t0, t1;
+	if (!liangBarskyRange(x1, y1, x2, y2, rect, t0, t1))
+		return false;
+
+	double dx = x2 - x1;
+	double dy = y2 - y1;
+	x2 = x1 + t1 * dx;
+	y2 = y1 + t1 * dy;
+	x1 = x1 + t0 * dx;
+	y1 = y1 + t0 * dy;
+	return true;
+}
+
+/**
+ * This function clips a line segment to a rectangle with the Cohen-Sutherland algorithm, which uses
+ * region codes to accept or reject segments at once and moves one outside end point to a border at a
+ * time otherwise.
+ * 
+ * @param x1 The x-coordinate of the starting point, moved to the clipped starting point.
+ * @param y1 The y-coordinate of the starting point, moved to the clipped starting point.
+ * @param x2 The x-coordinate of the end point, moved to the clipped end point.
+ * @param y2 The y-coordinate of the end point, moved to the clipped end point.
+ * @param rect The visible rectangle.
+ * 
+ * @return false if no part of the segment is inside the rectangle.
+ */
+bool MathOGL::clipLineCohenSutherland(double& x1, double& y1, double& x2, double& y2, const ClipRect& rect)
+{
+	enum { left = 1, right = 2, bottom = 4, top = 8 };
+	int code1 = outCode(x1, y1, rect);
+	int code2 = outCode(x2, y2, rect);
+
+	while (true)
+	{
+		if ((code1 | code2) == 0)
+			return true;
+		if ((code1 & code2) != 0)
+			return false;
+
+		// Move the end point that is outside to the border it crosses.
+		int code = code1 != 0 ? code1 : code2;
+		double x, y;
+		if (code & top)
+		{
+			x = x1 + (x2 - x1) * (rect.yMax - y1) / (y2 - y1);
+			y = rect.yMax;
+		}
+		else if (code & bottom)
+		{
+			x = x1 + (x2 - x1) * (rect.yMin - y1) / (y2 - y1);
+			y = rect.yMin;
+		}
+		else if (code & right)
+		{
+			y = y1 + (y2 - y1) * (rect.xMax - x1) / (x2 - x1);
+			x = rect.xMax;
+		}
+		else
+		{
+			y = y1 + (y2 - y1) * (rect.xMin - x1) / (x2 - x1);
+			x = rect.xMin;
+		}
+
+		if (code == code1)
+		{
+			x1 = x;
+			y1 = y;
+			code1 = outCode(x1, y1, rect);
+		}
+		else
+		{
+			x2 = x;
+			y2 = y;
+			code2 = outCode(x2, y2, rect);
+		}
+	}
+}
+
+/**
+ * This function draws the part of a line inside a rectangle, giving exactly the pixels of
+ * drawLineOctant that fall inside it. The first and last visible steps are found without walking the
+ * hidden part of the line, and the walk starts with the error term Bresenham has at the first one, so
+ * the time spent depends on the visible pixels only.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line.
+ * @param rect The visible rectangle.
+ * 
+ * @return A vector of glm::vec3 points with the visible pixels, in the order of the line.
+ */
+std::vector<glm::vec3> MathOGL::drawLineClipped(double x1, double y1, double x2, double y2, const ClipRect& rect)
+{
+	std::vector<glm::vec3> points;
+	drawLineClipped(x1, y1, x2, y2, rect, points);
+	return points;
+}
+
+/**
+ * This function draws the part of a line inside a rectangle into a caller-owned vector, so callers
+ * clipping many lines can reuse its storage.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line.
+ * @param rect The visible rectangle.
+ * @param points Receives the visible pixels, in the order of the line. Its previous content is lost.
+ */
+void MathOGL::drawLineClipped(double x1, double y1, double x2, double y2, const ClipRect& rect, std::vector<glm::vec3>& points)
+{
+	typedef void (*OctantKernel)(int, int, int, int, int, int, glm::vec3*);
+	// Indexed by (x-major ? 4 : 0) + (x decreasing ? 2 : 0) + (y decreasing ? 1 : 0).
+	static const OctantKernel kernels[8] = {
+		&LineOctant<1, 1, false>::rasterizeSpan,
+		&LineOctant<1, -1, false>::rasterizeSpan,
+		&LineOctant<-1, 1, false>::rasterizeSpan,
+		&LineOctant<-1, -1, false>::rasterizeSpan,
+		&LineOctant<1, 1, true>::rasterizeSpan,
+		&LineOctant<1, -1, true>::rasterizeSpan,
+		&LineOctant<-1, 1, true>::rasterizeSpan,
+		&LineOctant<-1, -1, true>::rasterizeSpan,
+	};
+
+	points.clear();
+
+	LineSpan span;
+	if (!clipLineSpan(x1, y1, x2, y2, rect, span))
+		return;
+
+	points.resize(span.count);
+	int octant = (span.xMajor ? 4 : 0) + (span.stepX < 0 ? 2 : 0) + (span.stepY < 0 ? 1 : 0);
+	kernels[octant](span.x, span.y, span.err, span.count, span.dMajor, span.dMinor, points.data());
+}
+
+/**
+ * This function rasterizes a line of the given width as one span of pixels per row.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line.
+ * @param width The width of the line in pixels.
+ * 
+ * @return A vector with the spans of the line, from the lowest row up.
+ */
+std::vector<PixelSpan> MathOGL::thickLineSpans(double x1, double y1, double x2, double y2, double width)
+{
+	std::vector<PixelSpan> spans;
+	thickLineSpans(x1, y1, x2, y2, width, spans);
+	return spans;
+}
+
+/**
+ * This function rasterizes a line of the given width into a caller-owned vector. The line is the
+ * rectangle around the segment, extended by half a pixel past both end points so a line of width 1
+ * along an axis covers the same pixels as Bresenham. Each row, sampled at the pixel centres, crosses
+ * the rectangle in one interval, and the pixels whose centres fall in it make the span of that row,
+ * so the cost follows the number of rows instead of the number of pixels.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line.
+ * @param width The width of the line in pixels, at least 1.
+ * @param spans Receives the spans of the line, from the lowest row up. Its previous content is lost.
+ */
+void MathOGL::thickLineSpans(double x1, double y1, double x2, double y2, double width, std::vector<PixelSpan>& spans)
+{
+	spans.clear();
+
+	double dx = x2 - x1, dy = y2 - y1;
+	double length = sqrt(dx * dx + dy * dy);
+	// Unit direction of the line, along x for a single point.
+	double ux = length > 1e-12 ? dx / length : 1.0;
+	double uy = length > 1e-12 ? dy / length : 0.0;
+	double half = std::max(width, 1.0) / 2.0;
+
+	// Corners of the rectangle, in order around it.
+	double cornerX[4] = {
+		x1 - ux * 0.5 - uy * half, x2 + ux * 0.5 - uy * half,
+		x2 + ux * 0.5 + uy * half, x1 - ux * 0.5 + uy * half
+	};
+	double cornerY[4] = {
+		y1 - uy * 0.5 + ux * half, y2 + uy * 0.5 + ux * half,
+		y2 + uy * 0.5 - ux * half, y1 - uy * 0.5 - ux * half
+	};
+
+	double yMin = std::min(std::min(cornerY[0], cornerY[1]), std::min(cornerY[2], cornerY[3]));
+	double yMax = std::max(std::max(cornerY[0], cornerY[1]), std::max(cornerY[2], cornerY[3]));
+
+	// Edges as x = x0 + (y - y0) * slope between their lowest and highest y. Horizontal edges are
+	// left out: the two edges next to them reach the same rows and give the same ends.
+	double edgeX[4], edgeY[4], edgeSlope[4], edgeLow[4], edgeHigh[4];
+	int edgeCount = 0;
+	for (int e = 0; e < 4; e++)
+	{
+		double ax = cornerX[e], ay = cornerY[e];
+		double bx = cornerX[(e + 1) % 4], by = cornerY[(e + 1) % 4];
+		if (ay == by)
+			continue;
+
+		edgeX[edgeCount] = ax;
+		edgeY[edgeCount] = ay;
+		edgeSlope[edgeCount] = (bx - ax) / (by - ay);
+		edgeLow[edgeCount] = std::min(ay, by);
+		edgeHigh[edgeCount] = std::max(ay, by);
+		edgeCount++;
+	}
+
+	// Rows and columns whose centres are in [min, max).
+	long long firstRow = ceilToInt(yMin), lastRow = ceilToInt(yMax) - 1;
+	if (lastRow >= firstRow)
+	{
+		spans.reserve(lastRow - firstRow + 1);
+	}
+	for (long long row = firstRow; row <= lastRow; row++)
+	{
+		double y = (double)row;
+		double left = DBL_MAX, right = -DBL_MAX;
+		for (int e = 0; e < edgeCount; e++)
+		{
+			if (y < edgeLow[e] || y > edgeHigh[e])
+				continue;
+
+			double x = edgeX[e] + (y - edgeY[e]) * edgeSlope[e];
+			left = std::min(left, x);
+			right = std::max(right, x);
+		}
+
+		long long xStart = ceilToInt(left), xEnd = ceilToInt(right) - 1;
+		if (xStart <= xEnd)
+		{
+			PixelSpan span = { (int)row, (int)xStart, (int)xEnd };
+			spans.push_back(span);
+		}
+	}
+}
+
+/**
+ * This function finds the part of a line inside a rectangle as the Bresenham walk of drawLineOctant
+ * resumed at its first visible pixel. The first and last visible steps are found without walking the
+ * hidden part of the line: Bresenham pixels are at most half a pixel away from the ideal line, and the
+ * minor axis position of any step has a closed form.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line.
+ * @param rect The visible rectangle.
+ * @param span Receives the visible part of the walk.
+ * 
+ * @return false if no pixel of the line is inside the rectangle.
+ */
+bool MathOGL::clipLineSpan(double x1, double y1, double x2, double y2, const ClipRect& rect, LineSpan& span)
+{
+	// Pixels have integer coordinates, so only the integer part of the rectangle matters.
+	long long left = ceilToInt(rect.xMin), right = floorToInt(rect.xMax);
+	long long bottom = ceilToInt(rect.yMin), top = floorToInt(rect.yMax);
+	if (left > right || bottom > top)
+		return false;
+
+	int xStart = x1, yStart = y1;
+	long long dx = (long long)(int)x2 - xStart;
+	long long dy = (long long)(int)y2 - yStart;
+	long long adx = dx < 0 ? -dx : dx;
+	long long ady = dy < 0 ? -dy : dy;
+	bool xMajor = adx > ady;
+	long long dMajor = xMajor ? adx : ady;
+	long long dMinor = xMajor ? ady : adx;
+	int stepX = dx < 0 ? -1 : 1;
+	int stepY = dy < 0 ? -1 : 1;
+
+	// Bresenham pixels are at most half a pixel away from the ideal line across the major axis, so
+	// the steps where Liang-Barsky finds the line inside the rectangle grown by half a pixel, plus one
+	// for rounding, include every visible pixel.
+	ClipRect grown = { left - 0.5, bottom - 0.5, right + 0.5, top + 0.5 };
+	double t0, t1;
+	if (!liangBarskyRange(xStart, yStart, xStart + dx, yStart + dy, grown, t0, t1))
+		return false;
+	long long first = std::max<long long>(0, (long long)floor(t0 * dMajor) - 1);
+	long long last = std::min<long long>(dMajor, (long long)ceil(t1 * dMajor) + 1);
+
+	// Number of minor axis steps taken before pixel s, and the pixel itself.
+	auto minorSteps = [&](long long s) { return dMajor == 0 ? 0 : (2 * s * dMinor + dMajor - 1) / (2 * dMajor); };
+	auto pixelX = [&](long long s) { return xStart + stepX * (xMajor ? s : minorSteps(s)); };
+	auto pixelY = [&](long long s) { return yStart + stepY * (xMajor ? minorSteps(s) : s); };
+	// Both coordinates move monotonically, so "has reached the rectangle" and "has left it" switch
+	// from false to true once along the line and can be searched with bisection.
+	auto reached = [&](long long s) {
+		long long x = pixelX(s), y = pixelY(s);
+		return (stepX > 0 ? x >= left : x <= right) && (stepY > 0 ? y >= bottom : y <= top);
+	};
+	auto passed = [&](long long s) {
+		long long x = pixelX(s), y = pixelY(s);
+		return (stepX > 0 ? x > right : x < left) || (stepY > 0 ? y > top : y < bottom);
+	};
+
+	if (!reached(last) || passed(first))
+		return false;
+
+	long long low = first, high = last;
+	while (low < high)
+	{
+		long long mid = low + (high - low) / 2;
+		if (reached(mid))
+			high = mid;
+		else
+			low = mid + 1;
+	}
+	first = low;
+
+	low = first;
+	high = last;
+	while (low < high)
+	{
+		long long mid = low + (high - low + 1) / 2;
+		if (passed(mid))
+			high = mid - 1;
+		else
+			low = mid;
+	}
+	last = low;
+
+	if (first > last || passed(first))
+		return false;
+
+	span.x = (int)pixelX(first);
+	span.y = (int)pixelY(first);
+	span.err = (int)(2 * dMinor * (first + 1) - dMajor - 2 * dMajor * minorSteps(first));
+	span.count = (int)(last - first + 1);
+	span.dMajor = (int)dMajor;
+	span.dMinor = (int)dMinor;
+	span.stepX = stepX;
+	span.stepY = stepY;
+	span.xMajor = xMajor;
+	return true;
+}
+
+/**
+ * This function returns the whole Bresenham walk of drawLineOctant from (x1, y1) to (x2, y2).
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line.
+ * 
+ * @return the walk, starting at the first pixel.
+ */
+MathOGL::LineSpan MathOGL::lineSpan(double x1, double y1, double x2, double y2)
+{
+	LineSpan span;
+	span.x = x1;
+	span.y = y1;
+	int dx = (int)x2 - span.x;
+	int dy = (int)y2 - span.y;
+	int adx = abs(dx);
+	int ady = abs(dy);
+	span.xMajor = adx > ady;
+	span.dMajor = span.xMajor ? adx : ady;
+	span.dMinor = span.xMajor ? ady : adx;
+	span.stepX = dx < 0 ? -1 : 1;
+	span.stepY = dy < 0 ? -1 : 1;
+	span.err = 2 * span.dMinor - span.dMajor;
+	span.count = span.dMajor + 1;
+	return span;
+}
+
+/**
+ * This function draws the part of a drawLineBasic line inside a rectangle. The x-coordinate grows by
+ * one per step and, after the first step, the y-coordinate never decreases, so the walk stops as soon
+ * as it leaves the rectangle through its right or top side. The hidden steps before the first visible
+ * one only update the y-coordinate.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line.
+ * @param rect The visible rectangle.
+ * 
+ * @return the points of drawLineBasic inside the rectangle, in the same order.
+ */
+std::vector<glm::vec3> MathOGL::drawLineBasicClipped(double x1, double y1, double x2, double y2, const ClipRect& rect)
+{
+	std::vector<glm::vec3> points;
+	double dx = abs(x2 - x1);
+	double dy = abs(y2 - y1);
+	double m = dy / dx;
+	double xi, yi;
+	int i = x1;
+	yi = y1;
+
+	// At most one point per visible column.
+	long long lastColumn = std::min<long long>(floorToInt(rect.xMax), (long long)i + (long long)countLineBasic(x1, y1, x2, y2) - 1);
+	long long columns = lastColumn - std::max<long long>(ceilToInt(rect.xMin), i) + 1;
+	if (columns <= 0)
+		return points;
+	points.reserve((size_t)columns);
+
+	if (insideRange(i, rect.xMin, rect.xMax) && insideRange(yi, rect.yMin, rect.yMax))
+		points.push_back(glm::vec3(i, yi, 0));
+	while (i < x2) {
+		i = i + 1;
+		xi = i;
+		yi = roundf(yi + m);
+		if (xi > rect.xMax || yi > rect.yMax)
+			break;
+		if (xi >= rect.xMin && yi >= rect.yMin)
+			points.push_back(glm::vec3(xi, yi, 0));
+	}
+	return points;
+}
+
+/**
+ * This function draws the part of a drawLineBres line inside a rectangle. Both coordinates only grow
+ * along the walk, so it stops as soon as it leaves the rectangle through its right or top side. The
+ * hidden steps before the first visible one only update the decision parameter.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line.
+ * @param rect The visible rectangle.
+ * 
+ * @return the points of drawLineBres inside the rectangle, in the same order.
+ */
+std::vector<glm::vec3> MathOGL::drawLineBresClipped(double x1, double y1, double x2, double y2, const ClipRect& rect)
+{
+	std::vector<glm::vec3> points;
+	double dx = x2 - x1;
+	double dy = y2 - y1;
+	double pk = 2 * dy - dx;
+
+	// At most one point per visible column.
+	int xStart = x1;
+	long long lastColumn = std::min(floorToInt(rect.xMax), floorToInt(x2));
+	long long columns = lastColumn - std::max<long long>(ceilToInt(rect.xMin), xStart) + 1;
+	if (columns <= 0)
+		return points;
+	points.reserve((size_t)columns);
+
+	for (int x = xStart, y = y1; x <= x2; x++) {
+
+		if (x > rect.xMax || y > rect.yMax)
+			break;
+		if (x >= rect.xMin && y >= rect.yMin)
+			points.push_back(glm::vec3(x, y, 0));
+
+		dx = x2 - x;
+		dy = y2 - y;
+
+		if (pk >= 0)
+		{
+			pk = pk + 2 * dy - 2 * dx;
+			y++;
+		}
+		else
+		{
+			pk = pk + 2 * dy;
+		}
+
+	}
+	return points;
+}
+
+/**
+ * This function draws the part of a drawLineDDA line inside a rectangle. Each step moves one of the
+ * coordinates up by one, so the walk stops as soon as it leaves the rectangle through its right or
+ * top side, even on the lines drawLineDDA never finishes; it also stops where drawLineDDA would
+ * divide by a zero step. The hidden steps before the first visible one are walked without storing
+ * any point.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line.
+ * @param rect The visible rectangle.
+ * 
+ * @return the points of drawLineDDA inside the rectangle, in the same order.
+ */
+std::vector<glm::vec3> MathOGL::drawLineDDAClipped(double x1, double y1, double x2, double y2, const ClipRect& rect)
+{
+	std::vector<glm::vec3> points;
+	float dy = 0;
+	float dx = 0;
+	int xi, yi;
+	float step = 0;
+
+	xi = x1;
+	yi = y1;
+	if (insideRange(xi, rect.xMin, rect.xMax) && insideRange(yi, rect.yMin, rect.yMax))
+		points.push_back(glm::vec3(xi, yi, 0));
+
+	while ((xi < x2 || yi < x2) && xi <= rect.xMax && yi <= rect.yMax) {
+
+		dy = abs(y2 - yi);
+		dx = abs(x2 - xi);
+
+		if (dx > dy)
+		{
+			step = dx;
+			dx = dx / step;
+			xi = xi + dx;
+		}
+		else
+		{
+			if (dy == 0)
+				break;
+			step = dy;
+			dy = dy / step;
+			yi = yi + dy;
+		}
+
+		if (insideRange(xi, rect.xMin, rect.xMax) && insideRange(yi, rect.yMin, rect.yMax))
+			points.push_back(glm::vec3(xi, yi, 0));
+	}
+	return points;
+}
+
+/**
+ * This function draws the part of a midPointCircleDraw arc inside a rectangle. Along the walk one
+ * coordinate of each of its two octants grows by exactly one per step, so the visible steps of the
+ * octant are known upfront: the hidden steps before them only update the decision parameter and
+ * the walk stops after the last of them.
+ * 
+ * @param x_centre The x-coordinate of the center of the circle.
+ * @param y_centre The y-coordinate of the center point of the circle.
+ * @param r The radius of the circle to be drawn.
+ * @param rect The visible rectangle.
+ * 
+ * @return the points of midPointCircleDraw inside the rectangle, in the same order.
+ */
+std::vector<glm::vec3> MathOGL::midPointCircleClipped(double x_centre, double y_centre, double r, const ClipRect& rect)
+{
+	std::vector<glm::vec3> points;
+	int x = r, y = 0;
+
+	// The arc is the quadrant of positive offsets, inside the box from the centre to centre + r.
+	if (x_centre + r < rect.xMin || x_centre > rect.xMax || y_centre + r < rect.yMin || y_centre > rect.yMax)
+		return points;
+	if (x_centre >= rect.xMin && x_centre + r <= rect.xMax && y_centre >= rect.yMin && y_centre + r <= rect.yMax)
+		return midPointCircleDraw(x_centre, y_centre, r);
+
+	if (r > 0)
+	{
+		if (insideRange(r + x_centre, rect.xMin, rect.xMax) && insideRange(y_centre, rect.yMin, rect.yMax))
+			points.push_back(glm::vec3((r + x_centre), (y_centre), 0));
+		if (insideRange(x_centre, rect.xMin, rect.xMax) && insideRange(r + y_centre, rect.yMin, rect.yMax))
+			points.push_back(glm::vec3((x_centre), (r + y_centre), 0));
+	}
+	else
+	{
+		if (insideRange(x_centre, rect.xMin, rect.xMax) && insideRange(y_centre, rect.yMin, rect.yMax))
+			points.push_back(glm::vec3((x_centre), (y_centre), 0));
+	}
+
+	// (x + x_centre, y + y_centre) is visible on steps whose y + y_centre is inside the rectangle,
+	// (y + x_centre, x + y_centre) on steps whose y + x_centre is.
+	long long firstA, lastA, firstB, lastB;
+	stepRange(y_centre, 1, rect.yMin, rect.yMax, firstA, lastA);
+	stepRange(x_centre, 1, rect.xMin, rect.xMax, firstB, lastB);
+	long long lastStep = std::max(lastA, lastB);
+
+	int P = 1 - r;
+	while (x > y && y < lastStep)
+	{
+		y++;
+		if (P <= 0)
+			P = P + 2 * y + 1;
+		else
+		{
+			x--;
+			P = P + 2 * y - 2 * x + 1;
+		}
+
+		if (x < y)
+			break;
+
+		if (y >= firstA && y <= lastA && insideRange(x + x_centre, rect.xMin, rect.xMax))
+			points.push_back(glm::vec3((x + x_centre), (y + y_centre), 0));
+
+		if (x != y && y >= firstB && y <= lastB && insideRange(x + y_centre, rect.yMin, rect.yMax))
+			points.push_back(glm::vec3((y + x_centre), (x + y_centre), 0));
+	}
+	return points;
+}
+
+/**
+ * This function draws the part of a BresenhamCircle inside a rectangle. Circles entirely inside or
+ * outside are resolved from their bounding box; otherwise each of the eight octants only emits the
+ * steps where its coordinate that grows by one per step is inside the rectangle, and the walk stops
+ * after the last visible step of any octant.
+ * 
+ * @param x_center The x-coordinate of the center of the circle.
+ * @param y_center The y-coordinate of the center of the circle.
+ * @param r The radius of the circle.
+ * @param rect The visible rectangle.
+ * 
+ * @return the points of BresenhamCircle inside the rectangle, in the same order.
+ */
+std::vector<glm::vec3> MathOGL::BresenhamCircleClipped(double x_center, double y_center, double r, const ClipRect& rect)
+{
+	std::vector<glm::vec3> points;
+	int radius = r;
+
+	if (x_center + radius < rect.xMin || x_center - radius > rect.xMax || y_center + radius < rect.yMin || y_center - radius > rect.yMax)
+		return points;
+	if (x_center - radius >= rect.xMin && x_center + radius <= rect.xMax && y_center - radius >= rect.yMin && y_center + radius <= rect.yMax)
+		return BresenhamCircle(x_center, y_center, r);
+
+	// Signs and axis swap of each octant, in the order of BresenhamCirclePoints.
+	static const int octants[8][3] = {
+		{ 1, 1, 0 }, { -1, 1, 0 }, { 1, -1, 0 }, { -1, -1, 0 },
+		{ 1, 1, 1 }, { -1, 1, 1 }, { 1, -1, 1 }, { -1, -1, 1 },
+	};
+	long long first[8], last[8];
+	long long firstStep = LLONG_MAX, lastStep = -1;
+	for (int o = 0; o < 8; o++)
+	{
+		if (octants[o][2] == 0)
+			stepRange(x_center, octants[o][0], rect.xMin, rect.xMax, first[o], last[o]);
+		else
+			stepRange(y_center, octants[o][1], rect.yMin, rect.yMax, first[o], last[o]);
+
+		if (first[o] <= last[o])
+		{
+			firstStep = std::min(firstStep, first[o]);
+			lastStep = std::max(lastStep, last[o]);
+		}
+	}
+
+	int x = 0;
+	int y = radius;
+	int d = 3 - 2 * y;
+
+	while (y >= x && x <= lastStep)
+	{
+		if (x >= firstStep)
+		{
+			for (int o = 0; o < 8; o++)
+			{
+				if (x < first[o] || x > last[o])
+					continue;
+
+				int sx = octants[o][0], sy = octants[o][1];
+				double px = octants[o][2] == 0 ? x_center + sx * x : x_center + sx * y;
+				double py = octants[o][2] == 0 ? y_center + sy * y : y_center + sy * x;
+				if (insideRange(px, rect.xMin, rect.xMax) && insideRange(py, rect.yMin, rect.yMax))
+					points.push_back(glm::vec3(px, py, 0));
+			}
+		}
+
+		x++;
+		if (d > 0)
+		{
+			y--;
+			d = d + 4 * (x - y) + 10;
+		}
+		else
+			d = d + 4 * x + 6;
+	}
+
+	std::sort(points.begin(), points.end(), &MathOGL::compareVecByElems);
+	auto it = std::unique(points.begin(), points.end());
+	points.erase(it, points.end());
+
+	return points;
+}
+
+/**
+ * This function removes the points lying on the straight segment joining their neighbours, so each
+ * run of pixels going in the same direction becomes a single segment. Only exactly collinear points
+ * are removed, the polyline drawn is the same.
+ * 
+ * @param points The vertices of the polyline, in drawing order.
+ * 
+ * @return the first and last points and the points where the direction changes.
+ */
+std::vector<glm::vec3> MathOGL::collapseCollinear(const std::vector<glm::vec3>& points)
+{
+	if (points.size() < 3)
+		return points;
+
+	std::vector<glm::vec3> kept;
+
+	kept.push_back(points[0]);
+	for (size_t i = 1; i + 1 < points.size(); i++)
+	{
+		// Pixels have integer coordinates, so these products are exact in double.
+		const glm::vec3& a = kept.back();
+		const glm::vec3& b = points[i];
+		const glm::vec3& c = points[i + 1];
+		double ux = (double)b.x - a.x, uy = (double)b.y - a.y, uz = (double)b.z - a.z;
+		double vx = (double)c.x - b.x, vy = (double)c.y - b.y, vz = (double)c.z - b.z;
+		bool collinear = uy * vz - uz * vy == 0 && uz * vx - ux * vz == 0 && ux * vy - uy * vx == 0;
+
+		// A point where the polyline turns back, or a repeated one, is kept.
+		if (!collinear || ux * vx + uy * vy + uz * vz <= 0)
+		{
+			kept.push_back(b);
+		}
+	}
+	kept.push_back(points.back());
+	return kept;
+}
+
+/**
+ * This function simplifies a polyline with collapseCollinear and then, when a tolerance is given,
+ * with the Douglas-Peucker algorithm: a point is dropped when it is closer than the tolerance to the
+ * segment that replaces it. Bresenham pixels are within half a pixel of the ideal line, so a
+ * tolerance of 0.5 turns any rasterized line back into one segment.
+ * 
+ * @param points The vertices of the polyline, in drawing order.
+ * @param tolerance The largest distance from a dropped point to the simplified polyline, 0 to only
+ * remove collinear points.
+ * 
+ * @return the vertices of the simplified polyline, the first and last points are always kept.
+ */
+std::vector<glm::vec3> MathOGL::simplifyPolyline(const std::vector<glm::vec3>& points, double tolerance)
+{
+	std::vector<glm::vec3> collapsed = collapseCollinear(points);
+	if (tolerance <= 0.0 || collapsed.size() < 3)
+		return collapsed;
+
+	// Explicit stack of the ranges left to split, a long staircase would nest the recursion deeply.
+	double limit = tolerance * tolerance;
+	std::vector<char> keep(collapsed.size(), 0);
+	std::vector<std::pair<size_t, size_t> > ranges;
+	keep[0] = 1;
+	keep[collapsed.size() - 1] = 1;
+	ranges.push_back(std::make_pair((size_t)0, collapsed.size() - 1));
+
+	while (!ranges.empty())
+	{
+		size_t first = ranges.back().first, last = ranges.back().second;
+		ranges.pop_back();
+
+		double farthest = -1.0;
+		size_t split = first;
+		for (size_t i = first + 1; i < last; i++)
+		{
+			double distance = squaredDistanceToSegment(collapsed[i], collapsed[first], collapsed[last]);
+			if (distance > farthest)
+			{
+				farthest = distance;
+				split = i;
+			}
+		}
+
+		if (farthest > limit)
+		{
+			keep[split] = 1;
+			ranges.push_back(std::make_pair(first, split));
+			ranges.push_back(std::make_pair(split, last));
+		}
+	}
+
+	std::vector<glm::vec3> simplified;
+	for (size_t i = 0; i < collapsed.size(); i++)
+	{
+		if (keep[i])
+		{
+			simplified.push_back(collapsed[i]);
+		}
+	}
+	return simplified;
+}
+
+/**
+ * This function finds the part of the segment from (x1, y1) to (x2, y2) inside a rectangle as a range
+ * of the parameter t of x1 + t * (x2 - x1), y1 + t * (y2 - y1), following Liang-Barsky.
+ * 
+ * @param x1 The x-coordinate of the starting point.
+ * @param y1 The y-coordinate of the starting point.
+ * @param x2 The x-coordinate of the end point.
+ * @param y2 The y-coordinate of the end point.
+ * @param rect The rectangle.
+ * @param t0 Receives the parameter where the segment enters the rectangle.
+ * @param t1 Receives the parameter where the segment leaves the rectangle.
+ * 
+ * @return false if no part of the segment is inside the rectangle.
+ */
+bool MathOGL::liangBarskyRange(double x1, double y1, double x2, double y2, const ClipRect& rect, double& t0, double& t1)
+{
+	double dx = x2 - x1;
+	double dy = y2 - y1;
+	double p[4] = { -dx, dx, -dy, dy };
+	double q[4] = { x1 - rect.xMin, rect.xMax - x1, y1 - rect.yMin, rect.yMax - y1 };
+
+	t0 = 0.0;
+	t1 = 1.0;
+	for (int i = 0; i < 4; i++)
+	{
+		if (p[i] == 0.0)
+		{
+			// Parallel to this border and outside of it.
+			if (q[i] < 0.0)
+				return false;
+			continue;
+		}
+
+		double t = q[i] / p[i];
+		if (p[i] < 0.0)
+			t0 = std::max(t0, t);
+		else
+			t1 = std::min(t1, t);
+
+		if (t0 > t1)
+			return false;
+	}
+	return true;
+}
+
+/**
+ * The function computes the Cohen-Sutherland region code of a point.
+ * 
+ * @param x The x-coordinate of the point.
+ * @param y The y-coordinate of the point.
+ * @param rect The rectangle.
+ * 
+ * @return a combination of 1 (left), 2 (right), 4 (below) and 8 (above), 0 if the point is inside.
+ */
+int MathOGL::outCode(double x, double y, const ClipRect& rect)
+{
+	int code = 0;
+	if (x < rect.xMin)
+		code |= 1;
+	else if (x > rect.xMax)
+		code |= 2;
+	if (y < rect.yMin)
+		code |= 4;
+	else if (y > rect.yMax)
+		code |= 8;
+	return code;
+}
+
+/**
+ * The function finds the steps s >= 0 for which center + sign * s lies between low and high.
+ * 
+ * @param center The coordinate at step 0.
+ * @param sign 1 if the coordinate grows with the steps, -1 if it decreases.
+ * @param low The lowest visible coordinate.
+ * @param high The highest visible coordinate.
+ * @param first Receives the first visible step.
+ * @param last Receives the last visible step, lower than first if there is none.
+ */
+void MathOGL::stepRange(double center, int sign, double low, double high, long long& first, long long& last)
+{
+	if (sign > 0)
+	{
+		first = ceilToInt(low - center);
+		last = floorToInt(high - center);
+	}
+	else
+	{
+		first = ceilToInt(center - high);
+		last = floorToInt(center - low);
+	}
+	first = std::max<long long>(first, 0);
+}
+
+/**
+ * This function returns the squared distance from a point to a segment.
+ * 
+ * @param p The point.
+ * @param a The starting point of the segment.
+ * @param b The end point of the segment.
+ * 
+ * @return the squared distance from p to the closest point of the segment.
+ */
+double MathOGL::squaredDistanceToSegment(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b)
+{
+	double abx = (double)b.x - a.x, aby = (double)b.y - a.y, abz = (double)b.z - a.z;
+	double apx = (double)p.x - a.x, apy = (double)p.y - a.y, apz = (double)p.z - a.z;
+	double length = abx * abx + aby * aby + abz * abz;
+	double t = length > 0.0 ? (apx * abx + apy * aby + apz * abz) / length : 0.0;
+	t = std::min(1.0, std::max(0.0, t));
+
+	double dx = apx - t * abx, dy = apy - t * aby, dz = apz - t * abz;
+	return dx * dx + dy * dy + dz * dz;
+}
+
+/**
+ * This function appends to a chain code the pixels of a Bresenham walk. Each step either advances
+ * the major axis only or both axes, so it is one of two directions fixed for the whole line.
+ * 
+ * @param span The walk, see clipLineSpan.
+ * @param chain Receives the chain code, started at the first pixel of the walk.
+ */
+void MathOGL::chainSpan(LineSpan span, ChainCode& chain)
+{
+	chain.start(span.x, span.y);
+
+	int straight = span.xMajor ? ChainCode::direction(span.stepX, 0) : ChainCode::direction(0, span.stepY);
+	int diagonal = ChainCode::direction(span.stepX, span.stepY);
+	const int stepMinor = 2 * span.dMinor;
+	const int stepBoth = 2 * span.dMinor - 2 * span.dMajor;
+
+	for (int i = 1; i < span.count; i++)
+	{
+		int minor = span.err > 0;
+		span.err += minor ? stepBoth : stepMinor;
+		chain.push(minor ? diagonal : straight);
+	}
 }
 
 /**
@@ -3,6 +3,42 @@
 #include <vector>
 #include <algorithm>
 
+#include "ChainCode.h"
+
+/**
+ * Structure-of-arrays view of count vectors: component i of vector n is x[n], y[n] or z[n]. The arrays
+ * are not owned by the view.
+ */
+struct Vec3SoA
+{
+	float* x;
+	float* y;
+	float* z;
+	size_t count;
+};
+
+/**
+ * Axis-aligned rectangle of the coordinate space, in the same units as the rasterized points. Points
+ * on its border are inside.
+ */
+struct ClipRect
+{
+	double xMin;
+	double yMin;
+	double xMax;
+	double yMax;
+};
+
+/**
+ * Run of pixels of one row, from xStart to xEnd inclusive, as emitted by the thick line rasterizer.
+ */
+struct PixelSpan
+{
+	int y;
+	int xStart;
+	int xEnd;
+};
+
 class MathOGL
 {
 public:
@@ -16,17 +52,344 @@ public:
 	double angleBetween(glm::vec3 vec1, glm::vec3 vec2);
 	glm::vec3 normalize(glm::vec3 vec1);
 	glm::mat4 translate(glm::vec3 t);
+	glm::mat4 scale(glm::vec3 s);
+	glm::mat4 rotate(double angle, glm::vec3 axis);
+	glm::mat4 compose(const glm::mat4& first, const glm::mat4& second);
+	void transformPoints(const glm::mat4& transform, glm::vec3* points, size_t count);
+	void transformPoints(const glm::mat4& transform, std::vector<glm::vec3>& points);
+
+	// Batch versions over whole point clouds, in float precision. The output may be one of the inputs.
+	void vecSum(const Vec3SoA& vec1, const Vec3SoA& vec2, Vec3SoA& out);
+	void vectorSubtraction(const Vec3SoA& vec1, const Vec3SoA& vec2, Vec3SoA& out);
+	void scalarMultiplication(const Vec3SoA& vec1, double escalar, Vec3SoA& out);
+	void crossProduct(const Vec3SoA& vec1, const Vec3SoA& vec2, Vec3SoA& out);
+	void dotProduct(const Vec3SoA& vec1, const Vec3SoA& vec2, float* out);
+	void normalize(const Vec3SoA& vec1, Vec3SoA& out);
+	void angleBetween(const Vec3SoA& vec1, const Vec3SoA& vec2, float* out);
+	void vecSum(const glm::vec3* vec1, const glm::vec3* vec2, glm::vec3* out, size_t count);
+	void vectorSubtraction(const glm::vec3* vec1, const glm::vec3* vec2, glm::vec3* out, size_t count);
+	void scalarMultiplication(const glm::vec3* vec1, double escalar, glm::vec3* out, size_t count);
+	void crossProduct(const glm::vec3* vec1, const glm::vec3* vec2, glm::vec3* out, size_t count);
+	void dotProduct(const glm::vec3* vec1, const glm::vec3* vec2, float* out, size_t count);
+	void normalize(const glm::vec3* vec1, glm::vec3* out, size_t count);
+	void angleBetween(const glm::vec3* vec1, const glm::vec3* vec2, float* out, size_t count);
+
 	std::vector<glm::vec3> drawLineBasic(double x1, double y1, double x2, double y2);
 	std::vector<glm::vec3> drawLineBres(double x1, double y1, double x2, double y2);
 	std::vector<glm::vec3> drawLineDDA(double x1, double y1, double x2, double y2);
 	std::vector<glm::vec3> midPointCircleDraw(double x_centre, double y_centre, double r);
 	std::vector<glm::vec3> BresenhamCircle(double x_center, double y_center, double r);
+	std::vector<glm::vec3> drawLineOctant(double x1, double y1, double x2, double y2);
+
+	// One octant of each circle, as offsets from the centre, for drawing with 8 reflections.
+	std::vector<glm::vec3> midPointCircleOctant(double r);
+	std::vector<glm::vec3> BresenhamCircleOctant(double r);
+
+	// Freeman chain codes of the same pixels, built while walking instead of storing every pixel.
+	ChainCode chainLineOctant(double x1, double y1, double x2, double y2);
+	ChainCode chainLineClipped(double x1, double y1, double x2, double y2, const ClipRect& rect);
+	ChainCode chainBresenhamCircleOctant(double r);
+
+	// Clipping to the visible coordinate space, before rasterizing.
+	bool clipLineLiangBarsky(double& x1, double& y1, double& x2, double& y2, const ClipRect& rect);
+	bool clipLineCohenSutherland(double& x1, double& y1, double& x2, double& y2, const ClipRect& rect);
+	std::vector<glm::vec3> drawLineClipped(double x1, double y1, double x2, double y2, const ClipRect& rect);
+	void drawLineClipped(double x1, double y1, double x2, double y2, const ClipRect& rect, std::vector<glm::vec3>& points);
+
+	// Thick lines as horizontal pixel spans, drawn as filled quads instead of wide GL lines.
+	std::vector<PixelSpan> thickLineSpans(double x1, double y1, double x2, double y2, double width);
+	void thickLineSpans(double x1, double y1, double x2, double y2, double width, std::vector<PixelSpan>& spans);
+
+	/**
+	 * Bresenham walk of drawLineOctant from any of its pixels: the pixel, the error term there, the
+	 * number of pixels left and the direction of the line.
+	 */
+	struct LineSpan
+	{
+		int x, y;
+		int err;
+		int count;
+		int dMajor, dMinor;
+		int stepX, stepY;
+		bool xMajor;
+	};
+	static LineSpan lineSpan(double x1, double y1, double x2, double y2);
+	static bool clipLineSpan(double x1, double y1, double x2, double y2, const ClipRect& rect, LineSpan& span);
+	std::vector<glm::vec3> drawLineBasicClipped(double x1, double y1, double x2, double y2, const ClipRect& rect);
+	std::vector<glm::vec3> drawLineBresClipped(double x1, double y1, double x2, double y2, const ClipRect& rect);
+	std::vector<glm::vec3> drawLineDDAClipped(double x1, double y1, double x2, double y2, const ClipRect& rect);
+	std::vector<glm::vec3> midPointCircleClipped(double x_centre, double y_centre, double r, const ClipRect& rect);
+	std::vector<glm::vec3> BresenhamCircleClipped(double x_center, double y_center, double r, const ClipRect& rect);
+
+	// Polyline simplification of ordered raster output, before building line geometry.
+	std::vector<glm::vec3> collapseCollinear(const std::vector<glm::vec3>& points);
+	std::vector<glm::vec3> simplifyPolyline(const std::vector<glm::vec3>& points, double tolerance);
+
+	// Exact number of pixels emitted by each rasterizer for the given parameters.
+	static const size_t rasterUnbounded = static_cast<size_t>(-1);
+	static constexpr size_t countLineBasic(double x1, double y1, double x2, double y2);
+	static constexpr size_t countLineBres(double x1, double y1, double x2, double y2);
+	static constexpr size_t countLineDDA(double x1, double y1, double x2, double y2);
+	static constexpr size_t countMidPointCircle(double x_centre, double y_centre, double r);
+	static constexpr size_t countBresenhamCircle(double x_center, double y_center, double r);
+	static constexpr size_t countLineOctant(double x1, double y1, double x2, double y2);
 
 	~MathOGL();
 
 private:
 	void BresenhamCirclePoints(double x_center, double y_center, double x, double y, std::vector<glm::vec3>& points );
 	static bool compareVecByElems(const glm::vec3& a, const glm::vec3& b);
+	static constexpr size_t countBresenhamCircleSteps(double r);
+	static constexpr long long floorToInt(double v);
+	static constexpr long long ceilToInt(double v);
+	static bool liangBarskyRange(double x1, double y1, double x2, double y2, const ClipRect& rect, double& t0, double& t1);
+	static int outCode(double x, double y, const ClipRect& rect);
+	static void stepRange(double center, int sign, double low, double high, long long& first, long long& last);
+	static bool insideRange(double v, double low, double high) { return v >= low && v <= high; }
+	static double squaredDistanceToSegment(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b);
+	static void chainSpan(LineSpan span, ChainCode& chain);
+
+	// Number of AoS vectors transposed to SoA at a time by the AoS batch functions.
+	enum { aosChunk = 256 };
+	static void toSoA(const glm::vec3* vectors, size_t count, float* x, float* y, float* z);
+	static void fromSoA(const float* x, const float* y, const float* z, size_t count, glm::vec3* vectors);
+	static void addFloats(const float* a, const float* b, float* out, size_t count);
+	static void subtractFloats(const float* a, const float* b, float* out, size_t count);
+	static void scaleFloats(const float* a, float scale, float* out, size_t count);
+
+	// Transforms are classified once per call so each range runs the cheapest kernel that applies.
+	enum TransformKind { transformIdentity, transformTranslation, transformAffine2D, transformAffine, transformProjective };
+	// Points below which transformPoints doesn't start another thread.
+	enum { transformPointsPerThread = 1 << 18 };
+	static TransformKind classifyTransform(const glm::mat4& m);
+	static void transformRange(const glm::mat4& m, TransformKind kind, glm::vec3* points, size_t count);
+	static void translateRange(const glm::vec3& t, glm::vec3* points, size_t count);
+	static void transformSoA(const glm::mat4& m, TransformKind kind, float* x, float* y, float* z, size_t count);
 
 };
 
+/**
+ * The function rounds a value down to the nearest integer without relying on non-constexpr <cmath>.
+ * 
+ * @param v The value to round.
+ * 
+ * @return the largest integer not greater than v.
+ */
+constexpr long long MathOGL::floorToInt(double v)
+{
+	long long t = static_cast<long long>(v);
+	return (t > v) ? t - 1 : t;
+}
+
+/**
+ * The function rounds a value up to the nearest integer without relying on non-constexpr <cmath>.
+ * 
+ * @param v The value to round.
+ * 
+ * @return the smallest integer not lower than v.
+ */
+constexpr long long MathOGL::ceilToInt(double v)
+{
+	long long t = static_cast<long long>(v);
+	return (t < v) ? t + 1 : t;
+}
+
+/**
+ * The function returns the number of points drawLineBasic emits for the same parameters.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line (it does not affect the count).
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line (it does not affect the count).
+ * 
+ * @return the exact size of the vector returned by drawLineBasic.
+ */
+constexpr size_t MathOGL::countLineBasic(double x1, double /* y1 */, double x2, double /* y2 */)
+{
+	// The loop starts at the truncated x1 and steps while i < x2.
+	long long span = ceilToInt(x2 - static_cast<int>(x1));
+	return 1 + static_cast<size_t>(span > 0 ? span : 0);
+}
+
+/**
+ * The function returns the number of points drawLineBres emits for the same parameters.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line (it does not affect the count).
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line (it does not affect the count).
+ * 
+ * @return the exact size of the vector returned by drawLineBres.
+ */
+constexpr size_t MathOGL::countLineBres(double x1, double /* y1 */, double x2, double /* y2 */)
+{
+	// The loop runs from the truncated x1 while x <= x2.
+	long long span = floorToInt(x2) - static_cast<int>(x1) + 1;
+	return static_cast<size_t>(span > 0 ? span : 0);
+}
+
+/**
+ * The function returns the number of points drawLineDDA emits for the same parameters. The DDA walk
+ * has no closed form, so its integer steps are replayed without storing any point.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line.
+ * 
+ * @return the exact size of the vector returned by drawLineDDA, or rasterUnbounded when its loop
+ * never terminates (it walks away from the end point or divides by a zero step).
+ */
+constexpr size_t MathOGL::countLineDDA(double x1, double y1, double x2, double y2)
+{
+	int xi = static_cast<int>(x1);
+	int yi = static_cast<int>(y1);
+	size_t count = 1;
+
+	while (xi < x2 || yi < x2) {
+		float dy = static_cast<float>(y2 > yi ? y2 - yi : yi - y2);
+		float dx = static_cast<float>(x2 > xi ? x2 - xi : xi - x2);
+
+		if (dx > dy)
+		{
+			// Past x2 the x distance only grows, so x keeps stepping forever.
+			if (xi > x2)
+				return rasterUnbounded;
+			xi++;
+		}
+		else
+		{
+			// A zero step divides by zero, and past y2 with x still behind the loop never ends.
+			if (dy == 0 || (yi > y2 && xi < x2))
+				return rasterUnbounded;
+			yi++;
+		}
+		count++;
+	}
+	return count;
+}
+
+/**
+ * The function returns the number of points midPointCircleDraw emits for the same parameters. The
+ * decision variable is replayed without storing any point.
+ * 
+ * @param x_centre The x-coordinate of the center of the circle (it does not affect the count).
+ * @param y_centre The y-coordinate of the center of the circle (it does not affect the count).
+ * @param r The radius of the circle.
+ * 
+ * @return the exact size of the vector returned by midPointCircleDraw.
+ */
+constexpr size_t MathOGL::countMidPointCircle(double /* x_centre */, double /* y_centre */, double r)
+{
+	int x = static_cast<int>(r), y = 0;
+	int P = static_cast<int>(1 - r);
+	size_t count = (r > 0) ? 2 : 1;
+
+	while (x > y)
+	{
+		y++;
+		if (P <= 0)
+			P = P + 2 * y + 1;
+		else
+		{
+			x--;
+			P = P + 2 * y - 2 * x + 1;
+		}
+
+		if (x < y)
+			break;
+
+		count += (x != y) ? 2 : 1;
+	}
+	return count;
+}
+
+/**
+ * The function returns the number of points BresenhamCircle emits after removing duplicates. Only
+ * the points on the axes (x = 0) and on the diagonals (x = y) are repeated among the eight
+ * reflections of a step, so each step contributes 1, 4 or 8 unique points.
+ * 
+ * @param x_center The x-coordinate of the center of the circle (it does not affect the count).
+ * @param y_center The y-coordinate of the center of the circle (it does not affect the count).
+ * @param r The radius of the circle.
+ * 
+ * @return the exact size of the vector returned by BresenhamCircle.
+ */
+constexpr size_t MathOGL::countBresenhamCircle(double /* x_center */, double /* y_center */, double r)
+{
+	int x = 0;
+	int y = static_cast<int>(r);
+	int d = 3 - 2 * y;
+	size_t count = 0;
+
+	while (y >= x)
+	{
+		if (x == 0 && y == 0)
+			count += 1;
+		else if (x == 0 || x == y)
+			count += 4;
+		else
+			count += 8;
+
+		x++;
+		if (d > 0)
+		{
+			y--;
+			d = d + 4 * (x - y) + 10;
+		}
+		else
+			d = d + 4 * x + 6;
+	}
+	return count;
+}
+
+/**
+ * The function returns the number of points drawLineOctant emits for the same parameters, one per
+ * unit of the major axis.
+ * 
+ * @param x1 The x-coordinate of the starting point of the line.
+ * @param y1 The y-coordinate of the starting point of the line.
+ * @param x2 The x-coordinate of the end point of the line.
+ * @param y2 The y-coordinate of the end point of the line.
+ * 
+ * @return the exact size of the vector returned by drawLineOctant.
+ */
+constexpr size_t MathOGL::countLineOctant(double x1, double y1, double x2, double y2)
+{
+	int dx = static_cast<int>(x2) - static_cast<int>(x1);
+	int dy = static_cast<int>(y2) - static_cast<int>(y1);
+	dx = dx < 0 ? -dx : dx;
+	dy = dy < 0 ? -dy : dy;
+	return static_cast<size_t>(dx > dy ? dx : dy) + 1;
+}
+
+/**
+ * The function returns the number of points BresenhamCircle pushes before removing duplicates, that
+ * is, eight points per step of the decision loop.
+ * 
+ * @param r The radius of the circle.
+ * 
+ * @return the number of points generated by BresenhamCirclePoints for the whole circle.
+ */
+constexpr size_t MathOGL::countBresenhamCircleSteps(double r)
+{
+	int x = 0;
+	int y = static_cast<int>(r);
+	int d = 3 - 2 * y;
+	size_t steps = 0;
+
+	while (y >= x)
+	{
+		steps++;
+		x++;
+		if (d > 0)
+		{
+			y--;
+			d = d + 4 * (x - y) + 10;
+		}
+		else
+			d = d + 4 * x + 6;
+	}
+	return steps * 8;
+}
+
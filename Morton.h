@@ -0,0 +1,61 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * Morton (Z-order) codes of 2D integer coordinates: the bits of x and y interleaved, x in the even
+ * bits. Sorting by Morton code keeps pixels that are close on the screen close in memory, and every
+ * aligned power-of-two square is a contiguous range of codes.
+ */
+struct Morton
+{
+	/**
+	 * The function spreads the 32 bits of v over the even bits of a 64-bit word.
+	 *
+	 * @param v The value to spread.
+	 *
+	 * @return v with a zero bit inserted above each of its bits.
+	 */
+	static uint64_t spread(uint32_t v)
+	{
+		uint64_t x = v;
+		x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+		x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+		x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+		x = (x | (x << 2)) & 0x3333333333333333ull;
+		x = (x | (x << 1)) & 0x5555555555555555ull;
+		return x;
+	}
+
+	/**
+	 * The function gathers the even bits of a 64-bit word, the inverse of spread.
+	 *
+	 * @param v The word to gather.
+	 *
+	 * @return the 32 even bits of v.
+	 */
+	static uint32_t compact(uint64_t v)
+	{
+		uint64_t x = v & 0x5555555555555555ull;
+		x = (x | (x >> 1)) & 0x3333333333333333ull;
+		x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+		x = (x | (x >> 4)) & 0x00FF00FF00FF00FFull;
+		x = (x | (x >> 8)) & 0x0000FFFF0000FFFFull;
+		x = (x | (x >> 16)) & 0x00000000FFFFFFFFull;
+		return (uint32_t)x;
+	}
+
+	static uint64_t encode(uint32_t x, uint32_t y) { return spread(x) | (spread(y) << 1); }
+	static uint32_t decodeX(uint64_t code) { return compact(code); }
+	static uint32_t decodeY(uint64_t code) { return compact(code >> 1); }
+
+	/**
+	 * The function maps a signed coordinate to an unsigned one keeping its order, so negative pixels
+	 * can be Morton coded too.
+	 *
+	 * @param v The signed coordinate.
+	 *
+	 * @return v with its sign bit flipped.
+	 */
+	static uint32_t toUnsigned(int32_t v) { return (uint32_t)v ^ 0x80000000u; }
+	static int32_t toSigned(uint32_t v) { return (int32_t)(v ^ 0x80000000u); }
+};
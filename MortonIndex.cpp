@@ -0,0 +1,333 @@
+#include "MortonIndex.h"
+
+#include <math.h>
+#include <algorithm>
+#include <thread>
+
+/**
+ * The MortonIndex constructor creates an empty index.
+ */
+MortonIndex::MortonIndex() : originX(0), originY(0)
+{
+}
+
+/**
+ * This function sorts a copy of the pixels in Morton order and keeps their codes for queries.
+ * 
+ * @param pixels The pixels to index, in any order.
+ * @param threadCount The number of threads the sort may use.
+ */
+void MortonIndex::build(const std::vector<glm::vec3>& pixels, unsigned int threadCount)
+{
+	originX = originY = UINT32_MAX;
+	for (size_t i = 0; i < pixels.size(); i++)
+	{
+		originX = std::min(originX, column(pixels[i].x));
+		originY = std::min(originY, column(pixels[i].y));
+	}
+
+	std::vector<uint64_t> unsorted(pixels.size());
+	for (size_t i = 0; i < pixels.size(); i++)
+	{
+		unsorted[i] = keyOf(pixels[i]);
+	}
+
+	std::vector<uint32_t> order;
+	radixSort(unsorted, order, threadCount);
+
+	keys.swap(unsorted);
+	this->pixels.resize(pixels.size());
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		this->pixels[i] = pixels[order[i]];
+	}
+}
+
+/**
+ * This function reorders a pixel buffer in Morton order. Pixels with the same code keep their
+ * relative order.
+ * 
+ * @param pixels The pixels to reorder.
+ * @param threadCount The number of threads the sort may use.
+ */
+void MortonIndex::sortPixels(std::vector<glm::vec3>& pixels, unsigned int threadCount)
+{
+	MortonIndex index;
+	index.build(pixels, threadCount);
+	pixels.swap(index.pixels);
+}
+
+/**
+ * This function tells whether a pixel is in the index, with a binary search on the codes.
+ * 
+ * @param x The x-coordinate of the pixel.
+ * @param y The y-coordinate of the pixel.
+ * 
+ * @return true if the pixel is in the index.
+ */
+bool MortonIndex::contains(int x, int y) const
+{
+	uint32_t ux = Morton::toUnsigned(x), uy = Morton::toUnsigned(y);
+	if (ux < originX || uy < originY)
+		return false;
+
+	return std::binary_search(keys.begin(), keys.end(), Morton::encode(ux - originX, uy - originY));
+}
+
+/**
+ * This function appends the pixels inside a rectangle to a vector, in Morton order.
+ * 
+ * @param xMin The smallest x-coordinate of the rectangle.
+ * @param yMin The smallest y-coordinate of the rectangle.
+ * @param xMax The largest x-coordinate of the rectangle, included.
+ * @param yMax The largest y-coordinate of the rectangle, included.
+ * @param out The vector the pixels are appended to.
+ * 
+ * @return the number of pixels appended.
+ */
+size_t MortonIndex::queryRange(int xMin, int yMin, int xMax, int yMax, std::vector<glm::vec3>& out) const
+{
+	const std::vector<glm::vec3>& sorted = pixels;
+	return visitRange(xMin, yMin, xMax, yMax, [&out, &sorted](size_t i) {
+		out.push_back(sorted[i]);
+	});
+}
+
+/**
+ * This function counts the pixels inside a rectangle, such as the neighbours of a pixel.
+ * 
+ * @param xMin The smallest x-coordinate of the rectangle.
+ * @param yMin The smallest y-coordinate of the rectangle.
+ * @param xMax The largest x-coordinate of the rectangle, included.
+ * @param yMax The largest y-coordinate of the rectangle, included.
+ * 
+ * @return the number of pixels inside the rectangle.
+ */
+size_t MortonIndex::countRange(int xMin, int yMin, int xMax, int yMax) const
+{
+	return visitRange(xMin, yMin, xMax, yMax, [](size_t) {});
+}
+
+/**
+ * This function returns the code the index gives to the pixel holding a point, which must not be
+ * below or to the left of the indexed pixels.
+ * 
+ * @param pixel The point.
+ * 
+ * @return the Morton code of the pixel, relative to the corner of the index.
+ */
+uint64_t MortonIndex::keyOf(const glm::vec3& pixel) const
+{
+	return Morton::encode(column(pixel.x) - originX, column(pixel.y) - originY);
+}
+
+/**
+ * This function rounds a coordinate to the nearest pixel and maps it to the unsigned range, keeping
+ * its order.
+ * 
+ * @param coordinate The coordinate.
+ * 
+ * @return the unsigned pixel coordinate.
+ */
+uint32_t MortonIndex::column(float coordinate)
+{
+	return Morton::toUnsigned((int)floor(coordinate + 0.5f));
+}
+
+/**
+ * This function calls visit with the position in the buffer of every pixel inside a rectangle. The
+ * codes between those of the corners are scanned in order, and on reaching a code outside the
+ * rectangle the scan jumps to the next code that is inside it.
+ * 
+ * @param xMin The smallest x-coordinate of the rectangle.
+ * @param yMin The smallest y-coordinate of the rectangle.
+ * @param xMax The largest x-coordinate of the rectangle, included.
+ * @param yMax The largest y-coordinate of the rectangle, included.
+ * @param visit The function to call with the index of each pixel found.
+ * 
+ * @return the number of pixels found.
+ */
+template <typename Visitor>
+size_t MortonIndex::visitRange(int xMin, int yMin, int xMax, int yMax, Visitor visit) const
+{
+	uint32_t left = Morton::toUnsigned(xMin), right = Morton::toUnsigned(xMax);
+	uint32_t bottom = Morton::toUnsigned(yMin), top = Morton::toUnsigned(yMax);
+	if (left > right || bottom > top || right < originX || top < originY)
+		return 0;
+
+	left = std::max(left, originX) - originX;
+	bottom = std::max(bottom, originY) - originY;
+	right -= originX;
+	top -= originY;
+	uint64_t minCode = Morton::encode(left, bottom);
+	uint64_t maxCode = Morton::encode(right, top);
+
+	size_t found = 0;
+	std::vector<uint64_t>::const_iterator it = std::lower_bound(keys.begin(), keys.end(), minCode);
+	while (it != keys.end() && *it <= maxCode)
+	{
+		uint32_t x = Morton::decodeX(*it), y = Morton::decodeY(*it);
+		if (x >= left && x <= right && y >= bottom && y <= top)
+		{
+			visit(it - keys.begin());
+			found++;
+			++it;
+		}
+		else
+		{
+			it = std::lower_bound(it, keys.end(), nextInRange(*it, minCode, maxCode));
+		}
+	}
+	return found;
+}
+
+/**
+ * This function sorts Morton codes with an LSD radix sort of 8 bits per pass. Passes over bytes that
+ * are the same in every code are skipped, so pixels of a small area only need a few passes. Each pass
+ * splits the codes among threads that count their digits, take their offsets from the counts of all
+ * the threads and scatter their codes, which keeps the sort stable.
+ * 
+ * @param keys The codes to sort, sorted in place.
+ * @param order Receives, for each sorted code, its position before sorting.
+ * @param threadCount The number of threads to use.
+ */
+void MortonIndex::radixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& order, unsigned int threadCount)
+{
+	size_t n = keys.size();
+	order.resize(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		order[i] = (uint32_t)i;
+	}
+	if (n < 2)
+		return;
+
+	uint64_t differing = 0;
+	for (size_t i = 1; i < n; i++)
+	{
+		differing |= keys[i] ^ keys[0];
+	}
+
+	threadCount = (unsigned int)std::max<size_t>(1, std::min<size_t>(threadCount, n / pixelsPerThread));
+	size_t perThread = (n + threadCount - 1) / threadCount;
+	std::vector<uint64_t> keysOut(n);
+	std::vector<uint32_t> orderOut(n);
+	std::vector<size_t> counts(threadCount * 256);
+
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		if (((differing >> shift) & 0xFF) == 0)
+			continue;
+
+		auto countDigits = [&](unsigned int t) {
+			size_t* count = &counts[t * 256];
+			std::fill(count, count + 256, 0);
+			size_t end = std::min(n, (t + 1) * perThread);
+			for (size_t i = t * perThread; i < end; i++)
+			{
+				count[(keys[i] >> shift) & 0xFF]++;
+			}
+		};
+		auto scatter = [&](unsigned int t) {
+			size_t* offset = &counts[t * 256];
+			size_t end = std::min(n, (t + 1) * perThread);
+			for (size_t i = t * perThread; i < end; i++)
+			{
+				size_t to = offset[(keys[i] >> shift) & 0xFF]++;
+				keysOut[to] = keys[i];
+				orderOut[to] = order[i];
+			}
+		};
+
+		std::vector<std::thread> workers;
+		for (unsigned int t = 1; t < threadCount; t++)
+		{
+			workers.push_back(std::thread(countDigits, t));
+		}
+		countDigits(0);
+		for (size_t t = 0; t < workers.size(); t++)
+		{
+			workers[t].join();
+		}
+
+		// Digit-major, thread-minor prefix sum: thread t writes its digit d after every smaller digit
+		// and after the same digit of the threads before it.
+		size_t total = 0;
+		for (int digit = 0; digit < 256; digit++)
+		{
+			for (unsigned int t = 0; t < threadCount; t++)
+			{
+				size_t count = counts[t * 256 + digit];
+				counts[t * 256 + digit] = total;
+				total += count;
+			}
+		}
+
+		workers.clear();
+		for (unsigned int t = 1; t < threadCount; t++)
+		{
+			workers.push_back(std::thread(scatter, t));
+		}
+		scatter(0);
+		for (size_t t = 0; t < workers.size(); t++)
+		{
+			workers[t].join();
+		}
+
+		keys.swap(keysOut);
+		order.swap(orderOut);
+	}
+}
+
+/**
+ * This function returns the smallest Morton code greater than code that lies inside the rectangle
+ * with corner codes minCode and maxCode (the BIGMIN of Tropf and Herzog). code must be between the
+ * corner codes and outside the rectangle.
+ * 
+ * @param code A code outside the rectangle.
+ * @param minCode The code of the lower left corner.
+ * @param maxCode The code of the upper right corner.
+ * 
+ * @return the next code inside the rectangle.
+ */
+uint64_t MortonIndex::nextInRange(uint64_t code, uint64_t minCode, uint64_t maxCode)
+{
+	uint64_t next = maxCode;
+	for (int bit = 63; bit >= 0; bit--)
+	{
+		uint64_t mask = (uint64_t)1 << bit;
+		// Lower bits of the same coordinate as this bit.
+		uint64_t lower = (bit % 2 == 0 ? 0x5555555555555555ull : 0xAAAAAAAAAAAAAAAAull) & (mask - 1);
+		int pattern = ((code & mask) ? 4 : 0) | ((minCode & mask) ? 2 : 0) | ((maxCode & mask) ? 1 : 0);
+
+		switch (pattern)
+		{
+		case 1:
+			// code 0, min 0, max 1: the answer is either above this bit, starting at min with it set,
+			// or below it, with max cleared from it down.
+			next = (minCode & ~lower) | mask;
+			maxCode = (maxCode & ~mask) | lower;
+			break;
+		case 3:
+			// code 0, min 1, max 1: min is greater than code.
+			return minCode;
+		case 4:
+			// code 1, min 0, max 0: everything below max is smaller than code.
+			return next;
+		case 5:
+			// code 1, min 0, max 1: the answer has this bit set.
+			minCode = (minCode & ~lower) | mask;
+			break;
+		default:
+			break;
+		}
+	}
+	return next;
+}
+
+/**
+ * This is a destructor for the MortonIndex class.
+ */
+MortonIndex::~MortonIndex()
+{
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include <glm.hpp>
+
+#include "Morton.h"
+
+/**
+ * Pixel buffer sorted in Morton (Z) order, with the Morton code of every pixel kept next to it. Codes
+ * are taken from the lower left corner of the bounding box of the pixels, so they are as short as
+ * the box allows. The sort is an LSD radix sort on the codes that only runs the passes over bytes
+ * that differ between pixels, split among threads for large buffers. Pixels that are close on the screen end up close in
+ * the buffer, and a rectangle of pixels is found by jumping between the runs of codes inside it.
+ */
+class MortonIndex
+{
+public:
+	MortonIndex();
+
+	void build(const std::vector<glm::vec3>& pixels, unsigned int threadCount);
+	static void sortPixels(std::vector<glm::vec3>& pixels, unsigned int threadCount);
+
+	bool contains(int x, int y) const;
+	size_t queryRange(int xMin, int yMin, int xMax, int yMax, std::vector<glm::vec3>& out) const;
+	size_t countRange(int xMin, int yMin, int xMax, int yMax) const;
+
+	const std::vector<glm::vec3>& getPixels() const { return pixels; }
+	const std::vector<uint64_t>& getKeys() const { return keys; }
+
+	uint64_t keyOf(const glm::vec3& pixel) const;
+
+	~MortonIndex();
+
+private:
+	// Inputs below this size are sorted on one thread.
+	enum { pixelsPerThread = 1 << 16 };
+
+	// Unsigned coordinates of the corner the codes are taken from.
+	uint32_t originX, originY;
+	std::vector<uint64_t> keys;
+	std::vector<glm::vec3> pixels;
+
+	static uint32_t column(float coordinate);
+	template <typename Visitor>
+	size_t visitRange(int xMin, int yMin, int xMax, int yMax, Visitor visit) const;
+	static void radixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& order, unsigned int threadCount);
+	static uint64_t nextInRange(uint64_t code, uint64_t minCode, uint64_t maxCode);
+};
@@ -0,0 +1,498 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include <glm.hpp>
+
+#include "MathOGL.h"
+
+/**
+ * Pixel sources produce the pixels of one primitive on demand instead of returning them in a vector.
+ * Every source keeps only the state of its walk, so its memory does not depend on the size of the
+ * primitive, and exposes a single function:
+ *
+ *     bool next(glm::vec3& pixel);
+ *
+ * which writes the next pixel and returns true, or returns false once the primitive is finished.
+ * Each source gives the same pixels as the MathOGL function it is named after, in the same order.
+ * Sources can be wrapped in ClippedPixels and TransformedPixels, walked with range-for through
+ * pixelRange, or pulled in chunks with pullPixels.
+ */
+
+/**
+ * Pixels of MathOGL::drawLineBasic.
+ */
+class LineBasicPixels
+{
+public:
+	LineBasicPixels(double x1, double y1, double x2, double y2)
+		: x2(x2), m(abs(y2 - y1) / abs(x2 - x1)), yi(y1), i(x1), started(false)
+	{
+	}
+
+	bool next(glm::vec3& pixel)
+	{
+		if (started)
+		{
+			if (!(i < x2))
+				return false;
+			i = i + 1;
+			yi = roundf(yi + m);
+		}
+		started = true;
+		pixel = glm::vec3(i, yi, 0);
+		return true;
+	}
+
+private:
+	double x2, m, yi;
+	int i;
+	bool started;
+};
+
+/**
+ * Pixels of MathOGL::drawLineBres.
+ */
+class LineBresPixels
+{
+public:
+	LineBresPixels(double x1, double y1, double x2, double y2)
+		: x2(x2), y2(y2), pk(2 * (y2 - y1) - (x2 - x1)), x(x1), y(y1)
+	{
+	}
+
+	bool next(glm::vec3& pixel)
+	{
+		if (!(x <= x2))
+			return false;
+
+		pixel = glm::vec3(x, y, 0);
+
+		double dx = x2 - x;
+		double dy = y2 - y;
+		if (pk >= 0)
+		{
+			pk = pk + 2 * dy - 2 * dx;
+			y++;
+		}
+		else
+		{
+			pk = pk + 2 * dy;
+		}
+		x++;
+		return true;
+	}
+
+private:
+	double x2, y2, pk;
+	int x, y;
+};
+
+/**
+ * Pixels of MathOGL::drawLineDDA. Like that function, the walk never ends for lines it cannot reach
+ * the end of (see MathOGL::countLineDDA), so such sources must only be pulled a bounded number of
+ * times.
+ */
+class LineDDAPixels
+{
+public:
+	LineDDAPixels(double x1, double y1, double x2, double y2)
+		: x2(x2), y2(y2), xi(x1), yi(y1), started(false)
+	{
+	}
+
+	bool next(glm::vec3& pixel)
+	{
+		if (started)
+		{
+			if (!(xi < x2 || yi < x2))
+				return false;
+
+			float dy = abs(y2 - yi);
+			float dx = abs(x2 - xi);
+			if (dx > dy)
+			{
+				xi = xi + dx / dx;
+			}
+			else
+			{
+				yi = yi + dy / dy;
+			}
+		}
+		started = true;
+		pixel = glm::vec3(xi, yi, 0);
+		return true;
+	}
+
+private:
+	double x2, y2;
+	int xi, yi;
+	bool started;
+};
+
+/**
+ * Pixels of MathOGL::drawLineOctant, or of MathOGL::drawLineClipped when built with a rectangle.
+ */
+class LineOctantPixels
+{
+public:
+	LineOctantPixels(double x1, double y1, double x2, double y2)
+	{
+		start(MathOGL::lineSpan(x1, y1, x2, y2));
+	}
+
+	LineOctantPixels(double x1, double y1, double x2, double y2, const ClipRect& rect)
+	{
+		MathOGL::LineSpan span;
+		if (!MathOGL::clipLineSpan(x1, y1, x2, y2, rect, span))
+			span.count = 0;
+		start(span);
+	}
+
+	explicit LineOctantPixels(const MathOGL::LineSpan& span)
+	{
+		start(span);
+	}
+
+	bool next(glm::vec3& pixel)
+	{
+		if (span.count <= 0)
+			return false;
+
+		pixel = glm::vec3(span.x, span.y, 0);
+
+		// 1 when the minor axis advances on this step, 0 otherwise.
+		int minor = span.err > 0;
+		span.err += minor ? stepBoth : stepMinor;
+		if (span.xMajor)
+		{
+			span.x += span.stepX;
+			span.y += span.stepY * minor;
+		}
+		else
+		{
+			span.y += span.stepY;
+			span.x += span.stepX * minor;
+		}
+		span.count--;
+		return true;
+	}
+
+	// Pixels left to produce.
+	int remaining() const { return span.count; }
+
+private:
+	MathOGL::LineSpan span;
+	int stepMinor, stepBoth;
+
+	void start(const MathOGL::LineSpan& first)
+	{
+		span = first;
+		stepMinor = 2 * span.dMinor;
+		stepBoth = 2 * span.dMinor - 2 * span.dMajor;
+	}
+};
+
+/**
+ * Pixels of MathOGL::midPointCircleDraw. A step of the walk gives up to two pixels, the second one
+ * waits in the source until it is pulled.
+ */
+class MidPointCirclePixels
+{
+public:
+	MidPointCirclePixels(double x_centre, double y_centre, double r)
+		: x_centre(x_centre), y_centre(y_centre), x(r), y(0), P(1 - r), queuedFirst(0), queuedEnd(0)
+	{
+		// When radius is zero only a single point is produced
+		if (r > 0)
+		{
+			queued[queuedEnd++] = glm::vec3((r + x_centre), (y_centre), 0);
+			queued[queuedEnd++] = glm::vec3((x_centre), (r + y_centre), 0);
+		}
+		else
+		{
+			queued[queuedEnd++] = glm::vec3((x_centre), (y_centre), 0);
+		}
+	}
+
+	bool next(glm::vec3& pixel)
+	{
+		if (queuedFirst == queuedEnd)
+		{
+			if (!(x > y))
+				return false;
+
+			y++;
+			if (P <= 0)
+				P = P + 2 * y + 1;
+			else
+			{
+				x--;
+				P = P + 2 * y - 2 * x + 1;
+			}
+
+			// Every perimeter point has been produced, x < y also ends later calls.
+			if (x < y)
+				return false;
+
+			queuedFirst = 0;
+			queuedEnd = 0;
+			queued[queuedEnd++] = glm::vec3((x + x_centre), (y + y_centre), 0);
+			if (x != y)
+			{
+				queued[queuedEnd++] = glm::vec3((y + x_centre), (x + y_centre), 0);
+			}
+		}
+
+		pixel = queued[queuedFirst++];
+		return true;
+	}
+
+private:
+	double x_centre, y_centre;
+	int x, y, P;
+	glm::vec3 queued[2];
+	int queuedFirst, queuedEnd;
+};
+
+/**
+ * Pixels of MathOGL::BresenhamCircle. That function sorts its pixels to remove the ones shared by
+ * two octants, which needs all of them at once. Here each step of the walk leaves out the
+ * reflections that fall on a pixel already produced, so the set of pixels is the same but they come
+ * in walk order instead of sorted.
+ */
+class BresenhamCirclePixels
+{
+public:
+	BresenhamCirclePixels(double x_center, double y_center, double r)
+		: x_center(x_center), y_center(y_center), x(0), y(r), d(3 - 2 * y), queuedFirst(0), queuedEnd(0)
+	{
+	}
+
+	bool next(glm::vec3& pixel)
+	{
+		if (queuedFirst == queuedEnd)
+		{
+			if (!(y >= x))
+				return false;
+
+			queueStep();
+			x++;
+			if (d > 0)
+			{
+				y--;
+				d = d + 4 * (x - y) + 10;
+			}
+			else
+				d = d + 4 * x + 6;
+		}
+
+		pixel = queued[queuedFirst++];
+		return true;
+	}
+
+private:
+	double x_center, y_center;
+	int x, y, d;
+	glm::vec3 queued[8];
+	int queuedFirst, queuedEnd;
+
+	// Same order as MathOGL::BresenhamCirclePoints. With x == 0 the reflections over the y axis
+	// repeat, with y == 0 the ones over the x axis, and with x == y the swapped half repeats.
+	void queueStep()
+	{
+		queuedFirst = 0;
+		queuedEnd = 0;
+		queued[queuedEnd++] = glm::vec3(x_center + x, y_center + y, 0);
+		if (x != 0)
+			queued[queuedEnd++] = glm::vec3(x_center - x, y_center + y, 0);
+		if (y != 0)
+			queued[queuedEnd++] = glm::vec3(x_center + x, y_center - y, 0);
+		if (x != 0 && y != 0)
+			queued[queuedEnd++] = glm::vec3(x_center - x, y_center - y, 0);
+		if (x == y)
+			return;
+		queued[queuedEnd++] = glm::vec3(x_center + y, y_center + x, 0);
+		if (y != 0)
+			queued[queuedEnd++] = glm::vec3(x_center - y, y_center + x, 0);
+		if (x != 0)
+			queued[queuedEnd++] = glm::vec3(x_center + y, y_center - x, 0);
+		if (x != 0 && y != 0)
+			queued[queuedEnd++] = glm::vec3(x_center - y, y_center - x, 0);
+	}
+};
+
+/**
+ * Keeps the pixels of a source inside a rectangle. It still walks the hidden pixels, lines that have
+ * a span version (LineOctantPixels with a rectangle) skip them instead.
+ */
+template <typename Source>
+class ClippedPixels
+{
+public:
+	ClippedPixels(const Source& source, const ClipRect& rect) : source(source), rect(rect) {}
+
+	bool next(glm::vec3& pixel)
+	{
+		while (source.next(pixel))
+		{
+			if (pixel.x >= rect.xMin && pixel.x <= rect.xMax && pixel.y >= rect.yMin && pixel.y <= rect.yMax)
+				return true;
+		}
+		return false;
+	}
+
+private:
+	Source source;
+	ClipRect rect;
+};
+
+/**
+ * Applies a transformation to the pixels of a source. Pixels are pulled and transformed in small
+ * chunks so the batched MathOGL::transformPoints is used without storing the whole primitive.
+ */
+template <typename Source>
+class TransformedPixels
+{
+public:
+	TransformedPixels(const Source& source, const glm::mat4& transform)
+		: source(source), transform(transform), chunkFirst(0), chunkEnd(0)
+	{
+	}
+
+	bool next(glm::vec3& pixel)
+	{
+		if (chunkFirst == chunkEnd)
+		{
+			chunkFirst = 0;
+			chunkEnd = 0;
+			while (chunkEnd < chunkSize && source.next(chunk[chunkEnd]))
+				chunkEnd++;
+			if (chunkEnd == 0)
+				return false;
+			mathGL.transformPoints(transform, chunk, chunkEnd);
+		}
+
+		pixel = chunk[chunkFirst++];
+		return true;
+	}
+
+private:
+	enum { chunkSize = 64 };
+
+	Source source;
+	glm::mat4 transform;
+	MathOGL mathGL;
+	glm::vec3 chunk[chunkSize];
+	size_t chunkFirst, chunkEnd;
+};
+
+template <typename Source>
+ClippedPixels<Source> clipPixels(const Source& source, const ClipRect& rect)
+{
+	return ClippedPixels<Source>(source, rect);
+}
+
+template <typename Source>
+TransformedPixels<Source> transformPixels(const Source& source, const glm::mat4& transform)
+{
+	return TransformedPixels<Source>(source, transform);
+}
+
+/**
+ * The function pulls up to capacity pixels of a source into out, for consumers that work on chunks
+ * such as a buffer upload.
+ *
+ * @param source The source to pull from.
+ * @param out Destination buffer with room for capacity points.
+ * @param capacity The most pixels to pull.
+ *
+ * @return the number of pixels written, less than capacity only when the source is finished.
+ */
+template <typename Source>
+size_t pullPixels(Source& source, glm::vec3* out, size_t capacity)
+{
+	size_t count = 0;
+	while (count < capacity && source.next(out[count]))
+		count++;
+	return count;
+}
+
+/**
+ * The function appends every pixel left in a source to a vector.
+ *
+ * @param source The source to drain.
+ * @param points The vector the pixels are appended to.
+ *
+ * @return the number of pixels appended.
+ */
+template <typename Source>
+size_t appendPixels(Source& source, std::vector<glm::vec3>& points)
+{
+	size_t count = 0;
+	glm::vec3 pixel;
+	while (source.next(pixel))
+	{
+		points.push_back(pixel);
+		count++;
+	}
+	return count;
+}
+
+/**
+ * Input iterator over a source, so pixels can be walked with range-for:
+ *
+ *     for (const glm::vec3& pixel : pixelRange(BresenhamCirclePixels(0, 0, r)))
+ */
+template <typename Source>
+class PixelIterator
+{
+public:
+	typedef std::input_iterator_tag iterator_category;
+	typedef glm::vec3 value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const glm::vec3* pointer;
+	typedef const glm::vec3& reference;
+
+	// The end iterator.
+	PixelIterator() : source(NULL) {}
+
+	explicit PixelIterator(Source* source) : source(source) { advance(); }
+
+	reference operator*() const { return pixel; }
+	pointer operator->() const { return &pixel; }
+	PixelIterator& operator++() { advance(); return *this; }
+	bool operator==(const PixelIterator& other) const { return source == other.source; }
+	bool operator!=(const PixelIterator& other) const { return source != other.source; }
+
+private:
+	Source* source;
+	glm::vec3 pixel;
+
+	void advance()
+	{
+		if (source != NULL && !source->next(pixel))
+			source = NULL;
+	}
+};
+
+template <typename Source>
+class PixelRange
+{
+public:
+	explicit PixelRange(const Source& source) : source(source) {}
+
+	PixelIterator<Source> begin() { return PixelIterator<Source>(&source); }
+	PixelIterator<Source> end() { return PixelIterator<Source>(); }
+
+private:
+	Source source;
+};
+
+template <typename Source>
+PixelRange<Source> pixelRange(const Source& source)
+{
+	return PixelRange<Source>(source);
+}
@@ -0,0 +1,246 @@
+#include "PixelSet.h"
+
+#include <math.h>
+#include <string.h>
+
+/**
+ * The PixelSet constructor creates an empty set.
+ */
+PixelSet::PixelSet()
+{
+	count = 0;
+	lastKey = 0;
+	lastTile = UINT32_MAX;
+}
+
+/**
+ * This function adds a pixel to the set.
+ * 
+ * @param x The x-coordinate of the pixel.
+ * @param y The y-coordinate of the pixel.
+ * 
+ * @return true if the pixel was not in the set yet.
+ */
+bool PixelSet::insert(int x, int y)
+{
+	Tile& tile = tileFor(tileKey(x, y));
+	unsigned int bit = bitOf(x, y);
+	uint64_t mask = (uint64_t)1 << (bit % 64);
+	if (tile.words[bit / 64] & mask)
+		return false;
+
+	tile.words[bit / 64] |= mask;
+	count++;
+	return true;
+}
+
+/**
+ * This function adds the pixel holding a point, the point rounded to the nearest integer coordinates.
+ * 
+ * @param pixel The point, as given by the rasterizers of MathOGL.
+ * 
+ * @return true if the pixel was not in the set yet.
+ */
+bool PixelSet::insert(const glm::vec3& pixel)
+{
+	return insert((int)floor(pixel.x + 0.5f), (int)floor(pixel.y + 0.5f));
+}
+
+/**
+ * This function tells whether a pixel is in the set.
+ * 
+ * @param x The x-coordinate of the pixel.
+ * @param y The y-coordinate of the pixel.
+ * 
+ * @return true if the pixel is in the set.
+ */
+bool PixelSet::contains(int x, int y) const
+{
+	std::unordered_map<uint64_t, uint32_t>::const_iterator found = index.find(tileKey(x, y));
+	if (found == index.end())
+		return false;
+
+	unsigned int bit = bitOf(x, y);
+	return (tiles[found->second].words[bit / 64] >> (bit % 64)) & 1;
+}
+
+/**
+ * This function adds every pixel of another set to this one.
+ * 
+ * @param other The set to add.
+ */
+void PixelSet::merge(const PixelSet& other)
+{
+	for (size_t t = 0; t < other.tiles.size(); t++)
+	{
+		count += mergeTile(other.tiles[t]);
+	}
+}
+
+/**
+ * This function merges sets filled by different threads into one. The tiles are split among the
+ * threads by their key, so each thread merges its own tiles of every set into a partial set without
+ * locks, and the partial sets hold different tiles and are joined by moving them.
+ * 
+ * @param sets The sets to merge.
+ * @param out Receives the union of the sets.
+ * @param threadCount The number of threads to use.
+ */
+void PixelSet::mergeParallel(const std::vector<PixelSet>& sets, PixelSet& out, unsigned int threadCount)
+{
+	threadCount = std::max(1u, threadCount);
+	std::vector<PixelSet> partial(threadCount);
+
+	auto mergeShare = [&sets, &partial, threadCount](unsigned int share) {
+		for (size_t s = 0; s < sets.size(); s++)
+		{
+			for (size_t t = 0; t < sets[s].tiles.size(); t++)
+			{
+				const Tile& tile = sets[s].tiles[t];
+				// Mix the key so neighbouring tiles go to different threads.
+				if ((tile.key * 0x9E3779B97F4A7C15ull >> 32) % threadCount == share)
+				{
+					partial[share].count += partial[share].mergeTile(tile);
+				}
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (unsigned int t = 1; t < threadCount; t++)
+	{
+		workers.push_back(std::thread(mergeShare, t));
+	}
+	mergeShare(0);
+	for (size_t t = 0; t < workers.size(); t++)
+	{
+		workers[t].join();
+	}
+
+	out.clear();
+	for (unsigned int t = 0; t < threadCount; t++)
+	{
+		for (size_t i = 0; i < partial[t].tiles.size(); i++)
+		{
+			out.index[partial[t].tiles[i].key] = out.tiles.size();
+			out.tiles.push_back(partial[t].tiles[i]);
+		}
+		out.count += partial[t].count;
+	}
+}
+
+/**
+ * This function removes every pixel from the set.
+ */
+void PixelSet::clear()
+{
+	tiles.clear();
+	index.clear();
+	count = 0;
+	lastTile = UINT32_MAX;
+}
+
+/**
+ * This function appends the pixels of the set to a vector in Morton order, ready to be uploaded.
+ * 
+ * @param points The vector the pixels are appended to.
+ */
+void PixelSet::appendPoints(std::vector<glm::vec3>& points) const
+{
+	points.reserve(points.size() + count);
+	forEach([&points](int x, int y) {
+		points.push_back(glm::vec3(x, y, 0));
+	});
+}
+
+/**
+ * This function returns the memory held by the set.
+ * 
+ * @return the bytes of the tiles and an estimate of the hash map.
+ */
+size_t PixelSet::getBytes() const
+{
+	return tiles.capacity() * sizeof(Tile) + index.size() * (sizeof(uint64_t) + sizeof(uint32_t) + 2 * sizeof(void*)) +
+		index.bucket_count() * sizeof(void*);
+}
+
+/**
+ * This function returns the tile at a key, creating an empty one if the set has none there.
+ * 
+ * @param key The key of the tile, see tileKey.
+ * 
+ * @return the tile.
+ */
+PixelSet::Tile& PixelSet::tileFor(uint64_t key)
+{
+	if (lastTile != UINT32_MAX && lastKey == key)
+		return tiles[lastTile];
+
+	std::unordered_map<uint64_t, uint32_t>::iterator found = index.find(key);
+	if (found == index.end())
+	{
+		Tile tile;
+		tile.key = key;
+		memset(tile.words, 0, sizeof(tile.words));
+		found = index.insert(std::make_pair(key, (uint32_t)tiles.size())).first;
+		tiles.push_back(tile);
+	}
+
+	lastKey = key;
+	lastTile = found->second;
+	return tiles[lastTile];
+}
+
+/**
+ * This function adds the pixels of a tile to the tile with the same key.
+ * 
+ * @param tile The tile to add.
+ * 
+ * @return the number of pixels that were not in the set yet.
+ */
+size_t PixelSet::mergeTile(const Tile& tile)
+{
+	Tile& target = tileFor(tile.key);
+	size_t added = 0;
+	for (int w = 0; w < wordsPerTile; w++)
+	{
+		added += popCount(tile.words[w] & ~target.words[w]);
+		target.words[w] |= tile.words[w];
+	}
+	return added;
+}
+
+/**
+ * This function returns the indices of the tiles sorted by key, which is the Morton order of the
+ * tiles.
+ * 
+ * @return the tile indices in Morton order.
+ */
+std::vector<uint32_t> PixelSet::tilesInOrder() const
+{
+	std::vector<uint32_t> order(tiles.size());
+	for (size_t t = 0; t < tiles.size(); t++)
+	{
+		order[t] = t;
+	}
+	const std::vector<Tile>& sorted = tiles;
+	std::sort(order.begin(), order.end(), [&sorted](uint32_t a, uint32_t b) {
+		return sorted[a].key < sorted[b].key;
+	});
+	return order;
+}
+
+/**
+ * The function counts the bits set in a word.
+ * 
+ * @param v The word.
+ * 
+ * @return the number of bits set.
+ */
+int PixelSet::popCount(uint64_t v)
+{
+	v = v - ((v >> 1) & 0x5555555555555555ull);
+	v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+	v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+	return (int)((v * 0x0101010101010101ull) >> 56);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <algorithm>
+
+#include <glm.hpp>
+
+#include "Morton.h"
+
+/**
+ * Set of integer pixel coordinates stored as a sparse tiled bitmap. Only 64x64 tiles holding at least
+ * one pixel are allocated, one bit per pixel, and a hash map finds the tile of a pixel, so inserting
+ * is O(1) wherever the pixel is. Tiles are keyed by the Morton code of their position and bits inside
+ * a tile are in Morton order too, so pixels are visited in the Morton order of the whole plane.
+ */
+class PixelSet
+{
+public:
+	enum { tileBits = 6, tileSize = 1 << tileBits, wordsPerTile = tileSize * tileSize / 64 };
+
+	PixelSet();
+
+	bool insert(int x, int y);
+	bool insert(const glm::vec3& pixel);
+	bool contains(int x, int y) const;
+	void merge(const PixelSet& other);
+	static void mergeParallel(const std::vector<PixelSet>& sets, PixelSet& out, unsigned int threadCount);
+	void clear();
+
+	template <typename Visitor>
+	void forEach(Visitor visit) const;
+	void appendPoints(std::vector<glm::vec3>& points) const;
+
+	size_t size() const { return count; }
+	size_t getTileCount() const { return tiles.size(); }
+	size_t getBytes() const;
+
+private:
+	struct Tile
+	{
+		uint64_t key;
+		uint64_t words[wordsPerTile];
+	};
+
+	std::vector<Tile> tiles;
+	std::unordered_map<uint64_t, uint32_t> index;
+	size_t count;
+	// Consecutive pixels of a primitive usually fall in the same tile, skip the lookup for them.
+	uint64_t lastKey;
+	uint32_t lastTile;
+
+	Tile& tileFor(uint64_t key);
+	size_t mergeTile(const Tile& tile);
+	std::vector<uint32_t> tilesInOrder() const;
+	static uint64_t tileKey(int x, int y) { return Morton::encode(Morton::toUnsigned(x) >> tileBits, Morton::toUnsigned(y) >> tileBits); }
+	static unsigned int bitOf(int x, int y) { return (unsigned int)Morton::encode(x & (tileSize - 1), y & (tileSize - 1)); }
+	static int popCount(uint64_t v);
+};
+
+/**
+ * The function calls visit(x, y) for every pixel of the set, in Morton order.
+ *
+ * @param visit The function to call, taking the two int coordinates of a pixel.
+ */
+template <typename Visitor>
+void PixelSet::forEach(Visitor visit) const
+{
+	std::vector<uint32_t> order = tilesInOrder();
+	for (size_t t = 0; t < order.size(); t++)
+	{
+		const Tile& tile = tiles[order[t]];
+		uint32_t originX = Morton::decodeX(tile.key) << tileBits;
+		uint32_t originY = Morton::decodeY(tile.key) << tileBits;
+		for (int w = 0; w < wordsPerTile; w++)
+		{
+			for (uint64_t word = tile.words[w]; word != 0; word &= word - 1)
+			{
+				// Index of the lowest set bit.
+				int bit = popCount((word & (~word + 1)) - 1);
+				uint64_t code = (uint64_t)w * 64 + bit;
+				visit(Morton::toSigned(originX | Morton::decodeX(code)), Morton::toSigned(originY | Morton::decodeY(code)));
+			}
+		}
+	}
+}
@@ -0,0 +1,105 @@
+#include "PrimitiveQueue.h"
+
+/**
+ * The PrimitiveQueue constructor allocates the ring of cells.
+ * 
+ * @param capacity The requested number of cells, rounded up to a power of two.
+ */
+PrimitiveQueue::PrimitiveQueue(size_t capacity)
+{
+	size_t size = 2;
+	while (size < capacity) {
+		size *= 2;
+	}
+
+	cells = new Cell[size];
+	mask = size - 1;
+	for (size_t i = 0; i < size; i++) {
+		cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	tail.store(0, std::memory_order_relaxed);
+	head = 0;
+}
+
+/**
+ * This function adds a primitive at the end of the queue. It can be called from any number of threads
+ * at the same time.
+ * 
+ * @param primitive The primitive to enqueue.
+ * 
+ * @return false if the queue is full and the primitive was not added.
+ */
+bool PrimitiveQueue::push(const Primitive& primitive)
+{
+	size_t position = tail.load(std::memory_order_relaxed);
+	Cell* cell;
+
+	while (true)
+	{
+		cell = &cells[position & mask];
+		size_t sequence = cell->sequence.load(std::memory_order_acquire);
+		ptrdiff_t difference = (ptrdiff_t)sequence - (ptrdiff_t)position;
+
+		if (difference == 0)
+		{
+			// The cell is free for this lap, claim it.
+			if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+		{
+			// The consumer has not emptied the cell since the previous lap.
+			return false;
+		}
+		else
+		{
+			position = tail.load(std::memory_order_relaxed);
+		}
+	}
+
+	cell->primitive = primitive;
+	cell->sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+/**
+ * This function takes the primitive at the front of the queue. Only one thread may call it.
+ * 
+ * @param primitive Receives the dequeued primitive.
+ * 
+ * @return false if the queue is empty, or the next producer has not finished writing its cell.
+ */
+bool PrimitiveQueue::pop(Primitive& primitive)
+{
+	Cell* cell = &cells[head & mask];
+	size_t sequence = cell->sequence.load(std::memory_order_acquire);
+
+	if (sequence != head + 1)
+		return false;
+
+	primitive = cell->primitive;
+	// Hand the cell back to the producers for the next lap.
+	cell->sequence.store(head + mask + 1, std::memory_order_release);
+	head++;
+	return true;
+}
+
+/**
+ * This function returns the number of queued primitives. It is only exact while no producer is pushing.
+ * 
+ * @return the approximate number of primitives in the queue.
+ */
+size_t PrimitiveQueue::sizeApprox()
+{
+	size_t position = tail.load(std::memory_order_relaxed);
+	return position > head ? position - head : 0;
+}
+
+/**
+ * The destructor function for the PrimitiveQueue class that frees the cells.
+ */
+PrimitiveQueue::~PrimitiveQueue()
+{
+	delete[] cells;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+
+/**
+ * Description of one primitive waiting to be rasterized. Lines use (x1, y1) and (x2, y2) as end points,
+ * circles use (x1, y1) as center and x2 as radius.
+ */
+struct Primitive
+{
+	enum Kind { LINE, CIRCLE };
+
+	Kind kind;
+	float x1, y1;
+	float x2, y2;
+};
+
+/**
+ * Bounded lock-free queue of primitives with many producer threads and a single consumer. Every cell
+ * carries a sequence number that tells producers when it is free and the consumer when it is full, so
+ * producers only contend on one compare-and-swap of the tail and never on each other's writes.
+ */
+class PrimitiveQueue
+{
+public:
+	PrimitiveQueue(size_t capacity);
+
+	bool push(const Primitive& primitive);
+	bool pop(Primitive& primitive);
+
+	size_t getCapacity() { return mask + 1; }
+	size_t sizeApprox();
+
+	~PrimitiveQueue();
+
+private:
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		Primitive primitive;
+	};
+
+	Cell* cells;
+	size_t mask;
+
+	// Producers and the consumer write different counters, keep them on different cache lines.
+	alignas(64) std::atomic<size_t> tail;
+	alignas(64) size_t head;
+
+	PrimitiveQueue(const PrimitiveQueue&);
+	PrimitiveQueue& operator=(const PrimitiveQueue&);
+};
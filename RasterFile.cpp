@@ -0,0 +1,208 @@
+#include "RasterFile.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/**
+ * The RasterFile constructor creates a closed file.
+ */
+RasterFile::RasterFile()
+{
+	data = NULL;
+	size = 0;
+}
+
+/**
+ * This function writes rasterized pixels to a raster file, replacing it if it exists. The file is
+ * created with its final size and filled through a memory mapping, so the pixels go to the page cache
+ * with a single copy.
+ * 
+ * @param path The path of the file.
+ * @param algorithm The name of the rasterizer, up to 8 characters.
+ * @param parameters The parameters given to the rasterizer, see RasterFileHeader.
+ * @param pixels The pixels to write.
+ * @param pixelCount The number of pixels.
+ * 
+ * @return false if the file could not be created.
+ */
+bool RasterFile::write(const char* path, const char* algorithm, const double parameters[4], const glm::vec3* pixels, size_t pixelCount)
+{
+	RasterFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, "RSTR", 4);
+	header.version = fileVersion;
+	size_t nameLength = strlen(algorithm);
+	memcpy(header.algorithm, algorithm, nameLength < sizeof(header.algorithm) ? nameLength : sizeof(header.algorithm));
+	memcpy(header.parameters, parameters, sizeof(header.parameters));
+	header.pixelCount = pixelCount;
+	header.bytesPerPixel = sizeof(glm::vec3);
+
+	size_t fileSize = sizeof(header) + pixelCount * sizeof(glm::vec3);
+	char* view = mapFile(path, fileSize, true);
+	if (view == NULL)
+	{
+		printf("Error writing raster file '%s'\n", path);
+		return false;
+	}
+
+	memcpy(view, &header, sizeof(header));
+	if (pixelCount > 0)
+	{
+		memcpy(view + sizeof(header), pixels, pixelCount * sizeof(glm::vec3));
+	}
+	unmapFile(view, fileSize);
+	return true;
+}
+
+/**
+ * This function maps a raster file and checks its header. The pixels stay in the mapping, pages are
+ * only read from disk when they are first touched.
+ * 
+ * @param path The path of the file.
+ * 
+ * @return false if the file cannot be mapped or is not a raster file of this version.
+ */
+bool RasterFile::open(const char* path)
+{
+	close();
+
+	size_t fileSize = 0;
+	char* view = mapFile(path, fileSize, false);
+	if (view == NULL)
+	{
+		printf("Error opening raster file '%s'\n", path);
+		return false;
+	}
+
+	const RasterFileHeader* header = (const RasterFileHeader*)view;
+	if (fileSize < sizeof(RasterFileHeader) || memcmp(header->magic, "RSTR", 4) != 0 || header->version != fileVersion ||
+		header->bytesPerPixel != sizeof(glm::vec3) || header->pixelCount > (fileSize - sizeof(RasterFileHeader)) / sizeof(glm::vec3))
+	{
+		printf("Error: '%s' is not a raster file\n", path);
+		unmapFile(view, fileSize);
+		return false;
+	}
+
+	data = view;
+	size = fileSize;
+	return true;
+}
+
+/**
+ * This function unmaps the file. The pointers given by getHeader and getPixels are no longer valid.
+ */
+void RasterFile::close()
+{
+	if (data != NULL)
+	{
+		unmapFile(data, size);
+		data = NULL;
+		size = 0;
+	}
+}
+
+/**
+ * This function maps a whole file into memory. The file handles are closed before returning, the
+ * mapping keeps the file open until it is unmapped.
+ * 
+ * @param path The path of the file.
+ * @param size The size of the file to create, receives the size of the file opened.
+ * @param create Whether to create the file with the given size and map it for writing, rather than
+ * map an existing file for reading.
+ * 
+ * @return the view of the file, NULL on failure or for an empty file.
+ */
+char* RasterFile::mapFile(const char* path, size_t& size, bool create)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, create ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ, NULL,
+		create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return NULL;
+
+	if (!create)
+	{
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return NULL;
+		}
+		size = (size_t)fileSize.QuadPart;
+	}
+
+	// Creating the mapping with the full size also extends a new file to it.
+	unsigned long long mappingSize = size;
+	HANDLE mapping = CreateFileMappingA(file, NULL, create ? PAGE_READWRITE : PAGE_READONLY,
+		(DWORD)(mappingSize >> 32), (DWORD)(mappingSize & 0xFFFFFFFF), NULL);
+	CloseHandle(file);
+	if (mapping == NULL)
+		return NULL;
+
+	void* view = MapViewOfFile(mapping, create ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+	CloseHandle(mapping);
+	return (char*)view;
+#else
+	int descriptor = create ? ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644) : ::open(path, O_RDONLY);
+	if (descriptor < 0)
+		return NULL;
+
+	if (create)
+	{
+		if (ftruncate(descriptor, size) != 0)
+		{
+			::close(descriptor);
+			return NULL;
+		}
+	}
+	else
+	{
+		struct stat status;
+		if (fstat(descriptor, &status) != 0 || status.st_size == 0)
+		{
+			::close(descriptor);
+			return NULL;
+		}
+		size = (size_t)status.st_size;
+	}
+
+	void* view = mmap(NULL, size, create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, descriptor, 0);
+	::close(descriptor);
+	return view == MAP_FAILED ? NULL : (char*)view;
+#endif
+}
+
+/**
+ * This function releases a view given by mapFile. Pages written through it are flushed to the file by
+ * the system.
+ * 
+ * @param view The view of the file.
+ * @param size The size of the view.
+ */
+void RasterFile::unmapFile(const char* view, size_t size)
+{
+#ifdef _WIN32
+	UnmapViewOfFile(view);
+#else
+	munmap((void*)view, size);
+#endif
+}
+
+/**
+ * The destructor function for the RasterFile class that unmaps the file.
+ */
+RasterFile::~RasterFile()
+{
+	close();
+}
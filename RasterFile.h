@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <glm.hpp>
+
+/**
+ * Header at the start of a raster file, followed by pixelCount glm::vec3 pixels exactly as they are
+ * laid out in memory and in the vertex buffer.
+ */
+struct RasterFileHeader
+{
+	char magic[4];
+	uint32_t version;
+	// Name of the rasterizer, such as "MPC" or "BA", padded with zeros.
+	char algorithm[8];
+	// x1, y1, x2, y2 of lines; x, y and radius of circles.
+	double parameters[4];
+	uint64_t pixelCount;
+	uint32_t bytesPerPixel;
+	uint32_t reserved;
+};
+
+/**
+ * Binary file of rasterized pixels, written and read through a memory mapping of the whole file:
+ * mmap on POSIX systems, MapViewOfFile on Windows. An open file gives direct access to its pixels,
+ * which can be handed to the geometry upload without being parsed or copied first.
+ */
+class RasterFile
+{
+public:
+	RasterFile();
+
+	static bool write(const char* path, const char* algorithm, const double parameters[4], const glm::vec3* pixels, size_t pixelCount);
+	bool open(const char* path);
+	void close();
+
+	bool isOpen() const { return data != NULL; }
+	const RasterFileHeader& getHeader() const { return *(const RasterFileHeader*)data; }
+	const glm::vec3* getPixels() const { return (const glm::vec3*)(data + sizeof(RasterFileHeader)); }
+	size_t getPixelCount() const { return (size_t)getHeader().pixelCount; }
+	size_t getFileSize() const { return size; }
+
+	~RasterFile();
+
+private:
+	static const uint32_t fileVersion = 1;
+
+	// The mapped view of the whole file. The file itself is closed once mapped.
+	const char* data;
+	size_t size;
+
+	static char* mapFile(const char* path, size_t& size, bool create);
+	static void unmapFile(const char* view, size_t size);
+
+	RasterFile(const RasterFile&);
+	RasterFile& operator=(const RasterFile&);
+};
@@ -0,0 +1,110 @@
+#include "ReflectedCircle.h"
+
+/**
+ * The ReflectedCircle constructor leaves the circle empty. The octant is set with setOctant and
+ * uploaded on the first render, so it can be rasterized on a thread without a GL context.
+ */
+ReflectedCircle::ReflectedCircle()
+{
+	VAO = 0;
+	VBO = 0;
+	centre = glm::vec3(0.0f, 0.0f, 0.0f);
+	pixelCount = 0;
+	stripCount = 0;
+}
+
+/**
+ * This function sets the pixels of the circle.
+ * 
+ * @param centre The centre of the circle.
+ * @param octant The offsets of the pixels of one octant from the centre, in drawing order, as given by
+ * MathOGL::midPointCircleOctant or MathOGL::BresenhamCircleOctant.
+ */
+void ReflectedCircle::setOctant(glm::vec3 centre, const std::vector<glm::vec3>& octant)
+{
+	this->centre = centre;
+	vertices = octant;
+	pixelCount = octant.size();
+	stripCount = pixelCount;
+
+	// The octant ends next to the diagonal. Unless it ends on it, the strip goes on to the mirror of
+	// its last pixel, which is where the swapped instance ends, so the outline has no gaps.
+	if (!octant.empty() && octant.back().x != octant.back().y)
+	{
+		vertices.push_back(glm::vec3(octant.back().y, octant.back().x, octant.back().z));
+		stripCount++;
+	}
+}
+
+/**
+ * This function sends the octant to the GPU and releases the CPU copy.
+ */
+void ReflectedCircle::upload()
+{
+	glGenVertexArrays(1, &VAO);
+	glBindVertexArray(VAO);
+
+	glGenBuffers(1, &VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * vertices.size(), vertices.empty() ? NULL : &vertices[0].x, GL_STATIC_DRAW);
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+	glEnableVertexAttribArray(0);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	std::vector<glm::vec3>().swap(vertices);
+}
+
+/**
+ * This function draws the 8 reflections of the octant as points and as the outline joining them. The
+ * octant reflection shader must be in use.
+ * 
+ * @param uniformCentre The location of the centre uniform of the shader.
+ */
+void ReflectedCircle::render(GLuint uniformCentre)
+{
+	if (pixelCount == 0)
+		return;
+
+	if (VAO == 0)
+	{
+		upload();
+	}
+
+	glUniform3f(uniformCentre, centre.x, centre.y, centre.z);
+	glBindVertexArray(VAO);
+	glDrawArraysInstanced(GL_POINTS, 0, pixelCount, 8);
+	glDrawArraysInstanced(GL_LINE_STRIP, 0, stripCount, 8);
+	glBindVertexArray(0);
+}
+
+/**
+ * The function deletes the vertex buffer and vertex array of the circle.
+ */
+void ReflectedCircle::clear()
+{
+	if (VBO != 0)
+	{
+		glDeleteBuffers(1, &VBO);
+		VBO = 0;
+	}
+
+	if (VAO != 0)
+	{
+		glDeleteVertexArrays(1, &VAO);
+		VAO = 0;
+	}
+
+	pixelCount = 0;
+	stripCount = 0;
+}
+
+/**
+ * The destructor function for the ReflectedCircle class that clears the circle.
+ */
+ReflectedCircle::~ReflectedCircle()
+{
+	clear();
+}
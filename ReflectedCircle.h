@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+
+#include <GL\glew.h>
+#include <glm.hpp>
+
+/**
+ * Circle drawn from the pixels of a single octant. The octant is uploaded once and drawn with 8
+ * instances, both as points and as a line strip, and Shaders/octant.vert places each instance on a
+ * different reflection of the octant around the centre. The CPU rasterizes and the GPU stores an
+ * eighth of the circle.
+ */
+class ReflectedCircle
+{
+public:
+	ReflectedCircle();
+
+	void setOctant(glm::vec3 centre, const std::vector<glm::vec3>& octant);
+	void render(GLuint uniformCentre);
+	void clear();
+
+	unsigned int getOctantPixelCount() { return pixelCount; }
+	unsigned int getStripVertexCount() { return stripCount; }
+
+	~ReflectedCircle();
+
+private:
+	GLuint VAO, VBO;
+	glm::vec3 centre;
+	// Octant offsets waiting to be uploaded, plus the vertex closing the gap to the next octant.
+	std::vector<glm::vec3> vertices;
+	GLsizei pixelCount, stripCount;
+
+	void upload();
+};
@@ -0,0 +1,156 @@
+#include "SceneArena.h"
+
+/**
+ * The SceneArena constructor sets a default block size of 1 MB. Blocks are allocated lazily.
+ */
+SceneArena::SceneArena()
+{
+	blockSize = 1 << 20;
+	currentBlock = 0;
+}
+
+/**
+ * The SceneArena constructor sets the size of the blocks the arena carves its allocations from.
+ * 
+ * @param bytesPerBlock The size in bytes of each block. Larger requests get a block of their own.
+ */
+SceneArena::SceneArena(size_t bytesPerBlock)
+{
+	blockSize = bytesPerBlock;
+	currentBlock = 0;
+}
+
+/**
+ * The function returns the current position of the arena, to be handed back to rewind().
+ * 
+ * @return a Marker with the current block, its used bytes and the number of live objects.
+ */
+SceneArena::Marker SceneArena::mark()
+{
+	Marker marker;
+	marker.block = currentBlock;
+	marker.used = blocks.empty() ? 0 : blocks[currentBlock].used;
+	marker.destructors = destructors.size();
+	return marker;
+}
+
+/**
+ * The function destroys every object created after the marker, in reverse creation order, and makes
+ * the memory allocated after it available again.
+ * 
+ * @param marker A position previously returned by mark().
+ */
+void SceneArena::rewind(Marker marker)
+{
+	while (destructors.size() > marker.destructors)
+	{
+		Destructor entry = destructors.back();
+		destructors.pop_back();
+		entry.destroy(entry.object);
+	}
+
+	for (size_t i = marker.block + 1; i < blocks.size(); i++)
+	{
+		blocks[i].used = 0;
+	}
+	if (!blocks.empty())
+	{
+		blocks[marker.block].used = marker.used;
+	}
+	currentBlock = marker.block;
+}
+
+/**
+ * The function destroys every object of the arena and rewinds it to the beginning. The blocks are
+ * kept so that the next scene is built without new heap allocations.
+ */
+void SceneArena::reset()
+{
+	Marker start = { 0, 0, 0 };
+	rewind(start);
+}
+
+/**
+ * The function returns how many bytes are currently handed out by the arena.
+ * 
+ * @return the used bytes of all blocks, alignment padding included.
+ */
+size_t SceneArena::getBytesUsed()
+{
+	size_t total = 0;
+	for (size_t i = 0; i < blocks.size(); i++)
+	{
+		total += blocks[i].used;
+	}
+	return total;
+}
+
+/**
+ * The function returns how many bytes the arena holds from the heap.
+ * 
+ * @return the sum of the sizes of all blocks.
+ */
+size_t SceneArena::getBytesReserved()
+{
+	size_t total = 0;
+	for (size_t i = 0; i < blocks.size(); i++)
+	{
+		total += blocks[i].size;
+	}
+	return total;
+}
+
+/**
+ * The function bumps the current block to return aligned memory, moving on to the next block (and
+ * allocating it if needed) when the current one is full.
+ * 
+ * @param size The number of bytes requested.
+ * @param alignment The required alignment, a power of two.
+ * 
+ * @return a pointer to size bytes of uninitialised memory owned by the arena.
+ */
+void* SceneArena::allocate(size_t size, size_t alignment)
+{
+	while (currentBlock < blocks.size())
+	{
+		Block& block = blocks[currentBlock];
+		uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+		size_t offset = ((base + block.used + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+		if (offset + size <= block.size)
+		{
+			block.used = offset + size;
+			return block.data + offset;
+		}
+		if (currentBlock + 1 == blocks.size())
+		{
+			break;
+		}
+		currentBlock++;
+	}
+
+	// Oversized requests get a block of their own.
+	Block block;
+	block.size = (size + alignment > blockSize) ? size + alignment : blockSize;
+	block.data = static_cast<char*>(malloc(block.size));
+	if (block.data == NULL)
+	{
+		throw std::bad_alloc();
+	}
+	block.used = 0;
+	blocks.push_back(block);
+	currentBlock = blocks.size() - 1;
+	return allocate(size, alignment);
+}
+
+/**
+ * The destructor destroys the remaining objects and gives the blocks back to the heap.
+ */
+SceneArena::~SceneArena()
+{
+	reset();
+	for (size_t i = 0; i < blocks.size(); i++)
+	{
+		free(blocks[i].data);
+	}
+	blocks.clear();
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <stdlib.h>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * Bump allocator that owns every geometry object of a scene. Objects are placement-constructed in
+ * large blocks and destroyed together in reverse creation order by reset(), which also releases the
+ * GL objects they hold, so the blocks can be reused by the next scene without touching the heap.
+ * mark() and rewind() scope short-lived allocations such as per-frame vertex staging.
+ */
+class SceneArena
+{
+public:
+	struct Marker
+	{
+		size_t block;
+		size_t used;
+		size_t destructors;
+	};
+
+	SceneArena();
+	SceneArena(size_t bytesPerBlock);
+
+	template <typename T, typename... Args>
+	T* create(Args&&... args);
+	template <typename T>
+	T* allocateArray(size_t count);
+
+	Marker mark();
+	void rewind(Marker marker);
+	void reset();
+
+	size_t getBytesUsed();
+	size_t getBytesReserved();
+	size_t getObjectCount() { return destructors.size(); }
+
+	~SceneArena();
+
+private:
+	struct Block
+	{
+		char* data;
+		size_t size;
+		size_t used;
+	};
+
+	struct Destructor
+	{
+		void (*destroy)(void*);
+		void* object;
+	};
+
+	std::vector<Block> blocks;
+	std::vector<Destructor> destructors;
+	size_t currentBlock;
+	size_t blockSize;
+
+	void* allocate(size_t size, size_t alignment);
+
+	template <typename T>
+	static void destroyObject(void* object) { static_cast<T*>(object)->~T(); }
+
+	SceneArena(const SceneArena&);
+	SceneArena& operator=(const SceneArena&);
+};
+
+/**
+ * The function constructs an object of type T inside the arena. The arena keeps its destructor and
+ * runs it on reset(), so the caller must not delete the returned pointer.
+ * 
+ * @param args The arguments forwarded to the constructor of T.
+ * 
+ * @return a pointer to the new object, valid until the arena is reset or rewound past it.
+ */
+template <typename T, typename... Args>
+T* SceneArena::create(Args&&... args)
+{
+	void* memory = allocate(sizeof(T), alignof(T));
+	T* object = new (memory) T(std::forward<Args>(args)...);
+	Destructor entry = { &SceneArena::destroyObject<T>, object };
+	destructors.push_back(entry);
+	return object;
+}
+
+/**
+ * The function reserves an uninitialised array in the arena, meant for plain data such as CPU-side
+ * vertex and index staging. No destructor is recorded for the elements.
+ * 
+ * @param count The number of elements of type T to reserve.
+ * 
+ * @return a pointer to the first element of the array.
+ */
+template <typename T>
+T* SceneArena::allocateArray(size_t count)
+{
+	return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+}
@@ -0,0 +1,126 @@
+#include "SdfPrimitives.h"
+
+/**
+ * The SdfPrimitives constructor leaves the set empty. Primitives can be added on a thread without a
+ * GL context, they are uploaded on the next render.
+ */
+SdfPrimitives::SdfPrimitives()
+{
+	VAO = 0;
+	VBO = 0;
+	instancesUploaded = 0;
+	instancesReserved = 0;
+}
+
+/**
+ * This function adds a line segment.
+ * 
+ * @param x1 The x-coordinate of the starting point.
+ * @param y1 The y-coordinate of the starting point.
+ * @param x2 The x-coordinate of the end point.
+ * @param y2 The y-coordinate of the end point.
+ */
+void SdfPrimitives::addLine(float x1, float y1, float x2, float y2)
+{
+	Instance instance = { x1, y1, x2, y2, 0.0f, 0.0f };
+	instances.push_back(instance);
+}
+
+/**
+ * This function adds the outline of a circle.
+ * 
+ * @param x The x-coordinate of the centre.
+ * @param y The y-coordinate of the centre.
+ * @param radius The radius of the circle.
+ */
+void SdfPrimitives::addCircle(float x, float y, float radius)
+{
+	Instance instance = { x, y, x, y, radius, 1.0f };
+	instances.push_back(instance);
+}
+
+/**
+ * This function sends the instances added since the previous upload to the GPU. When they no longer
+ * fit, the buffer is reallocated with at least twice its size and sent again whole.
+ */
+void SdfPrimitives::upload()
+{
+	if (VAO == 0)
+	{
+		glGenVertexArrays(1, &VAO);
+		glGenBuffers(1, &VBO);
+
+		glBindVertexArray(VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), 0);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Instance), (const void*)(4 * sizeof(GLfloat)));
+		glEnableVertexAttribArray(0);
+		glEnableVertexAttribArray(1);
+		// One instance per primitive; the 4 corners of its quad come from gl_VertexID.
+		glVertexAttribDivisor(0, 1);
+		glVertexAttribDivisor(1, 1);
+		glBindVertexArray(0);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	if (instances.size() > instancesReserved)
+	{
+		instancesReserved = instances.size() > 2 * instancesReserved ? instances.size() : 2 * instancesReserved;
+		glBufferData(GL_ARRAY_BUFFER, sizeof(Instance) * instancesReserved, NULL, GL_DYNAMIC_DRAW);
+		instancesUploaded = 0;
+	}
+	glBufferSubData(GL_ARRAY_BUFFER, sizeof(Instance) * instancesUploaded, sizeof(Instance) * (instances.size() - instancesUploaded),
+		&instances[instancesUploaded]);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	instancesUploaded = instances.size();
+}
+
+/**
+ * This function draws every primitive as one quad. The distance field shader must be in use, with
+ * its lineWidth and snapPixels uniforms set.
+ */
+void SdfPrimitives::render()
+{
+	if (instances.empty())
+		return;
+
+	if (instancesUploaded < instances.size())
+	{
+		upload();
+	}
+
+	glBindVertexArray(VAO);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, instances.size());
+	glBindVertexArray(0);
+}
+
+/**
+ * The function deletes the instance buffer and vertex array and forgets every primitive.
+ */
+void SdfPrimitives::clear()
+{
+	if (VBO != 0)
+	{
+		glDeleteBuffers(1, &VBO);
+		VBO = 0;
+	}
+
+	if (VAO != 0)
+	{
+		glDeleteVertexArrays(1, &VAO);
+		VAO = 0;
+	}
+
+	instances.clear();
+	instancesUploaded = 0;
+	instancesReserved = 0;
+}
+
+/**
+ * The destructor function for the SdfPrimitives class that clears the primitives.
+ */
+SdfPrimitives::~SdfPrimitives()
+{
+	clear();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+#include <GL\glew.h>
+
+/**
+ * Lines and circles drawn analytically instead of pixel by pixel. Each primitive is one instance of
+ * a quad: Shaders/sdf.vert grows it to the bounds of the primitive and Shaders/sdf.frag shades it
+ * from the distance to the segment or to the circle, optionally snapped to the pixels Bresenham
+ * would light. The GPU stores 24 bytes per primitive, whatever its length or radius.
+ */
+class SdfPrimitives
+{
+public:
+	SdfPrimitives();
+
+	void addLine(float x1, float y1, float x2, float y2);
+	void addCircle(float x, float y, float radius);
+	void render();
+	void clear();
+
+	size_t getPrimitiveCount() { return instances.size(); }
+	size_t getBytes() { return sizeof(Instance) * instances.size(); }
+
+	~SdfPrimitives();
+
+private:
+	// Attribute 0 holds both end points of a line or the centre of a circle twice, attribute 1 its
+	// radius and kind (0 line, 1 circle).
+	struct Instance
+	{
+		GLfloat x1, y1, x2, y2;
+		GLfloat radius, kind;
+	};
+
+	GLuint VAO, VBO;
+	std::vector<Instance> instances;
+	// Instances already on the GPU and room allocated for them, so appends only send the new tail.
+	size_t instancesUploaded, instancesReserved;
+
+	void upload();
+};
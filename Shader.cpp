@@ -39,6 +39,41 @@ void Shader::CreateFromFiles(const char* vertexLocation, const char* fragmentLoc
 	CompileShader(vertexCode, fragmentCode);
 }
 
+/**
+ * This function reads the vertex and fragment shader files and submits them for compilation and
+ * linking without waiting for the result. On drivers with GL_KHR_parallel_shader_compile the work
+ * runs in the background until FinishCompile is called.
+ * 
+ * @param vertexLocation A string representing the file path of the vertex shader source code.
+ * @param fragmentLocation The file path or location of the fragment shader source code file.
+ */
+void Shader::StartFromFiles(const char* vertexLocation, const char* fragmentLocation)
+{
+	std::string vertexString = ReadFile(vertexLocation);
+	std::string fragmentString = ReadFile(fragmentLocation);
+
+	StartCompile(vertexString.c_str(), fragmentString.c_str());
+}
+
+/**
+ * This function tells whether the program submitted by StartFromFiles has finished building, without
+ * blocking.
+ * 
+ * @return true when FinishCompile will not stall. Without GL_KHR_parallel_shader_compile it is
+ * always true, since the driver compiled the program synchronously.
+ */
+bool Shader::IsCompileComplete()
+{
+	if (shaderID == 0 || !GLEW_KHR_parallel_shader_compile)
+	{
+		return true;
+	}
+
+	GLint complete = GL_FALSE;
+	glGetProgramiv(shaderID, GL_COMPLETION_STATUS_KHR, &complete);
+	return complete == GL_TRUE;
+}
+
 /**
  * This function reads the contents of a file located at a given file path and returns it as a string.
  * 
@@ -81,25 +116,74 @@ std::string Shader::ReadFile(const char* fileLocation)
  * will exit the function early if certain conditions are met.
  */
 void Shader::CompileShader(const char* vertexCode, const char* fragmentCode)
+{
+	if (StartCompile(vertexCode, fragmentCode))
+	{
+		FinishCompile();
+	}
+}
+
+/**
+ * This function creates the program, compiles and attaches both shaders and links it, without
+ * querying any status, so the driver is free to do the work asynchronously.
+ * 
+ * @param vertexCode A string containing the source code for the vertex shader.
+ * @param fragmentCode A string containing the source code for the fragment shader.
+ * 
+ * @return false if the program object could not be created.
+ */
+bool Shader::StartCompile(const char* vertexCode, const char* fragmentCode)
 {
 	shaderID = glCreateProgram();
 
 	if (!shaderID)
 	{
 		printf("Error creating shader program!\n");
-		return;
+		return false;
 	}
 
 	AddShader(shaderID, vertexCode, GL_VERTEX_SHADER);
 	AddShader(shaderID, fragmentCode, GL_FRAGMENT_SHADER);
 
+	glLinkProgram(shaderID);
+	return true;
+}
+
+/**
+ * This function waits for the program started by StartCompile, reports compile and link errors,
+ * validates it and sets uniform variables for projection, model, view, ambient colour, and ambient
+ * intensity.
+ */
+void Shader::FinishCompile()
+{
+	if (!shaderID)
+	{
+		return;
+	}
+
 	GLint result = 0;
 	GLchar eLog[1024] = { 0 };
 
-	glLinkProgram(shaderID);
 	glGetProgramiv(shaderID, GL_LINK_STATUS, &result);
 	if (!result)
 	{
+		// Compile errors are only queried now so that compilation can run in parallel.
+		GLuint shaders[2] = { 0, 0 };
+		GLsizei shaderCount = 0;
+		glGetAttachedShaders(shaderID, 2, &shaderCount, shaders);
+		for (GLsizei i = 0; i < shaderCount; i++)
+		{
+			GLint compiled = 0;
+			glGetShaderiv(shaders[i], GL_COMPILE_STATUS, &compiled);
+			if (!compiled)
+			{
+				GLint shaderType = 0;
+				glGetShaderiv(shaders[i], GL_SHADER_TYPE, &shaderType);
+				glGetShaderInfoLog(shaders[i], sizeof(eLog), NULL, eLog);
+				printf("Error compiling the %d shader: '%s'\n", shaderType, eLog);
+			}
+		}
+
 		glGetProgramInfoLog(shaderID, sizeof(eLog), NULL, eLog);
 		printf("Error linking program: '%s'\n", eLog);
 		return;
@@ -119,6 +203,11 @@ void Shader::CompileShader(const char* vertexCode, const char* fragmentCode)
 	uniformView = glGetUniformLocation(shaderID, "view");
 	uniformAmbientColour = glGetUniformLocation(shaderID, "directionalLight.colour");
 	uniformAmbientIntensity = glGetUniformLocation(shaderID, "directionalLight.ambientIntensity");
+	uniformCentre = glGetUniformLocation(shaderID, "centre");
+	uniformLineWidth = glGetUniformLocation(shaderID, "lineWidth");
+	uniformSnapPixels = glGetUniformLocation(shaderID, "snapPixels");
+	uniformGridSpacing = glGetUniformLocation(shaderID, "gridSpacing");
+	uniformFadeDistance = glGetUniformLocation(shaderID, "fadeDistance");
 }
 
 /**
@@ -178,6 +267,61 @@ GLuint Shader::GetAmbientIntensityLocation()
 	return uniformAmbientIntensity;
 }
 
+/**
+ * This function returns the location of the uniform variable holding the centre of the circle drawn
+ * by the octant reflection shader.
+ * 
+ * @return the location of the "centre" uniform, -1 when the program doesn't use it.
+ */
+GLuint Shader::GetCentreLocation()
+{
+	return uniformCentre;
+}
+
+/**
+ * This function returns the location of the uniform variable holding the width of the lines drawn by
+ * the distance field shader.
+ * 
+ * @return the location of the "lineWidth" uniform, -1 when the program doesn't use it.
+ */
+GLuint Shader::GetLineWidthLocation()
+{
+	return uniformLineWidth;
+}
+
+/**
+ * This function returns the location of the uniform variable that turns on the Bresenham emulation
+ * of the distance field shader.
+ * 
+ * @return the location of the "snapPixels" uniform, -1 when the program doesn't use it.
+ */
+GLuint Shader::GetSnapPixelsLocation()
+{
+	return uniformSnapPixels;
+}
+
+/**
+ * This function returns the location of the uniform variable holding the distance between the lines
+ * of the ground grid drawn by the backdrop shader.
+ * 
+ * @return the location of the "gridSpacing" uniform, -1 when the program doesn't use it.
+ */
+GLuint Shader::GetGridSpacingLocation()
+{
+	return uniformGridSpacing;
+}
+
+/**
+ * This function returns the location of the uniform variable holding the distance at which the
+ * backdrop shader has faded out.
+ * 
+ * @return the location of the "fadeDistance" uniform, -1 when the program doesn't use it.
+ */
+GLuint Shader::GetFadeDistanceLocation()
+{
+	return uniformFadeDistance;
+}
+
 /**
  * This function sets the current shader program to be used for rendering.
  */
@@ -226,17 +370,7 @@ void Shader::AddShader(GLuint theProgram, const char* shaderCode, GLenum shaderT
 	glShaderSource(theShader, 1, theCode, codeLength);
 	glCompileShader(theShader);
 
-	GLint result = 0;
-	GLchar eLog[1024] = { 0 };
-
-	glGetShaderiv(theShader, GL_COMPILE_STATUS, &result);
-	if (!result)
-	{
-		glGetShaderInfoLog(theShader, sizeof(eLog), NULL, eLog);
-		printf("Error compiling the %d shader: '%s'\n", shaderType, eLog);
-		return;
-	}
-
+	// The compile status is checked by FinishCompile, querying it here would block the driver.
 	glAttachShader(theProgram, theShader);
 }
 
@@ -15,6 +15,9 @@ public:
 
 	void CreateFromString(const char* vertexCode, const char* fragmentCode);
 	void CreateFromFiles(const char* vertexLocation, const char* fragmentLocation);
+	void StartFromFiles(const char* vertexLocation, const char* fragmentLocation);
+	bool IsCompileComplete();
+	void FinishCompile();
 
 	std::string ReadFile(const char* fileLocation);
 
@@ -23,6 +26,11 @@ public:
 	GLuint GetViewLocation();
 	GLuint GetAmbientIntensityLocation();
 	GLuint GetAmbientColourLocation();
+	GLuint GetCentreLocation();
+	GLuint GetLineWidthLocation();
+	GLuint GetSnapPixelsLocation();
+	GLuint GetGridSpacingLocation();
+	GLuint GetFadeDistanceLocation();
 
 	void UseShader();
 	void ClearShader();
@@ -30,9 +38,11 @@ public:
 	~Shader();
 
 private:
-	GLuint shaderID, uniformProjection, uniformModel, uniformView, uniformAmbientIntensity, uniformAmbientColour;
+	GLuint shaderID, uniformProjection, uniformModel, uniformView, uniformAmbientIntensity, uniformAmbientColour, uniformCentre,
+		uniformLineWidth, uniformSnapPixels, uniformGridSpacing, uniformFadeDistance;
 
 	void CompileShader(const char* vertexCode, const char* fragmentCode);
+	bool StartCompile(const char* vertexCode, const char* fragmentCode);
 	void AddShader(GLuint theProgram, const char* shaderCode, GLenum shaderType);
 };
 
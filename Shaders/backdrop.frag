@@ -0,0 +1,83 @@
+#version 330
+
+noperspective in vec4 nearPoint;
+noperspective in vec4 farPoint;
+
+out vec4 colour;
+
+// Distance between grid lines on the ground, 0 for no grid. Every tenth line is a major one.
+uniform float gridSpacing;
+// Distance from the camera at which the ground, the grid and the axes have faded out.
+uniform float fadeDistance;
+
+// Coverage of the lines at every multiple of spacing along both coordinates, one screen pixel wide.
+// Lines closer than two pixels on screen fade out instead of turning into moire.
+float gridLines(vec2 coord, float spacing)
+{
+	vec2 cell = coord / spacing;
+	vec2 width = max(fwidth(cell), vec2(1e-6));
+	vec2 gap = abs(fract(cell - 0.5) - 0.5) / width;
+	float line = 1.0 - min(min(gap.x, gap.y), 1.0);
+	return line * (1.0 - smoothstep(0.25, 0.5, max(width.x, width.y)));
+}
+
+// Closest approach of the ray to the axis through the origin along direction, a unit vector. Returns
+// the distance between them, and the distance along the ray and the point of the axis where it
+// happens; t is negative when the axis is behind the camera or parallel to the ray.
+float axisDistance(vec3 origin, vec3 ray, vec3 direction, out float t, out vec3 closest)
+{
+	float b = dot(ray, direction);
+	float denominator = 1.0 - b * b;
+	float rayOrigin = dot(ray, origin);
+	float axisOrigin = dot(direction, origin);
+
+	t = denominator > 1e-6 ? (b * axisOrigin - rayOrigin) / denominator : -1.0;
+	closest = direction * (denominator > 1e-6 ? (axisOrigin - b * rayOrigin) / denominator : 0.0);
+	return length(origin + ray * t - closest);
+}
+
+// Fading with the distance from the camera, 1 up to half of fadeDistance and 0 past it.
+float fade(float depth)
+{
+	return depth > 0.0 ? 1.0 - smoothstep(0.5 * fadeDistance, fadeDistance, depth) : 0.0;
+}
+
+// Non-premultiplied top drawn over bottom.
+vec4 over(vec4 top, vec4 bottom)
+{
+	float alpha = top.a + bottom.a * (1.0 - top.a);
+	vec3 rgb = alpha > 0.0 ? (top.rgb * top.a + bottom.rgb * bottom.a * (1.0 - top.a)) / alpha : vec3(0.0);
+	return vec4(rgb, alpha);
+}
+
+void main()
+{
+	vec3 origin = nearPoint.xyz / nearPoint.w;
+	vec3 ray = normalize(farPoint.xyz / farPoint.w - origin);
+
+	// Ground: the y = 0 plane, coloured by its position like the rest of the scene. The derivatives
+	// are all taken before anything is discarded.
+	float tGround = abs(ray.y) > 1e-6 ? -origin.y / ray.y : -1.0;
+	vec3 ground = origin + ray * max(tGround, 0.0);
+	float major = gridSpacing > 0.0 ? gridLines(ground.xz, 10.0 * gridSpacing) : 0.0;
+	float minor = gridSpacing > 0.0 ? gridLines(ground.xz, gridSpacing) : 0.0;
+	vec3 groundColour = vec3(clamp(ground.x, 0.0, 1.0), 0.0, clamp(ground.z, 0.0, 1.0));
+	groundColour = mix(groundColour, vec3(0.85), max(0.35 * minor, 0.7 * major));
+	vec4 result = vec4(groundColour, fade(tGround));
+
+	// Axes: lines through the origin, one screen pixel wide at any distance, drawn over the ground.
+	const vec3 directions[3] = vec3[3](vec3(1.0, 0.0, 0.0), vec3(0.0, 1.0, 0.0), vec3(0.0, 0.0, 1.0));
+	for (int i = 0; i < 3; i++)
+	{
+		float t;
+		vec3 closest;
+		float gap = axisDistance(origin, ray, directions[i], t, closest);
+		float coverage = clamp(1.0 - gap / max(fwidth(gap), 1e-6), 0.0, 1.0);
+		result = over(vec4(clamp(closest, 0.0, 1.0), coverage * fade(t)), result);
+	}
+
+	if (result.a <= 0.0)
+		discard;
+
+	colour = result;
+}
@@ -0,0 +1,21 @@
+#version 330
+
+// The points of the near and far planes under the fragment, before the division by w. Unprojecting
+// is linear in screen space, so they interpolate exactly without perspective correction.
+noperspective out vec4 nearPoint;
+noperspective out vec4 farPoint;
+
+uniform mat4 projection;
+uniform mat4 view;
+
+// One triangle covering the screen: its vertices are (-1, -1), (3, -1) and (-1, 3) in normalized
+// device coordinates, taken from gl_VertexID.
+void main()
+{
+	vec2 ndc = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;
+	mat4 unproject = inverse(projection * view);
+
+	nearPoint = unproject * vec4(ndc, -1.0, 1.0);
+	farPoint = unproject * vec4(ndc, 1.0, 1.0);
+	gl_Position = vec4(ndc, 0.0, 1.0);
+}
@@ -0,0 +1,26 @@
+#version 330
+
+layout (location = 0) in vec3 pos;
+
+out vec4 vCol;
+
+uniform mat4 model;
+uniform mat4 projection;
+uniform mat4 view;
+uniform vec3 centre;
+
+// pos is the offset of a pixel of one circle octant from the centre. Each of the 8 instances draws
+// the octant reflected to a different place: bit 0 of the instance swaps x and y, bit 1 negates x
+// and bit 2 negates y.
+void main()
+{
+	vec2 offset = (gl_InstanceID & 1) != 0 ? pos.yx : pos.xy;
+	if ((gl_InstanceID & 2) != 0)
+		offset.x = -offset.x;
+	if ((gl_InstanceID & 4) != 0)
+		offset.y = -offset.y;
+
+	vec3 world = vec3(centre.xy + offset, centre.z + pos.z);
+	gl_Position = projection * view * model * vec4(world, 1.0);
+	vCol = vec4(clamp(world, 0.0f, 1.0f), 1.0f);
+}
\ No newline at end of file
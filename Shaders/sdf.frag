@@ -0,0 +1,91 @@
+#version 330
+
+in vec2 worldPos;
+flat in vec4 vShape;
+flat in vec2 vParams;
+
+out vec4 colour;
+
+uniform float lineWidth;
+// When true only the pixels a Bresenham rasterizer would light are drawn, whole.
+uniform bool snapPixels;
+
+// Distance from p to the segment from a to b.
+float segmentDistance(vec2 p, vec2 a, vec2 b)
+{
+	vec2 ab = b - a;
+	float lengthSquared = dot(ab, ab);
+	float t = lengthSquared > 0.0 ? clamp(dot(p - a, ab) / lengthSquared, 0.0, 1.0) : 0.0;
+	return length(p - a - ab * t);
+}
+
+// Pixels lit on each side of the exact one across the major axis: none for a width of 1 or 2, one
+// for 3 or 4, and so on.
+float halfCells()
+{
+	return floor(0.5 * (lineWidth - 1.0));
+}
+
+// Whether the pixel centred on cell is lit by the Bresenham line between the rounded end points.
+// The pixel of each step along the major axis is the one nearest to the exact line; thick lines
+// also light the pixels within half the width across the major axis.
+bool bresenhamLine(vec2 cell, vec2 a, vec2 b)
+{
+	a = floor(a + 0.5);
+	b = floor(b + 0.5);
+	vec2 d = b - a;
+	bool xMajor = abs(d.x) >= abs(d.y);
+	float major = xMajor ? cell.x : cell.y;
+	float minor = xMajor ? cell.y : cell.x;
+	vec2 majorRange = xMajor ? vec2(a.x, b.x) : vec2(a.y, b.y);
+	vec2 minorRange = xMajor ? vec2(a.y, b.y) : vec2(a.x, b.x);
+
+	if (major < min(majorRange.x, majorRange.y) || major > max(majorRange.x, majorRange.y))
+		return false;
+
+	float span = majorRange.y - majorRange.x;
+	float t = span != 0.0 ? (major - majorRange.x) / span : 0.0;
+	float exact = floor(mix(minorRange.x, minorRange.y, t) + 0.5);
+	return abs(minor - exact) <= halfCells();
+}
+
+// Whether the pixel centred on cell is lit by a midpoint or Bresenham circle. In the octants where
+// y changes slower than x the pixel of each row is the one nearest to the circle, and the other way
+// round in the rest.
+bool bresenhamCircle(vec2 cell, vec2 centre, float radius)
+{
+	vec2 q = abs(cell - floor(centre + 0.5));
+	float along = q.y <= q.x ? q.y : q.x;
+	float across = q.y <= q.x ? q.x : q.y;
+	float squared = radius * radius - along * along;
+	if (squared < 0.0)
+		return false;
+
+	return abs(across - floor(sqrt(squared) + 0.5)) <= halfCells();
+}
+
+void main()
+{
+	bool circle = vParams.y > 0.5;
+	float coverage;
+
+	if (snapPixels)
+	{
+		vec2 cell = floor(worldPos + 0.5);
+		bool lit = circle ? bresenhamCircle(cell, vShape.xy, vParams.x) : bresenhamLine(cell, vShape.xy, vShape.zw);
+		coverage = lit ? 1.0 : 0.0;
+	}
+	else
+	{
+		float d = circle ? abs(length(worldPos - vShape.xy) - vParams.x) : segmentDistance(worldPos, vShape.xy, vShape.zw);
+		// Antialias over one screen pixel, and never get thinner than one when zoomed out.
+		float aa = max(fwidth(d), 1e-4);
+		float halfWidth = max(0.5 * lineWidth, 0.5 * aa);
+		coverage = clamp((halfWidth - d) / aa + 0.5, 0.0, 1.0);
+	}
+
+	if (coverage <= 0.0)
+		discard;
+
+	colour = vec4(clamp(vec3(worldPos, 0.0), 0.0, 1.0), coverage);
+}
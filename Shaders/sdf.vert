@@ -0,0 +1,31 @@
+#version 330
+
+// x1, y1, x2, y2 of a line, or the centre of a circle twice.
+layout (location = 0) in vec4 shape;
+// The radius of a circle and the kind of primitive: 0 line, 1 circle.
+layout (location = 1) in vec2 params;
+
+out vec2 worldPos;
+flat out vec4 vShape;
+flat out vec2 vParams;
+
+uniform mat4 model;
+uniform mat4 projection;
+uniform mat4 view;
+uniform float lineWidth;
+
+// Each instance is one quad covering its primitive. The corner comes from gl_VertexID, drawn as a
+// triangle strip, and the quad is padded by half the width plus one pixel, so the antialiased edge
+// and the whole pixels lit by the Bresenham emulation fit inside it.
+void main()
+{
+	float pad = 0.5 * lineWidth + 1.0 + params.x;
+	vec2 lower = min(shape.xy, shape.zw) - pad;
+	vec2 upper = max(shape.xy, shape.zw) + pad;
+	vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+
+	worldPos = mix(lower, upper, corner);
+	vShape = shape;
+	vParams = params;
+	gl_Position = projection * view * model * vec4(worldPos, 0.0, 1.0);
+}
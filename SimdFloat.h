@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stddef.h>
+#include <math.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SIMD_FLOAT_AVX2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SIMD_FLOAT_NEON
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIMD_FLOAT_SSE2
+#endif
+
+/**
+ * Thin wrapper over the widest float vector the build targets: AVX2 when the compiler is allowed to
+ * use it (/arch:AVX2 or -mavx2), NEON on 64-bit ARM, SSE2 on any other x86-64 and a single float
+ * otherwise. Kernels are written once against it and process width floats per step, finishing the
+ * remainder of their arrays with plain scalar code.
+ */
+struct SimdFloat
+{
+#if defined(SIMD_FLOAT_AVX2)
+	typedef __m256 Register;
+	enum { width = 8 };
+
+	static const char* name() { return "AVX2"; }
+	static Register load(const float* p) { return _mm256_loadu_ps(p); }
+	static void store(float* p, Register v) { _mm256_storeu_ps(p, v); }
+	static Register set(float v) { return _mm256_set1_ps(v); }
+	static Register add(Register a, Register b) { return _mm256_add_ps(a, b); }
+	static Register sub(Register a, Register b) { return _mm256_sub_ps(a, b); }
+	static Register mul(Register a, Register b) { return _mm256_mul_ps(a, b); }
+	static Register div(Register a, Register b) { return _mm256_div_ps(a, b); }
+	static Register sqrt(Register a) { return _mm256_sqrt_ps(a); }
+	static Register min(Register a, Register b) { return _mm256_min_ps(a, b); }
+	static Register max(Register a, Register b) { return _mm256_max_ps(a, b); }
+#elif defined(SIMD_FLOAT_NEON)
+	typedef float32x4_t Register;
+	enum { width = 4 };
+
+	static const char* name() { return "NEON"; }
+	static Register load(const float* p) { return vld1q_f32(p); }
+	static void store(float* p, Register v) { vst1q_f32(p, v); }
+	static Register set(float v) { return vdupq_n_f32(v); }
+	static Register add(Register a, Register b) { return vaddq_f32(a, b); }
+	static Register sub(Register a, Register b) { return vsubq_f32(a, b); }
+	static Register mul(Register a, Register b) { return vmulq_f32(a, b); }
+	static Register div(Register a, Register b) { return vdivq_f32(a, b); }
+	static Register sqrt(Register a) { return vsqrtq_f32(a); }
+	static Register min(Register a, Register b) { return vminq_f32(a, b); }
+	static Register max(Register a, Register b) { return vmaxq_f32(a, b); }
+#elif defined(SIMD_FLOAT_SSE2)
+	typedef __m128 Register;
+	enum { width = 4 };
+
+	static const char* name() { return "SSE2"; }
+	static Register load(const float* p) { return _mm_loadu_ps(p); }
+	static void store(float* p, Register v) { _mm_storeu_ps(p, v); }
+	static Register set(float v) { return _mm_set1_ps(v); }
+	static Register add(Register a, Register b) { return _mm_add_ps(a, b); }
+	static Register sub(Register a, Register b) { return _mm_sub_ps(a, b); }
+	static Register mul(Register a, Register b) { return _mm_mul_ps(a, b); }
+	static Register div(Register a, Register b) { return _mm_div_ps(a, b); }
+	static Register sqrt(Register a) { return _mm_sqrt_ps(a); }
+	static Register min(Register a, Register b) { return _mm_min_ps(a, b); }
+	static Register max(Register a, Register b) { return _mm_max_ps(a, b); }
+#else
+	typedef float Register;
+	enum { width = 1 };
+
+	static const char* name() { return "scalar"; }
+	static Register load(const float* p) { return *p; }
+	static void store(float* p, Register v) { *p = v; }
+	static Register set(float v) { return v; }
+	static Register add(Register a, Register b) { return a + b; }
+	static Register sub(Register a, Register b) { return a - b; }
+	static Register mul(Register a, Register b) { return a * b; }
+	static Register div(Register a, Register b) { return a / b; }
+	static Register sqrt(Register a) { return ::sqrtf(a); }
+	static Register min(Register a, Register b) { return a < b ? a : b; }
+	static Register max(Register a, Register b) { return a > b ? a : b; }
+#endif
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+
+/**
+ * Lock-free hand-over of a value from one producer thread to one consumer thread. The producer
+ * writes into its own back buffer and publishes it with a single atomic exchange; the consumer swaps
+ * the newest published buffer into its front buffer the same way. A third, shared slot sits between
+ * both, so neither side ever waits for the other or sees a partially written value.
+ */
+template <typename T>
+class SnapshotExchange
+{
+public:
+	SnapshotExchange()
+	{
+		writeIndex = 0;
+		middle.store(1);
+		readIndex = 2;
+	}
+
+	/**
+	 * This function publishes a new value. Only the producer thread may call it.
+	 * 
+	 * @param value The value to hand over to the consumer.
+	 */
+	void publish(const T& value)
+	{
+		slots[writeIndex] = value;
+		int previous = middle.exchange(writeIndex | freshBit, std::memory_order_acq_rel);
+		writeIndex = previous & indexMask;
+	}
+
+	/**
+	 * This function takes the newest published value. Only the consumer thread may call it.
+	 * 
+	 * @param value Receives the newest value, or the previously consumed one if nothing new arrived.
+	 * 
+	 * @return true if a value published since the last call was taken.
+	 */
+	bool consume(T& value)
+	{
+		if ((middle.load(std::memory_order_acquire) & freshBit) == 0)
+		{
+			value = slots[readIndex];
+			return false;
+		}
+
+		int previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+		readIndex = previous & indexMask;
+		value = slots[readIndex];
+		return true;
+	}
+
+private:
+	enum { indexMask = 3, freshBit = 4 };
+
+	T slots[3];
+	std::atomic<int> middle;
+	int writeIndex;
+	int readIndex;
+
+	SnapshotExchange(const SnapshotExchange&);
+	SnapshotExchange& operator=(const SnapshotExchange&);
+};
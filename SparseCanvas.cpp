@@ -0,0 +1,364 @@
+#include "SparseCanvas.h"
+
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+
+/**
+ * The SparseCanvas constructor creates an empty canvas. The page file is only created when a tile
+ * is first paged out, and removed by the destructor.
+ * 
+ * @param memoryCap The most bytes of tiles kept in memory, at least one tile is.
+ * @param pagePath The path of the page file the tiles above the cap are written to.
+ */
+SparseCanvas::SparseCanvas(size_t memoryCap, const char* pagePath) : pagePath(pagePath)
+{
+	maxResidentTiles = std::max<size_t>(1, memoryCap / tileBytes);
+	pageSlots = 0;
+	pagingFailed = false;
+	pageOuts = 0;
+	pageIns = 0;
+	lastKey = 0;
+	lastTile = UINT32_MAX;
+}
+
+/**
+ * This function sets a pixel of the canvas, allocating its tile on first touch.
+ * 
+ * @param x The x-coordinate of the pixel.
+ * @param y The y-coordinate of the pixel.
+ */
+void SparseCanvas::setPixel(int x, int y)
+{
+	Tile* tile = touch(tileKey(x, y), true);
+	unsigned int bit = bitOf(x, y);
+	uint64_t mask = (uint64_t)1 << (bit % 64);
+	if (tile->words[bit / 64] & mask)
+		return;
+
+	tile->words[bit / 64] |= mask;
+	tile->dirty = true;
+	tile->version++;
+}
+
+/**
+ * This function sets the pixels holding a list of points, each point rounded to the nearest integer
+ * coordinates, such as the output of the rasterizers of MathOGL.
+ * 
+ * @param pixels The points.
+ * @param count The number of points.
+ */
+void SparseCanvas::write(const glm::vec3* pixels, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		setPixel((int)floor(pixels[i].x + 0.5f), (int)floor(pixels[i].y + 0.5f));
+	}
+}
+
+/**
+ * This function sets the pixels holding a list of points.
+ * 
+ * @param pixels The points, as given by the rasterizers of MathOGL.
+ */
+void SparseCanvas::write(const std::vector<glm::vec3>& pixels)
+{
+	write(pixels.empty() ? NULL : pixels.data(), pixels.size());
+}
+
+/**
+ * This function tells whether a pixel is set. A paged out tile is read back to answer.
+ * 
+ * @param x The x-coordinate of the pixel.
+ * @param y The y-coordinate of the pixel.
+ * 
+ * @return true if the pixel is set.
+ */
+bool SparseCanvas::getPixel(int x, int y)
+{
+	Tile* tile = touch(tileKey(x, y), false);
+	if (tile == NULL)
+		return false;
+
+	unsigned int bit = bitOf(x, y);
+	return (tile->words[bit / 64] >> (bit % 64)) & 1;
+}
+
+/**
+ * This function lists the allocated tiles overlapping a region, resident or not.
+ * 
+ * @param region The region, in canvas coordinates.
+ * @param keys Receives the keys of the tiles.
+ */
+void SparseCanvas::tilesIn(const ClipRect& region, std::vector<uint64_t>& keys) const
+{
+	keys.clear();
+	if (region.xMin > region.xMax || region.yMin > region.yMax)
+		return;
+
+	uint32_t left = Morton::toUnsigned((int)floor(region.xMin)) >> tileBits;
+	uint32_t right = Morton::toUnsigned((int)ceil(region.xMax)) >> tileBits;
+	uint32_t bottom = Morton::toUnsigned((int)floor(region.yMin)) >> tileBits;
+	uint32_t top = Morton::toUnsigned((int)ceil(region.yMax)) >> tileBits;
+
+	// A region covering more tiles than the canvas holds is faster to answer from the tiles.
+	if ((uint64_t)(right - left + 1) * (top - bottom + 1) > tiles.size())
+	{
+		for (size_t i = 0; i < tiles.size(); i++)
+		{
+			uint32_t tx = Morton::decodeX(tiles[i].key), ty = Morton::decodeY(tiles[i].key);
+			if (tx >= left && tx <= right && ty >= bottom && ty <= top)
+			{
+				keys.push_back(tiles[i].key);
+			}
+		}
+		return;
+	}
+
+	for (uint32_t ty = bottom; ty <= top; ty++)
+	{
+		for (uint32_t tx = left; tx <= right; tx++)
+		{
+			uint64_t key = Morton::encode(tx, ty);
+			if (index.find(key) != index.end())
+			{
+				keys.push_back(key);
+			}
+		}
+	}
+}
+
+/**
+ * This function appends the set pixels of a tile to a vector as points, row after row. A paged out
+ * tile is read back first.
+ * 
+ * @param key The key of the tile, as given by tilesIn.
+ * @param out The vector the points are appended to.
+ * 
+ * @return the number of points appended.
+ */
+size_t SparseCanvas::appendTilePixels(uint64_t key, std::vector<glm::vec3>& out)
+{
+	Tile* tile = touch(key, false);
+	if (tile == NULL)
+		return 0;
+
+	int originX = Morton::toSigned(Morton::decodeX(key) << tileBits);
+	int originY = Morton::toSigned(Morton::decodeY(key) << tileBits);
+	size_t before = out.size();
+	for (int w = 0; w < wordsPerTile; w++)
+	{
+		for (uint64_t word = tile->words[w]; word != 0; word &= word - 1)
+		{
+			// Index of the lowest set bit.
+			int bit = 0;
+			while (((word >> bit) & 1) == 0)
+			{
+				bit++;
+			}
+			int index = w * 64 + bit;
+			out.push_back(glm::vec3(originX + index % tileSize, originY + index / tileSize, 0));
+		}
+	}
+	return out.size() - before;
+}
+
+/**
+ * This function returns the version of a tile, which changes every time one of its pixels is set.
+ * 
+ * @param key The key of the tile, as given by tilesIn.
+ * 
+ * @return the version of the tile, 0 if it is not allocated.
+ */
+unsigned int SparseCanvas::getTileVersion(uint64_t key) const
+{
+	std::unordered_map<uint64_t, uint32_t>::const_iterator found = index.find(key);
+	return found == index.end() ? 0 : tiles[found->second].version;
+}
+
+/**
+ * This function counts the set pixels of the canvas, reading back the paged out tiles.
+ * 
+ * @return the number of set pixels.
+ */
+size_t SparseCanvas::countPixels()
+{
+	size_t count = 0;
+	for (size_t i = 0; i < tiles.size(); i++)
+	{
+		Tile* tile = touch(tiles[i].key, false);
+		for (int w = 0; w < wordsPerTile; w++)
+		{
+			for (uint64_t word = tile->words[w]; word != 0; word &= word - 1)
+			{
+				count++;
+			}
+		}
+	}
+	return count;
+}
+
+/**
+ * This function frees every tile and empties the page file.
+ */
+void SparseCanvas::clear()
+{
+	tiles.clear();
+	index.clear();
+	lru.clear();
+	lastTile = UINT32_MAX;
+	pageSlots = 0;
+	if (pageFile.is_open())
+	{
+		pageFile.close();
+		remove(pagePath.c_str());
+	}
+}
+
+/**
+ * This function returns the resident tile with the given key, paging it in if needed, and marks it as
+ * the most recently used.
+ * 
+ * @param key The key of the tile.
+ * @param create Whether to allocate the tile when it doesn't exist.
+ * 
+ * @return the tile, NULL if it doesn't exist and create is false.
+ */
+SparseCanvas::Tile* SparseCanvas::touch(uint64_t key, bool create)
+{
+	if (key == lastKey && lastTile != UINT32_MAX)
+		return &tiles[lastTile];
+
+	uint32_t tile;
+	std::unordered_map<uint64_t, uint32_t>::iterator found = index.find(key);
+	if (found == index.end())
+	{
+		if (!create)
+			return NULL;
+
+		tile = (uint32_t)tiles.size();
+		Tile created;
+		created.key = key;
+		created.pageSlot = -1;
+		created.dirty = false;
+		created.version = 0;
+		tiles.push_back(created);
+		index[key] = tile;
+		makeResident(tile);
+	}
+	else
+	{
+		tile = found->second;
+		if (tiles[tile].words.empty())
+		{
+			makeResident(tile);
+		}
+		else
+		{
+			lru.splice(lru.begin(), lru, tiles[tile].lruEntry);
+		}
+	}
+
+	lastKey = key;
+	lastTile = tile;
+	return &tiles[tile];
+}
+
+/**
+ * This function loads a tile in memory, zeroed if it was never paged out, paging out the least
+ * recently used tiles first if the cap is reached. If its copy can't be read back, the tile comes
+ * back empty, an error is printed and no more tiles are paged out.
+ * 
+ * @param tile The index of the tile.
+ */
+void SparseCanvas::makeResident(uint32_t tile)
+{
+	while (!pagingFailed && lru.size() >= maxResidentTiles)
+	{
+		pageOut(lru.back());
+	}
+
+	Tile& t = tiles[tile];
+	t.words.assign(wordsPerTile, 0);
+	if (t.pageSlot >= 0)
+	{
+		pageFile.seekg(t.pageSlot * tileBytes);
+		pageFile.read((char*)t.words.data(), tileBytes);
+		if (pageFile.fail())
+		{
+			printf("Error reading tile %u back from page file '%s', its pixels are lost\n", tile, pagePath.c_str());
+			pageFile.clear();
+			std::fill(t.words.begin(), t.words.end(), 0);
+			pagingFailed = true;
+		}
+		else
+		{
+			t.dirty = false;
+			pageIns++;
+		}
+	}
+	lru.push_front(tile);
+	t.lruEntry = lru.begin();
+}
+
+/**
+ * This function frees a resident tile, writing it to the page file unless the copy there is current.
+ * If the page file can't be written, the tile stays resident and no more tiles are paged out.
+ * 
+ * @param tile The index of the tile.
+ */
+void SparseCanvas::pageOut(uint32_t tile)
+{
+	Tile& t = tiles[tile];
+	if (t.dirty || t.pageSlot < 0)
+	{
+		if (!pageFile.is_open())
+		{
+			pageFile.open(pagePath.c_str(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!pageFile.is_open())
+			{
+				printf("Error opening page file '%s', tiles stay in memory\n", pagePath.c_str());
+				pagingFailed = true;
+				return;
+			}
+		}
+		bool newSlot = t.pageSlot < 0;
+		if (newSlot)
+		{
+			t.pageSlot = pageSlots++;
+		}
+		// Flushed now, so a full disk shows up before the only copy in memory is freed.
+		pageFile.seekp(t.pageSlot * tileBytes);
+		pageFile.write((const char*)t.words.data(), tileBytes);
+		pageFile.flush();
+		if (pageFile.fail())
+		{
+			printf("Error writing page file '%s', tiles stay in memory\n", pagePath.c_str());
+			pageFile.clear();
+			if (newSlot)
+			{
+				t.pageSlot = -1;
+				pageSlots--;
+			}
+			pagingFailed = true;
+			return;
+		}
+		t.dirty = false;
+	}
+
+	std::vector<uint64_t>().swap(t.words);
+	lru.erase(t.lruEntry);
+	if (lastTile == tile)
+	{
+		lastTile = UINT32_MAX;
+	}
+	pageOuts++;
+}
+
+/**
+ * This is a destructor for the SparseCanvas class, which removes the page file.
+ */
+SparseCanvas::~SparseCanvas()
+{
+	clear();
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <list>
+#include <string>
+#include <fstream>
+#include <unordered_map>
+
+#include <glm.hpp>
+
+#include "Morton.h"
+#include "MathOGL.h"
+
+/**
+ * One bit per pixel canvas for coordinate spaces far too large to allocate, such as 10^6 x 10^6
+ * units with sparse content. The canvas is split in 256x256 tiles that are only allocated when a
+ * pixel is first set in them. When the resident tiles would exceed the memory cap, the least
+ * recently used one is written to a page file and freed, and it is read back on its next use. Each
+ * tile has a version that changes with its pixels, so views can tell which tiles to upload again.
+ */
+class SparseCanvas
+{
+public:
+	enum { tileBits = 8, tileSize = 1 << tileBits, wordsPerTile = tileSize * tileSize / 64, tileBytes = wordsPerTile * 8 };
+
+	SparseCanvas(size_t memoryCap, const char* pagePath);
+
+	void setPixel(int x, int y);
+	void write(const glm::vec3* pixels, size_t count);
+	void write(const std::vector<glm::vec3>& pixels);
+	bool getPixel(int x, int y);
+	void tilesIn(const ClipRect& region, std::vector<uint64_t>& keys) const;
+	size_t appendTilePixels(uint64_t key, std::vector<glm::vec3>& out);
+	unsigned int getTileVersion(uint64_t key) const;
+	void clear();
+
+	size_t getTileCount() const { return tiles.size(); }
+	size_t getResidentTileCount() const { return lru.size(); }
+	size_t getResidentBytes() const { return lru.size() * (size_t)tileBytes; }
+	size_t getPagedBytes() const { return pageSlots * (size_t)tileBytes; }
+	unsigned long long getPageOuts() const { return pageOuts; }
+	unsigned long long getPageIns() const { return pageIns; }
+	size_t countPixels();
+
+	~SparseCanvas();
+
+private:
+	struct Tile
+	{
+		uint64_t key;
+		// Empty while the tile is paged out.
+		std::vector<uint64_t> words;
+		// Slot of the tile in the page file, -1 if it was never paged out.
+		long long pageSlot;
+		// Whether the words changed since the tile was last written to the page file.
+		bool dirty;
+		unsigned int version;
+		std::list<uint32_t>::iterator lruEntry;
+	};
+
+	size_t maxResidentTiles;
+	std::string pagePath;
+	std::fstream pageFile;
+	size_t pageSlots;
+	// Set when the page file can't be written or read back; tiles then stay resident past the cap.
+	bool pagingFailed;
+	unsigned long long pageOuts, pageIns;
+
+	std::vector<Tile> tiles;
+	std::unordered_map<uint64_t, uint32_t> index;
+	// Resident tiles, most recently used first.
+	std::list<uint32_t> lru;
+	// Consecutive pixels of a primitive usually fall in the same tile, skip the lookup for them.
+	uint64_t lastKey;
+	uint32_t lastTile;
+
+	Tile* touch(uint64_t key, bool create);
+	void makeResident(uint32_t tile);
+	void pageOut(uint32_t tile);
+	static uint64_t tileKey(int x, int y) { return Morton::encode(Morton::toUnsigned(x) >> tileBits, Morton::toUnsigned(y) >> tileBits); }
+	static unsigned int bitOf(int x, int y) { return (y & (tileSize - 1)) * tileSize + (x & (tileSize - 1)); }
+
+	SparseCanvas(const SparseCanvas&);
+	SparseCanvas& operator=(const SparseCanvas&);
+};
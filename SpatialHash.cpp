@@ -0,0 +1,256 @@
+#include "SpatialHash.h"
+
+#include <math.h>
+#include <float.h>
+
+/**
+ * The SpatialHash constructor creates an empty index.
+ */
+SpatialHash::SpatialHash()
+{
+	count = 0;
+	lastKey = 0;
+	lastCell = UINT32_MAX;
+}
+
+/**
+ * This function adds a pixel of a primitive to the index.
+ * 
+ * @param x The x-coordinate of the pixel.
+ * @param y The y-coordinate of the pixel.
+ * @param primitive The handle of the primitive, returned by the queries.
+ */
+void SpatialHash::insert(int x, int y, unsigned int primitive)
+{
+	uint64_t key = cellKey(cellOf(x), cellOf(y));
+	if (key != lastKey || lastCell == UINT32_MAX)
+	{
+		std::unordered_map<uint64_t, uint32_t>::iterator found = index.find(key);
+		if (found == index.end())
+		{
+			found = index.insert(std::make_pair(key, (uint32_t)cells.size())).first;
+			cells.push_back(std::vector<SpatialHit>());
+		}
+		lastKey = key;
+		lastCell = found->second;
+	}
+
+	SpatialHit hit = { x, y, primitive };
+	cells[lastCell].push_back(hit);
+	count++;
+}
+
+/**
+ * This function adds the pixels of a primitive, each point rounded to the nearest integer
+ * coordinates.
+ * 
+ * @param pixels The pixels, as given by the rasterizers of MathOGL.
+ * @param count The number of pixels.
+ * @param primitive The handle of the primitive, returned by the queries.
+ */
+void SpatialHash::insert(const glm::vec3* pixels, size_t count, unsigned int primitive)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		insert((int)floor(pixels[i].x + 0.5f), (int)floor(pixels[i].y + 0.5f), primitive);
+	}
+}
+
+/**
+ * This function adds the pixels of a primitive.
+ * 
+ * @param pixels The pixels, as given by the rasterizers of MathOGL.
+ * @param primitive The handle of the primitive, returned by the queries.
+ */
+void SpatialHash::insert(const std::vector<glm::vec3>& pixels, unsigned int primitive)
+{
+	insert(pixels.empty() ? NULL : pixels.data(), pixels.size(), primitive);
+}
+
+/**
+ * This function finds the pixel at the given coordinates. When several primitives drew it, the one
+ * added last, which is drawn on top, is returned.
+ * 
+ * @param x The x-coordinate of the pixel.
+ * @param y The y-coordinate of the pixel.
+ * @param hit Receives the pixel and its primitive.
+ * 
+ * @return true if a primitive drew the pixel.
+ */
+bool SpatialHash::queryPoint(int x, int y, SpatialHit& hit) const
+{
+	const std::vector<SpatialHit>* cell = findCell(cellOf(x), cellOf(y));
+	if (cell == NULL)
+		return false;
+
+	for (size_t i = cell->size(); i-- > 0;)
+	{
+		if ((*cell)[i].x == x && (*cell)[i].y == y)
+		{
+			hit = (*cell)[i];
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * This function appends the pixels inside a rectangle to a vector, once per primitive that drew them.
+ * 
+ * @param xMin The smallest x-coordinate of the rectangle.
+ * @param yMin The smallest y-coordinate of the rectangle.
+ * @param xMax The largest x-coordinate of the rectangle, included.
+ * @param yMax The largest y-coordinate of the rectangle, included.
+ * @param out The vector the pixels are appended to.
+ * 
+ * @return the number of pixels appended.
+ */
+size_t SpatialHash::queryRect(int xMin, int yMin, int xMax, int yMax, std::vector<SpatialHit>& out) const
+{
+	size_t found = 0;
+	visitRect(xMin, yMin, xMax, yMax, [&](const SpatialHit& hit) {
+		out.push_back(hit);
+		found++;
+	});
+	return found;
+}
+
+/**
+ * This function appends the pixels within a distance of a point to a vector, once per primitive that
+ * drew them.
+ * 
+ * @param x The x-coordinate of the point.
+ * @param y The y-coordinate of the point.
+ * @param radius The largest distance from the point, included.
+ * @param out The vector the pixels are appended to.
+ * 
+ * @return the number of pixels appended.
+ */
+size_t SpatialHash::queryRadius(float x, float y, float radius, std::vector<SpatialHit>& out) const
+{
+	size_t found = 0;
+	float radiusSquared = radius * radius;
+	visitRect((int)ceil(x - radius), (int)ceil(y - radius), (int)floor(x + radius), (int)floor(y + radius), [&](const SpatialHit& hit) {
+		float dx = hit.x - x, dy = hit.y - y;
+		if (dx * dx + dy * dy <= radiusSquared)
+		{
+			out.push_back(hit);
+			found++;
+		}
+	});
+	return found;
+}
+
+/**
+ * This function finds the pixel closest to a point, such as the one under the cursor. Between pixels
+ * at the same distance the one added last wins.
+ * 
+ * @param x The x-coordinate of the point.
+ * @param y The y-coordinate of the point.
+ * @param maxDistance The largest distance to look at.
+ * @param hit Receives the closest pixel and its primitive.
+ * 
+ * @return true if a pixel is within maxDistance of the point.
+ */
+bool SpatialHash::nearest(float x, float y, float maxDistance, SpatialHit& hit) const
+{
+	float best = maxDistance * maxDistance;
+	bool found = false;
+	visitRect((int)ceil(x - maxDistance), (int)ceil(y - maxDistance), (int)floor(x + maxDistance), (int)floor(y + maxDistance), [&](const SpatialHit& candidate) {
+		float dx = candidate.x - x, dy = candidate.y - y;
+		float distance = dx * dx + dy * dy;
+		if (distance < best || (distance == best && (!found || candidate.primitive >= hit.primitive)))
+		{
+			best = distance;
+			hit = candidate;
+			found = true;
+		}
+	});
+	return found;
+}
+
+/**
+ * This function removes every pixel from the index.
+ */
+void SpatialHash::clear()
+{
+	cells.clear();
+	index.clear();
+	count = 0;
+	lastCell = UINT32_MAX;
+}
+
+/**
+ * This function returns the pixels of a cell.
+ * 
+ * @param cellX The column of the cell.
+ * @param cellY The row of the cell.
+ * 
+ * @return the pixels of the cell, NULL if no pixel fell in it.
+ */
+const std::vector<SpatialHit>* SpatialHash::findCell(uint32_t cellX, uint32_t cellY) const
+{
+	std::unordered_map<uint64_t, uint32_t>::const_iterator found = index.find(cellKey(cellX, cellY));
+	return found == index.end() ? NULL : &cells[found->second];
+}
+
+/**
+ * This function calls visit with every pixel inside a rectangle, looking only at the cells the
+ * rectangle overlaps.
+ * 
+ * @param xMin The smallest x-coordinate of the rectangle.
+ * @param yMin The smallest y-coordinate of the rectangle.
+ * @param xMax The largest x-coordinate of the rectangle, included.
+ * @param yMax The largest y-coordinate of the rectangle, included.
+ * @param visit The function to call with each SpatialHit found.
+ */
+template <typename Visitor>
+void SpatialHash::visitRect(int xMin, int yMin, int xMax, int yMax, Visitor visit) const
+{
+	if (xMin > xMax || yMin > yMax)
+		return;
+
+	// A rectangle covering more cells than the index holds is faster to answer from the cells.
+	uint64_t covered = (uint64_t)(cellOf(xMax) - cellOf(xMin) + 1) * (cellOf(yMax) - cellOf(yMin) + 1);
+	if (covered > cells.size())
+	{
+		for (size_t c = 0; c < cells.size(); c++)
+		{
+			for (size_t i = 0; i < cells[c].size(); i++)
+			{
+				const SpatialHit& hit = cells[c][i];
+				if (hit.x >= xMin && hit.x <= xMax && hit.y >= yMin && hit.y <= yMax)
+				{
+					visit(hit);
+				}
+			}
+		}
+		return;
+	}
+
+	for (uint32_t cellY = cellOf(yMin); cellY <= cellOf(yMax); cellY++)
+	{
+		for (uint32_t cellX = cellOf(xMin); cellX <= cellOf(xMax); cellX++)
+		{
+			const std::vector<SpatialHit>* cell = findCell(cellX, cellY);
+			if (cell == NULL)
+				continue;
+
+			for (size_t i = 0; i < cell->size(); i++)
+			{
+				const SpatialHit& hit = (*cell)[i];
+				if (hit.x >= xMin && hit.x <= xMax && hit.y >= yMin && hit.y <= yMax)
+				{
+					visit(hit);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * This is a destructor for the SpatialHash class.
+ */
+SpatialHash::~SpatialHash()
+{
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <unordered_map>
+
+#include <glm.hpp>
+
+#include "Morton.h"
+
+/**
+ * Pixel of a primitive returned by the queries of SpatialHash.
+ */
+struct SpatialHit
+{
+	int x, y;
+	// Handle of the primitive the pixel belongs to, as given to SpatialHash::insert.
+	unsigned int primitive;
+};
+
+/**
+ * Index of the displayed pixels on a uniform grid of 16x16 cells found through a hash map, so a
+ * query only looks at the cells it overlaps: a point query costs O(1) and a radius or rectangle
+ * query O(k) in the pixels near it, however many pixels the scene holds. Primitives are added one
+ * at a time as they are rasterized.
+ */
+class SpatialHash
+{
+public:
+	enum { cellBits = 4, cellSize = 1 << cellBits };
+
+	SpatialHash();
+
+	void insert(int x, int y, unsigned int primitive);
+	void insert(const glm::vec3* pixels, size_t count, unsigned int primitive);
+	void insert(const std::vector<glm::vec3>& pixels, unsigned int primitive);
+
+	bool queryPoint(int x, int y, SpatialHit& hit) const;
+	size_t queryRect(int xMin, int yMin, int xMax, int yMax, std::vector<SpatialHit>& out) const;
+	size_t queryRadius(float x, float y, float radius, std::vector<SpatialHit>& out) const;
+	bool nearest(float x, float y, float maxDistance, SpatialHit& hit) const;
+	void clear();
+
+	size_t size() const { return count; }
+	size_t getCellCount() const { return cells.size(); }
+
+	~SpatialHash();
+
+private:
+	std::vector<std::vector<SpatialHit> > cells;
+	std::unordered_map<uint64_t, uint32_t> index;
+	size_t count;
+	// Consecutive pixels of a primitive usually fall in the same cell, skip the lookup for them.
+	uint64_t lastKey;
+	uint32_t lastCell;
+
+	const std::vector<SpatialHit>* findCell(uint32_t cellX, uint32_t cellY) const;
+	template <typename Visitor>
+	void visitRect(int xMin, int yMin, int xMax, int yMax, Visitor visit) const;
+	static uint32_t cellOf(int v) { return Morton::toUnsigned(v) >> cellBits; }
+	static uint64_t cellKey(uint32_t cellX, uint32_t cellY) { return ((uint64_t)cellX << 32) | cellY; }
+};
@@ -0,0 +1,29 @@
+#include "TempFile.h"
+
+#include <stdlib.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+/**
+ * The function returns the path of a file in the temporary directory of the system.
+ * 
+ * @param name The name of the file.
+ * 
+ * @return the path of the file, in the working directory if there is no temporary one.
+ */
+std::string TempFile::path(const char* name)
+{
+#ifdef _WIN32
+	char directory[MAX_PATH + 1];
+	DWORD length = GetTempPathA(sizeof(directory), directory);
+	std::string path = length > 0 && length <= MAX_PATH ? std::string(directory, length) : std::string();
+#else
+	const char* directory = getenv("TMPDIR");
+	std::string path = std::string(directory != NULL && directory[0] != '\0' ? directory : "/tmp") + "/";
+#endif
+	return path + name;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+
+/**
+ * Paths for scratch files, such as page files and benchmark output, in the temporary directory of
+ * the system instead of the working directory.
+ */
+struct TempFile
+{
+	static std::string path(const char* name);
+};
@@ -0,0 +1,415 @@
+#include "TileRasterizer.h"
+
+/**
+ * The TileRasterizer constructor allocates the tile-local bitmaps of the whole canvas.
+ * 
+ * @param width The width of the canvas in pixels.
+ * @param height The height of the canvas in pixels.
+ * @param tileSize The side of the tiles in pixels. The bitmap of a tile is rounded up to whole 64-bit
+ * words, so sides that are not a multiple of 8 leave the last word partly unused.
+ */
+TileRasterizer::TileRasterizer(int width, int height, int tileSize)
+{
+	this->width = width;
+	this->height = height;
+	this->tileSize = tileSize;
+	tilesX = (width + tileSize - 1) / tileSize;
+	tilesY = (height + tileSize - 1) / tileSize;
+	wordsPerTile = (tileSize * tileSize + 63) / 64;
+	primitives = NULL;
+	bits.assign((size_t)tilesX * tilesY * wordsPerTile, 0);
+}
+
+/**
+ * This function assigns every primitive to the tiles it may touch. The primitives are split among
+ * threadCount threads that fill their own bins, and rasterize visits the bins in thread order, so
+ * every tile still sees its primitives in their original order. Each thread takes a contiguous range
+ * of primitives with about the same number of pixels, as counted by MathOGL, since one long line or
+ * large circle costs as much as thousands of short ones.
+ * 
+ * @param primitives The primitives to draw, kept by reference until rasterize returns.
+ * @param threadCount The number of threads to use.
+ */
+void TileRasterizer::bin(const std::vector<Primitive>& primitives, unsigned int threadCount)
+{
+	this->primitives = &primitives;
+	threadCount = std::max(1u, threadCount);
+	bins.assign(threadCount, TileBins(getTileCount()));
+
+	std::vector<size_t> costs(primitives.size());
+	size_t totalCost = 0;
+	for (size_t i = 0; i < primitives.size(); i++)
+	{
+		const Primitive& primitive = primitives[i];
+		costs[i] = primitive.kind == Primitive::LINE ?
+			MathOGL::countLineOctant(primitive.x1, primitive.y1, primitive.x2, primitive.y2) :
+			MathOGL::countBresenhamCircle(primitive.x1, primitive.y1, primitive.x2);
+		totalCost += costs[i];
+	}
+
+	// Thread t bins the primitives from bounds[t] up to bounds[t + 1].
+	std::vector<size_t> bounds(threadCount + 1, primitives.size());
+	bounds[0] = 0;
+	size_t cost = 0;
+	unsigned int next = 1;
+	for (size_t i = 0; i < primitives.size() && next < threadCount; i++)
+	{
+		cost += costs[i];
+		while (next < threadCount && (double)cost * threadCount >= (double)totalCost * next)
+		{
+			bounds[next++] = i + 1;
+		}
+	}
+
+	std::vector<std::thread> workers;
+	for (unsigned int t = 1; t < threadCount; t++)
+	{
+		workers.push_back(std::thread(&TileRasterizer::binRange, this, bounds[t], bounds[t + 1], std::ref(bins[t])));
+	}
+	binRange(bounds[0], bounds[1], bins[0]);
+
+	for (size_t t = 0; t < workers.size(); t++)
+	{
+		workers[t].join();
+	}
+}
+
+/**
+ * This function rasterizes every binned tile. Threads take the next tile from a shared counter, so
+ * tiles crowded with primitives don't leave the other threads idle.
+ * 
+ * @param threadCount The number of threads to use.
+ */
+void TileRasterizer::rasterize(unsigned int threadCount)
+{
+	std::atomic<int> nextTile(0);
+	auto worker = [this, &nextTile]() {
+		std::vector<glm::vec3> pixels;
+		int tile;
+		while ((tile = nextTile.fetch_add(1)) < getTileCount())
+		{
+			rasterizeTile(tile, pixels);
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (unsigned int t = 1; t < threadCount; t++)
+	{
+		workers.push_back(std::thread(worker));
+	}
+	worker();
+
+	for (size_t t = 0; t < workers.size(); t++)
+	{
+		workers[t].join();
+	}
+}
+
+/**
+ * This function clears the canvas and forgets the binned primitives.
+ */
+void TileRasterizer::clear()
+{
+	std::fill(bits.begin(), bits.end(), 0);
+	bins.clear();
+	primitives = NULL;
+}
+
+/**
+ * The function tells whether a pixel of the canvas is set.
+ * 
+ * @param x The x-coordinate of the pixel.
+ * @param y The y-coordinate of the pixel.
+ * 
+ * @return true if some primitive covers the pixel.
+ */
+bool TileRasterizer::getPixel(int x, int y)
+{
+	if (x < 0 || y < 0 || x >= width || y >= height)
+		return false;
+
+	size_t tile = (size_t)(y / tileSize) * tilesX + x / tileSize;
+	int bit = (y % tileSize) * tileSize + x % tileSize;
+	return (bits[tile * wordsPerTile + bit / 64] >> (bit % 64)) & 1;
+}
+
+/**
+ * The function counts the set pixels of the canvas.
+ * 
+ * @return the number of pixels covered by at least one primitive.
+ */
+size_t TileRasterizer::countPixels()
+{
+	size_t count = 0;
+	for (size_t i = 0; i < bits.size(); i++) {
+		uint64_t word = bits[i];
+		// Clear the lowest set bit until none is left.
+		while (word != 0) {
+			word &= word - 1;
+			count++;
+		}
+	}
+	return count;
+}
+
+/**
+ * The function counts the tile references created by binning, a primitive counts once per tile.
+ * 
+ * @return the number of primitive indices stored in the bins.
+ */
+size_t TileRasterizer::getBinnedReferences()
+{
+	size_t references = 0;
+	for (size_t t = 0; t < bins.size(); t++) {
+		for (size_t tile = 0; tile < bins[t].size(); tile++) {
+			references += bins[t][tile].size();
+		}
+	}
+	return references;
+}
+
+/**
+ * This function bins a contiguous range of the primitives.
+ * 
+ * @param begin The index of the first primitive.
+ * @param end The index after the last primitive.
+ * @param tileBins The bins of the calling thread.
+ */
+void TileRasterizer::binRange(size_t begin, size_t end, TileBins& tileBins)
+{
+	for (size_t i = begin; i < end; i++)
+	{
+		const Primitive& primitive = (*primitives)[i];
+		if (primitive.kind == Primitive::LINE)
+			binLine(i, primitive, tileBins);
+		else
+			binCircle(i, primitive, tileBins);
+	}
+}
+
+/**
+ * This function adds a line to the tiles it crosses, row of tiles by row of tiles. In each row the
+ * line is clipped to the band of the row with Liang-Barsky, grown by half a pixel plus one because
+ * Bresenham pixels can be up to half a pixel away from the ideal line.
+ * 
+ * @param index The index of the line.
+ * @param line The line.
+ * @param tileBins The bins of the calling thread.
+ */
+void TileRasterizer::binLine(unsigned int index, const Primitive& line, TileBins& tileBins)
+{
+	int x1 = line.x1, y1 = line.y1, x2 = line.x2, y2 = line.y2;
+	int rowFirst = std::max(0, std::min(y1, y2) / tileSize);
+	int rowLast = std::min(tilesY - 1, std::max(y1, y2) / tileSize);
+	if (std::max(y1, y2) < 0)
+		return;
+
+	for (int ty = rowFirst; ty <= rowLast; ty++)
+	{
+		double bx1 = x1, by1 = y1, bx2 = x2, by2 = y2;
+		ClipRect band = { -1.0e18, ty * tileSize - 1.0, 1.0e18, (ty + 1.0) * tileSize };
+		if (!mathGL.clipLineLiangBarsky(bx1, by1, bx2, by2, band))
+			continue;
+
+		int columnFirst = std::max(0, (int)floor(std::min(bx1, bx2) - 1.0) / tileSize);
+		int columnLast = std::min(tilesX - 1, (int)floor(std::max(bx1, bx2) + 1.0) / tileSize);
+		if (std::max(bx1, bx2) + 1.0 < 0.0)
+			continue;
+
+		TileItem item = { index, 0, 0, 0, 0, 0 };
+		for (int tx = columnFirst; tx <= columnLast; tx++)
+		{
+			tileBins[ty * tilesX + tx].push_back(item);
+		}
+	}
+}
+
+/**
+ * This function walks a circle like BresenhamCircle does and splits each of its eight octants into
+ * arcs whose pixels fall in the same tile, adding every arc to the bins of its tile. Pixels outside
+ * the canvas are skipped.
+ * 
+ * @param index The index of the circle.
+ * @param circle The circle, center in (x1, y1) and radius in x2.
+ * @param tileBins The bins of the calling thread.
+ */
+void TileRasterizer::binCircle(unsigned int index, const Primitive& circle, TileBins& tileBins)
+{
+	int cx = circle.x1, cy = circle.y1, r = circle.x2;
+	if (cx + r < 0 || cy + r < 0 || cx - r >= width || cy - r >= height)
+		return;
+
+	// The arc being grown in each octant and the tile it lies in, -1 outside the canvas.
+	TileItem arcs[8];
+	int arcTiles[8];
+	for (int o = 0; o < 8; o++)
+	{
+		arcs[o].steps = 0;
+		arcTiles[o] = -1;
+	}
+
+	int x = 0;
+	int y = r;
+	int d = 3 - 2 * y;
+
+	while (y >= x)
+	{
+		for (int o = 0; o < 8; o++)
+		{
+			int px, py;
+			circleOctantPixel(circle, o, x, y, px, py);
+			int tile = tileOf(px, py);
+
+			if (tile != arcTiles[o] || arcs[o].steps == 0)
+			{
+				if (arcTiles[o] >= 0 && arcs[o].steps > 0)
+					tileBins[arcTiles[o]].push_back(arcs[o]);
+
+				TileItem arc = { index, o, x, y, d, 0 };
+				arcs[o] = arc;
+				arcTiles[o] = tile;
+			}
+			arcs[o].steps++;
+		}
+
+		x++;
+		if (d > 0)
+		{
+			y--;
+			d = d + 4 * (x - y) + 10;
+		}
+		else
+			d = d + 4 * x + 6;
+	}
+
+	for (int o = 0; o < 8; o++)
+	{
+		if (arcTiles[o] >= 0 && arcs[o].steps > 0)
+			tileBins[arcTiles[o]].push_back(arcs[o]);
+	}
+}
+
+/**
+ * The function finds the tile of a pixel.
+ * 
+ * @param x The x-coordinate of the pixel.
+ * @param y The y-coordinate of the pixel.
+ * 
+ * @return the index of the tile, row after row, or -1 if the pixel is outside the canvas.
+ */
+int TileRasterizer::tileOf(int x, int y)
+{
+	if (x < 0 || y < 0 || x >= width || y >= height)
+		return -1;
+	return (y / tileSize) * tilesX + x / tileSize;
+}
+
+/**
+ * The function reflects a point of the first octant of a circle into one of its eight octants, in
+ * the order of MathOGL::BresenhamCirclePoints.
+ * 
+ * @param circle The circle, center in (x1, y1).
+ * @param octant The octant, from 0 to 7.
+ * @param x The x of the BresenhamCircle walk.
+ * @param y The y of the BresenhamCircle walk.
+ * @param px Receives the x-coordinate of the pixel.
+ * @param py Receives the y-coordinate of the pixel.
+ */
+void TileRasterizer::circleOctantPixel(const Primitive& circle, int octant, int x, int y, int& px, int& py)
+{
+	static const int octants[8][3] = {
+		{ 1, 1, 0 }, { -1, 1, 0 }, { 1, -1, 0 }, { -1, -1, 0 },
+		{ 1, 1, 1 }, { -1, 1, 1 }, { 1, -1, 1 }, { -1, -1, 1 },
+	};
+	int cx = circle.x1, cy = circle.y1;
+	if (octants[octant][2] == 0)
+	{
+		px = cx + octants[octant][0] * x;
+		py = cy + octants[octant][1] * y;
+	}
+	else
+	{
+		px = cx + octants[octant][0] * y;
+		py = cy + octants[octant][1] * x;
+	}
+}
+
+/**
+ * This function rasterizes the work binned into one tile into its bitmap: lines clipped to the tile
+ * and circle arcs resumed from their saved walk state.
+ * 
+ * @param tile The index of the tile, row after row.
+ * @param pixels Scratch storage for the clipped lines, reused between tiles.
+ */
+void TileRasterizer::rasterizeTile(int tile, std::vector<glm::vec3>& pixels)
+{
+	int tx = tile % tilesX, ty = tile / tilesX;
+	int x0 = tx * tileSize, y0 = ty * tileSize;
+	ClipRect rect = tileRect(tx, ty);
+	uint64_t* tileBits = &bits[(size_t)tile * wordsPerTile];
+
+	for (size_t t = 0; t < bins.size(); t++)
+	{
+		const std::vector<TileItem>& tileBin = bins[t][tile];
+		for (size_t i = 0; i < tileBin.size(); i++)
+		{
+			const TileItem& item = tileBin[i];
+			const Primitive& primitive = (*primitives)[item.primitive];
+
+			if (primitive.kind == Primitive::LINE)
+			{
+				mathGL.drawLineClipped(primitive.x1, primitive.y1, primitive.x2, primitive.y2, rect, pixels);
+				for (size_t p = 0; p < pixels.size(); p++)
+				{
+					int bit = ((int)pixels[p].y - y0) * tileSize + ((int)pixels[p].x - x0);
+					tileBits[bit / 64] |= (uint64_t)1 << (bit % 64);
+				}
+				continue;
+			}
+
+			int x = item.x, y = item.y, d = item.d;
+			for (int step = 0; step < item.steps; step++)
+			{
+				int px, py;
+				circleOctantPixel(primitive, item.octant, x, y, px, py);
+				int bit = (py - y0) * tileSize + (px - x0);
+				tileBits[bit / 64] |= (uint64_t)1 << (bit % 64);
+
+				x++;
+				if (d > 0)
+				{
+					y--;
+					d = d + 4 * (x - y) + 10;
+				}
+				else
+					d = d + 4 * x + 6;
+			}
+		}
+	}
+}
+
+/**
+ * The function returns the pixels covered by a tile, cut at the border of the canvas.
+ * 
+ * @param tx The column of the tile.
+ * @param ty The row of the tile.
+ * 
+ * @return the rectangle of the tile, both borders included.
+ */
+ClipRect TileRasterizer::tileRect(int tx, int ty)
+{
+	ClipRect rect;
+	rect.xMin = tx * tileSize;
+	rect.yMin = ty * tileSize;
+	rect.xMax = std::min(width, (tx + 1) * tileSize) - 1;
+	rect.yMax = std::min(height, (ty + 1) * tileSize) - 1;
+	return rect;
+}
+
+/**
+ * This is a destructor for the TileRasterizer class.
+ */
+TileRasterizer::~TileRasterizer()
+{
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <stdint.h>
+
+#include <glm.hpp>
+
+#include "MathOGL.h"
+#include "PrimitiveQueue.h"
+
+/**
+ * Rasterizer for canvases much larger than the caches. Primitives are first binned into the square
+ * tiles of the canvas they may touch, then every tile is rasterized on its own by a pool of threads,
+ * so all the writes of a tile land in the few kilobytes of its tile-local bitmap and no two threads
+ * ever write to the same tile. Lines are clipped to each tile with drawLineClipped. Circles are walked
+ * once while binning and split into arcs that stay inside one tile, each saved with the state the
+ * BresenhamCircle walk has at its first pixel, so tiles resume the walk instead of repeating it.
+ *
+ * Pixels have integer coordinates in [0, width) x [0, height); line end points and circle centers are
+ * truncated like drawLineOctant does.
+ */
+class TileRasterizer
+{
+public:
+	TileRasterizer(int width, int height, int tileSize);
+
+	void bin(const std::vector<Primitive>& primitives, unsigned int threadCount);
+	void rasterize(unsigned int threadCount);
+	void clear();
+
+	bool getPixel(int x, int y);
+	size_t countPixels();
+	int getTileCount() { return tilesX * tilesY; }
+	size_t getBinnedReferences();
+
+	~TileRasterizer();
+
+private:
+	int width, height, tileSize;
+	int tilesX, tilesY;
+	// 64-bit words of the bitmap of one tile, row after row.
+	int wordsPerTile;
+
+	/**
+	 * Work of one primitive inside one tile: a whole line, or an arc of one octant of a circle with
+	 * the x, y and d of the BresenhamCircle walk at its first pixel.
+	 */
+	struct TileItem
+	{
+		unsigned int primitive;
+		int octant;
+		int x, y, d;
+		int steps;
+	};
+	typedef std::vector<std::vector<TileItem>> TileBins;
+
+	MathOGL mathGL;
+	const std::vector<Primitive>* primitives;
+	// Work of every tile, one set of bins per binning thread so binning needs no locks.
+	std::vector<TileBins> bins;
+	std::vector<uint64_t> bits;
+
+	void binRange(size_t begin, size_t end, TileBins& tileBins);
+	void binLine(unsigned int index, const Primitive& line, TileBins& tileBins);
+	void binCircle(unsigned int index, const Primitive& circle, TileBins& tileBins);
+	int tileOf(int x, int y);
+	void rasterizeTile(int tile, std::vector<glm::vec3>& pixels);
+	static void circleOctantPixel(const Primitive& circle, int octant, int x, int y, int& px, int& py);
+	ClipRect tileRect(int tx, int ty);
+
+	TileRasterizer(const TileRasterizer&);
+	TileRasterizer& operator=(const TileRasterizer&);
+};
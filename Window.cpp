@@ -14,9 +14,14 @@ Window::Window()
 		keys[i] = 0;
 	}
 
+	lastX = 0.0f;
+	lastY = 0.0f;
 	xChange = 0.0f;
 	yChange = 0.0f;
 	mouseFirstMoved = true;
+	keysHeld = 0;
+	inputPending = true;
+	lastInputTime = 0.0;
 }
 
 /**
@@ -36,9 +41,14 @@ Window::Window(GLint windowWidth, GLint windowHeight)
 		keys[i] = 0;
 	}
 
+	lastX = 0.0f;
+	lastY = 0.0f;
 	xChange = 0.0f;
 	yChange = 0.0f;
 	mouseFirstMoved = true;
+	keysHeld = 0;
+	inputPending = true;
+	lastInputTime = 0.0;
 }
 
 /**
@@ -102,7 +112,7 @@ int Window::Initialise()
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-	glLineWidth(20.0f);
+	// Lines keep the default width of 1; thick lines are rasterized into spans by MathOGL.
 	glPointSize(20.0f);
 	glEnable(GL_LINE_SMOOTH);
 
@@ -119,6 +129,19 @@ void Window::createCallbacks()
 {
 	glfwSetKeyCallback(mainWindow, handleKeys);
 	glfwSetCursorPosCallback(mainWindow, handleMouse);
+	glfwSetWindowRefreshCallback(mainWindow, handleRefresh);
+}
+
+/**
+ * The function tells whether any input or window event arrived since the last call, and clears it.
+ * 
+ * @return true if a key, mouse or refresh event is pending.
+ */
+bool Window::consumeInput()
+{
+	bool pending = inputPending;
+	inputPending = false;
+	return pending;
 }
 
 /**
@@ -168,16 +191,23 @@ void Window::handleKeys(GLFWwindow* window, int key, int code, int action, int m
 		glfwSetWindowShouldClose(window, GL_TRUE);
 	}
 
+	theWindow->inputPending = true;
+	theWindow->lastInputTime = glfwGetTime();
+
 	// validation, in case we catch bizarre characters
 	if (key >= 0 && key < 1024)
 	{
 		if (action == GLFW_PRESS)
 		{
+			if (!theWindow->keys[key])
+				theWindow->keysHeld++;
 			theWindow->keys[key] = true;
 			//printf("Pressed: %d\n",key);
 		}
 		else if (action == GLFW_RELEASE)
 		{
+			if (theWindow->keys[key])
+				theWindow->keysHeld--;
 			theWindow->keys[key] = false;
 			//printf("Released: %d\n",key);
 		}
@@ -209,9 +239,24 @@ void Window::handleMouse(GLFWwindow* window, double xPos, double yPos)
 
 	theWindow->lastX = xPos;
 	theWindow->lastY = yPos;
+	theWindow->inputPending = true;
+	theWindow->lastInputTime = glfwGetTime();
 	//printf("x:%.6f, y:%.6f\n", theWindow->xChange, theWindow->yChange);
 }
 
+/**
+ * This function flags the window for redrawing when its contents are damaged, for example after
+ * being uncovered or resized.
+ * 
+ * @param window A pointer to the GLFW window that needs to be redrawn.
+ */
+void Window::handleRefresh(GLFWwindow* window)
+{
+	Window* theWindow = static_cast<Window*>(glfwGetWindowUserPointer(window));
+	theWindow->inputPending = true;
+	theWindow->lastInputTime = glfwGetTime();
+}
+
 /**
  * This function destroys the GLFW window and terminates the GLFW library.
  */
@@ -23,7 +23,13 @@ public:
 	GLfloat getXChange();
 	GLfloat getYChange();
 
+	bool consumeInput();
+	double getLastInputTime() { return lastInputTime; }
+	bool isAnyKeyHeld() { return keysHeld > 0; }
+
 	void swapBuffers() { glfwSwapBuffers(mainWindow); }
+	void makeContextCurrent() { glfwMakeContextCurrent(mainWindow); }
+	void releaseContext() { glfwMakeContextCurrent(NULL); }
 
 	~Window();
 
@@ -40,8 +46,12 @@ private:
 	bool mouseFirstMoved;
 
 	bool keys[1024];
+	int keysHeld;
+	bool inputPending;
+	double lastInputTime;
 
 	void createCallbacks();
 	static void handleKeys(GLFWwindow* window, int key, int code, int action, int mode);
 	static void handleMouse(GLFWwindow* window, double xPos, double yPos);
+	static void handleRefresh(GLFWwindow* window);
 };
\ No newline at end of file
@@ -4,6 +4,15 @@
 #include <string.h>
 #include <cmath>
 #include <vector>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include <limits.h>
 
 #include <GL\glew.h>
 #include <GLFW\glfw3.h>
@@ -13,13 +22,27 @@
 #include <gtc\type_ptr.hpp>
 
 #include "Window.h"
-#include "Mesh.h"
-#include "VectorMesh.h"
+#include "GeometryStore.h"
 #include "Shader.h"
 #include "Camera.h"
 #include "MathOGL.h"
-#include "CartesianMesh.h"
-#include "PointMesh.h"
+#include "Backdrop.h"
+#include "Benchmark.h"
+#include "SceneArena.h"
+#include "FrameMonitor.h"
+#include "SnapshotExchange.h"
+#include "PrimitiveQueue.h"
+#include "PixelRange.h"
+#include "ReflectedCircle.h"
+#include "RasterFile.h"
+#include "PixelSet.h"
+#include "MortonIndex.h"
+#include "SpatialHash.h"
+#include "SparseCanvas.h"
+#include "CanvasView.h"
+#include "AlgorithmComparison.h"
+#include "SdfPrimitives.h"
+#include "TempFile.h"
 
 //------------------------------------------------------------------------------------------------------------
 // Variables and objects declaration
@@ -34,23 +57,136 @@ double oyf = 0;
 double ozf = 0;
 double radius = 0;
 unsigned int nVectors = 0;
+// Segments joining adjacent pixels before simplification, nVectors counts the ones drawn.
+unsigned int nPixelSegments = 0;
+// Largest distance in pixels a simplified segment may stray from the rasterized pixels, 0 keeps
+// the drawn shape exact and only merges collinear runs.
+double simplifyTolerance = 0.0;
+// Width in pixels of the drawn segments. Above 1 they are rasterized into spans and drawn as filled
+// quads, since wide GL lines are deprecated and drivers disagree on them.
+double lineWidth = 1.0;
+// When true circles are drawn from one octant with 8 reflected instances, see ReflectedCircle.
+bool circleReflected = false;
+// Raster file the pixels are exported to, empty to not export them.
+std::string exportPath;
+// When true the exported pixels are sorted in Morton (Z) order, so neighbours on screen are close in
+// the file, instead of the order they were rasterized in.
+bool exportZOrder = false;
+// Raster file drawn by LOAD, and its mapping, kept open until the geometry store has uploaded it.
+std::string importPath;
+RasterFile importFile;
+// Lines and circles in each sweep of CMP, the CSV file its results are written to (empty for none)
+// and whether the rasterizers are then drawn side by side in a window.
+unsigned int comparisonSteps = 360;
+std::string reportPath;
+bool comparisonWindow = false;
 int widthWin = 800;
 int heightWin = 600;
+// Visible part of the coordinate space, centered on the origin. Primitives are clipped to it.
+ClipRect coordinateSpace = { -400.0, -300.0, 400.0, 300.0 };
+// When true the loop sleeps until input arrives and only redraws when something changed.
+bool renderOnDemand = false;
+// Longest time the on-demand loop sleeps without waking up, in seconds.
+const double idleTimeout = 0.5;
+// When true input and camera updates run on the main thread and drawing on a render thread.
+bool renderThreaded = false;
+// When true producer threads keep submitting primitives to primitiveQueue while the viewer runs.
+bool liveFeed = false;
+// Longest time a frame may spend rasterizing queued primitives, in milliseconds.
+const double feedBudgetMs = 2.0;
 
 const float toRadians = 3.14159265f / 180.0f;
 const float nearPlane = 0.1f;
 const float farPlane = 100.0f;
-const float deltaPlane = glm::abs(farPlane - nearPlane);
 const glm::vec3 windowColor = glm::vec3(153, 75, 214);
 
 Window mainWindow;
-std::vector<Mesh*> meshList;
-std::vector<VectorMesh*> vectorMeshList;
-std::vector<PointMesh*> pointsList;
-std::vector<Shader> shaderList;
+std::vector<Shader*> shaderList;
+// Every primitive of the scene is a sub-allocation of this store, drawn with one multi-draw per mode.
+GeometryStore* geometry;
+// The circle of MPC and BCA when circleReflected is set, NULL otherwise.
+ReflectedCircle* reflectedCircle = NULL;
+// The lines and circles of the scene drawn as distance fields, one quad each, and their shader; NULL
+// unless chosen at startup. The pixel meshes are kept so that both paths can be compared.
+SdfPrimitives* sdfPrimitives = NULL;
+Shader* sdfShader = NULL;
+// Toggled with the V and B keys: whether sdfPrimitives is drawn instead of the pixels, and whether it
+// only lights the pixels Bresenham would.
+std::atomic<bool> sdfShown(true);
+std::atomic<bool> sdfSnap(false);
+// GPU time of the frames drawn with pixels [0] and with distance fields [1]. The timer query of a
+// frame is read back on a later one, so it never stalls the pipeline.
+GLuint frameTimeQuery = 0;
+bool frameTimePending = false;
+bool frameTimeSdf = false;
+unsigned int timedFrames[2] = { 0, 0 };
+double gpuFrameMs[2] = { 0.0, 0.0 };
+// Pixels of the scene in sparse canvas mode, drawn through canvasView; NULL otherwise.
+SparseCanvas* sparseCanvas = NULL;
+CanvasView* canvasView = NULL;
+// Most memory the resident tiles of sparseCanvas may take before they are paged out.
+const size_t canvasMemoryCap = (size_t)256 << 20;
+// Name of the page file of sparseCanvas, created in the temporary directory.
+static const char* canvasPageName = "canvas.pages";
+// Most canvas tiles uploaded per frame, and whether visible tiles are still waiting for their upload.
+const unsigned int tileUploadsPerFrame = 8;
+bool canvasStreaming = false;
+// Largest window in sparse canvas mode, where the coordinate space can be far bigger than the screen.
+const int maxCanvasWindow = 1280;
+// Handles given to the pixels written to sparseCanvas, counting on from the meshes of the store.
+unsigned int canvasPrimitives = 0;
 Camera camera;
-CartesianMesh* plane;
+// Ground, grid and axes, drawn procedurally under the scene, and their shader.
+Backdrop* backdrop = NULL;
+Shader* backdropShader = NULL;
+// Distance between the lines of the ground grid, 0 for no grid.
+double gridSpacing = 1.0;
 MathOGL mathGL = MathOGL();
+// Owns the geometry store and shaders of the scene, see CreateObjects and CreateShaders.
+SceneArena sceneArena;
+
+/**
+ * Immutable snapshot of everything the render thread needs to draw a frame, published by the
+ * input/update thread through frameExchange.
+ */
+struct FrameState
+{
+	glm::mat4 view;
+	// glfwGetTime() of the input this state answers to, negative if none.
+	double inputTime;
+};
+
+SnapshotExchange<FrameState> frameExchange;
+// Primitives submitted by the live feed, drained by whichever thread owns the geometry store.
+PrimitiveQueue primitiveQueue(1 << 16);
+std::vector<std::thread> feedProducers;
+std::atomic<bool> feedRunning(false);
+std::atomic<unsigned long long> feedSubmitted(0);
+std::atomic<unsigned long long> feedDropped(0);
+unsigned long long feedDrawn = 0;
+// Every pixel drawn by the live feed so far, so overlapping primitives don't draw a pixel twice.
+PixelSet feedPixelSet;
+unsigned long long feedPixelsRasterized = 0;
+unsigned long long feedPixelsDrawn = 0;
+// When true the P key picks the pixel at the centre of the screen through pickIndex.
+bool centrePick = false;
+// Every displayed pixel with the handle of its mesh, filled as primitives are added. The live feed
+// adds to it from the render thread, so it is guarded by pickMutex.
+SpatialHash pickIndex;
+std::mutex pickMutex;
+// Handle given in pickIndex to the pixels of reflectedCircle, which is not a mesh of the store.
+const unsigned int reflectedCirclePrimitive = UINT_MAX;
+// Largest distance from the cursor ray at which a pixel is picked, in pixels.
+const float pickRadius = 4.0f;
+unsigned int pickQueries = 0;
+double pickTotalUs = 0.0;
+double pickMaxUs = 0.0;
+std::atomic<bool> renderThreadRunning(false);
+// Wakes the on-demand render thread when a FrameState is published, the live feed submits
+// primitives or the loop ends, so it sleeps instead of polling while nothing changes.
+std::mutex renderWakeMutex;
+std::condition_variable renderWake;
+bool renderWakePending = false;
 
 GLfloat cubeW = 1.0f;
 GLfloat deltaTime = 0.0f;
@@ -62,6 +198,17 @@ static const char* vShader = "Shaders/shader.vert";
 // Fragment Shader
 static const char* fShader = "Shaders/shader.frag";
 
+// Vertex Shader of the circles drawn as 8 reflections of one octant
+static const char* vOctantShader = "Shaders/octant.vert";
+
+// Vertex and Fragment Shaders of the ground, grid and axes
+static const char* vBackdropShader = "Shaders/backdrop.vert";
+static const char* fBackdropShader = "Shaders/backdrop.frag";
+
+// Vertex and Fragment Shaders of the lines and circles drawn as distance fields
+static const char* vSdfShader = "Shaders/sdf.vert";
+static const char* fSdfShader = "Shaders/sdf.frag";
+
 //------------------------------------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------------------------------------
@@ -79,6 +226,7 @@ static const char* fShader = "Shaders/shader.frag";
  */
 std::vector<glm::vec3> reorder_points_adjacent(std::vector<glm::vec3> puntos) {
 	std::vector<glm::vec3> resultado;
+	resultado.reserve(puntos.size());
 	resultado.push_back(puntos[0]);
 
 	while (resultado.size() < puntos.size()) {
@@ -103,57 +251,91 @@ std::vector<glm::vec3> reorder_points_adjacent(std::vector<glm::vec3> puntos) {
 }
 
 /**
- * The function draws vectors between points in a vector and adds them to a list.
+ * The function simplifies a polyline of rasterized pixels and adds it to the geometry store, so the
+ * number of segments drawn follows the shape instead of the number of pixels.
  * 
- * @param points A vector of glm::vec3 objects representing the points in 3D space that the vectors
- * will be drawn between.
+ * @param points The pixels of the polyline, in drawing order.
+ * @param closed Whether the last point is also joined to the first one.
  */
-void drawVectors(std::vector<glm::vec3> points)
+void addSimplifiedPolyline(const std::vector<glm::vec3>& points, bool closed)
 {
-	double numberOfPoints = points.size();
-	for (unsigned int i = 1; i < numberOfPoints; i++) {
-		VectorMesh* vecs = new VectorMesh(points[i].x, points[i].y, points[i].z, 
-			glm::vec3(points[i-1].x, points[i-1].y, points[i-1].z));
-		vecs->drawVector();
-		vectorMeshList.push_back(vecs);
-		nVectors++;
+	std::vector<glm::vec3> simplified = mathGL.simplifyPolyline(points, simplifyTolerance);
+	if (lineWidth > 1.0)
+	{
+		std::vector<PixelSpan> spans, segment;
+		size_t segmentCount = simplified.empty() ? 0 : simplified.size() - 1 + (closed && simplified.size() > 2);
+		for (size_t i = 0; i < segmentCount; i++)
+		{
+			const glm::vec3& from = simplified[i];
+			const glm::vec3& to = simplified[(i + 1) % simplified.size()];
+			mathGL.thickLineSpans(from.x, from.y, to.x, to.y, lineWidth, segment);
+			spans.insert(spans.end(), segment.begin(), segment.end());
+		}
+		geometry->addSpans(spans);
+	}
+	else
+	{
+		geometry->addPolyline(simplified, closed);
 	}
+
+	// addPolyline only closes polylines of more than two points.
+	nPixelSegments += points.empty() ? 0 : points.size() - 1 + (closed && points.size() > 2);
+	nVectors += simplified.empty() ? 0 : simplified.size() - 1 + (closed && simplified.size() > 2);
 }
 
 /**
- * This function draws vectors using Bresenham's algorithm based on a list of 3D points.
+ * The function adds the vectors between consecutive points to the geometry store.
  * 
- * @param points A vector of glm::vec3 points representing the endpoints of the vectors to be drawn
- * using Bresenham's line algorithm.
+ * @param points A vector of glm::vec3 objects representing the points in 3D space that the vectors
+ * will be drawn between.
  */
-void drawVectorsBresenh(std::vector<glm::vec3> points)
+void drawVectors(std::vector<glm::vec3> points)
 {
-	double numberOfPoints = points.size();
-	for (unsigned int i = 1; i < numberOfPoints; i++) {
-		VectorMesh* vecs = new VectorMesh(points[i].x, points[i].y, points[i].z,
-			glm::vec3(points[i - 1].x, points[i - 1].y, points[i - 1].z));
-		vecs->drawVector();
-		vectorMeshList.push_back(vecs);
-		nVectors++;
-	}
-	// links final vector with initial one
-	VectorMesh* vecs = new VectorMesh(points[0].x, points[0].y, points[0].z,
-		glm::vec3(points[nVectors].x, points[nVectors].y, points[nVectors].z));
-	vecs->drawVector();
-	vectorMeshList.push_back(vecs);
-	nVectors++;
+	addSimplifiedPolyline(points, false);
 }
 
 /**
- * This function renders a list of vectors using their respective meshes.
+ * This function draws the arcs of a circle left after clipping. The pixels are sorted by their angle
+ * around the centre and only the pixels touching each other are joined, so no chord is drawn across
+ * the hidden parts of the circle.
+ * 
+ * @param x_center The x-coordinate of the center of the circle.
+ * @param y_center The y-coordinate of the center of the circle.
+ * @param points The visible pixels of the circle, in any order.
  */
-void renderVectors() 
+void drawCircleArcs(double x_center, double y_center, std::vector<glm::vec3> points)
 {
-	for (unsigned int i = 0; i < nVectors; i++) {
-		vectorMeshList[i]->renderVector();
+	if (points.empty())
+		return;
+
+	std::sort(points.begin(), points.end(), [&](const glm::vec3& a, const glm::vec3& b) {
+		return atan2(a.y - y_center, a.x - x_center) < atan2(b.y - y_center, b.x - x_center);
+	});
+	auto touching = [&](size_t a, size_t b) {
+		return fabs(points[a].x - points[b].x) <= 1.0f && fabs(points[a].y - points[b].y) <= 1.0f;
+	};
+
+	// The sort cuts the circle at 180 degrees, so the arcs start after the first gap instead.
+	size_t count = points.size(), first = 0;
+	while (first < count && touching(first, (first + count - 1) % count))
+		first++;
+	if (first == count)
+	{
+		addSimplifiedPolyline(points, true);
+		return;
 	}
-}
+	std::rotate(points.begin(), points.begin() + first, points.end());
 
+	size_t arcStart = 0;
+	for (size_t i = 1; i <= count; i++)
+	{
+		if (i == count || !touching(i - 1, i))
+		{
+			addSimplifiedPolyline(std::vector<glm::vec3>(points.begin() + arcStart, points.begin() + i), false);
+			arcStart = i;
+		}
+	}
+}
 
 /**
  * This function draws a circle using the midpoint algorithm and reorders the points to cover all four
@@ -169,17 +351,13 @@ void drawMidPointCircle(double x_center, double y_center, std::vector<glm::vec3>
 	std::vector<glm::vec3> listPoints;
 
 	double numberOfPoints = points.size();
+	listPoints.reserve(points.size());
 	// Quadrant - 1 x = +, y = +
+	addSimplifiedPolyline(points, false);
 	// we store here Quadrant 2's points
 	listPoints.push_back(glm::vec3(-points[0].x + 2 * x_center, points[0].y, points[0].z));
 	for (unsigned int i = 1; i < numberOfPoints; i++) {
-		VectorMesh* vecs = new VectorMesh(points[i].x, points[i].y, points[i].z,
-			glm::vec3(points[i - 1].x, points[i - 1].y, points[i - 1].z));
-		vecs->drawVector();
 		listPoints.push_back(glm::vec3(-points[i].x + 2 * x_center, points[i].y, points[i].z));
-		printf("point1: (%f, %f, %f)\n", points[i].x, points[i].y, points[i].z);
-		vectorMeshList.push_back(vecs);
-		nVectors++;
 	}
 
 	// reorder points
@@ -187,17 +365,12 @@ void drawMidPointCircle(double x_center, double y_center, std::vector<glm::vec3>
 	listPoints.clear();
 
 	// Quadrant - 2 x = -, y = +
+	addSimplifiedPolyline(points, false);
 	// we store here Quadrant 3's points
 	// NOTE: x is store as it comes due to points vector has its x-axis values stored as negative.
 	listPoints.push_back(glm::vec3(points[0].x, -points[0].y + 2 * y_center, points[0].z));
 	for (unsigned int i = 1; i < numberOfPoints; i++) {
-		VectorMesh* vecs = new VectorMesh(points[i].x, points[i].y, points[i].z,
-			glm::vec3(points[i - 1].x, points[i - 1].y, points[i - 1].z));
-		vecs->drawVector();
 		listPoints.push_back(glm::vec3(points[i].x, -points[i].y + 2 * y_center, points[i].z));
-		printf("point2: (%f, %f, %f)\n", points[i].x, points[i].y, points[i].z);
-		vectorMeshList.push_back(vecs);
-		nVectors++;
 	}
 
 	// reorder points
@@ -205,17 +378,12 @@ void drawMidPointCircle(double x_center, double y_center, std::vector<glm::vec3>
 	listPoints.clear();
 
 	// Quadrant - 3 x = -, y = -
+	addSimplifiedPolyline(points, false);
 	// we store here Quadrant 4's points
 	// NOTE: same logic applied as before, we must take into account the previous signs.
 	listPoints.push_back(glm::vec3(-points[0].x + 2 * x_center, points[0].y, points[0].z));
 	for (unsigned int i = 1; i < numberOfPoints; i++) {
-		VectorMesh* vecs = new VectorMesh(points[i].x, points[i].y, points[i].z,
-			glm::vec3(points[i - 1].x, points[i - 1].y, points[i - 1].z));
-		vecs->drawVector();
 		listPoints.push_back(glm::vec3(-points[i].x + 2 * x_center, points[i].y, points[i].z));
-		printf("point3: (%f, %f, %f)\n", points[i].x, points[i].y, points[i].z);
-		vectorMeshList.push_back(vecs);
-		nVectors++;
 	}
 
 	// reorder points
@@ -223,24 +391,76 @@ void drawMidPointCircle(double x_center, double y_center, std::vector<glm::vec3>
 	listPoints.clear();
 
 	// Quadrant - 4 x = +, y = -
-	for (unsigned int i = 1; i < numberOfPoints; i++) {
-		VectorMesh* vecs = new VectorMesh(points[i].x, points[i].y, points[i].z,
-			glm::vec3(points[i - 1].x, points[i - 1].y, points[i - 1].z));
-		vecs->drawVector();
-		printf("point4: (%f, %f, %f)\n", points[i].x, points[i].y, points[i].z);
-		vectorMeshList.push_back(vecs);
-		nVectors++;
+	addSimplifiedPolyline(points, false);
+}
+
+/**
+ * This function adds the pixels of a primitive to pickIndex when cursor picking is on.
+ * 
+ * @param pixels The pixels of the primitive.
+ * @param count The number of pixels.
+ * @param primitive The handle of the mesh drawing them.
+ */
+void IndexPixels(const glm::vec3* pixels, size_t count, unsigned int primitive)
+{
+	if (!centrePick)
+		return;
+
+	std::lock_guard<std::mutex> lock(pickMutex);
+	pickIndex.insert(pixels, count, primitive);
+}
+
+/**
+ * This function adds the pixels of a primitive to the scene: to sparseCanvas in sparse canvas mode,
+ * or as a mesh of the geometry store otherwise, and to pickIndex.
+ * 
+ * @param pixels The pixels of the primitive.
+ * @param count The number of pixels.
+ */
+void AddPixels(const glm::vec3* pixels, size_t count)
+{
+	if (sparseCanvas != NULL)
+	{
+		sparseCanvas->write(pixels, count);
+		IndexPixels(pixels, count, geometry->getMeshCount() + canvasPrimitives++);
+	}
+	else
+	{
+		IndexPixels(pixels, count, geometry->addPoints(pixels, count));
 	}
 }
 
 /**
- * The function renders a circle by rendering a list of vectors.
+ * This function hands the pixels of one circle octant to reflectedCircle, which draws the other seven
+ * as reflections on the GPU instead of mirroring and reordering them here.
+ * 
+ * @param octant The offsets of the octant pixels from the centre (ox, oy), in drawing order.
  */
-void renderCircle()
+void drawReflectedCircle(const std::vector<glm::vec3>& octant)
 {
-	for (unsigned int i = 0; i < nVectors; i++) {
-		vectorMeshList[i]->renderVector();
+	reflectedCircle->setOctant(glm::vec3(ox, oy, 0), octant);
+
+	// The GPU draws the reflections, but picking needs every pixel of the circle.
+	if (centrePick)
+	{
+		std::vector<glm::vec3> circle;
+		circle.reserve(octant.size() * 8);
+		for (size_t i = 0; i < octant.size(); i++)
+		{
+			float x = octant[i].x, y = octant[i].y;
+			const float reflections[8][2] = { { x, y }, { y, x }, { -x, y }, { -y, x }, { x, -y }, { y, -x }, { -x, -y }, { -y, -x } };
+			for (int r = 0; r < 8; r++)
+			{
+				circle.push_back(glm::vec3(ox + reflections[r][0], oy + reflections[r][1], 0));
+			}
+		}
+		IndexPixels(circle.empty() ? NULL : circle.data(), circle.size(), reflectedCirclePrimitive);
 	}
+	printf("points: %zu (one octant, drawn as 8 instances)\n", octant.size());
+
+	unsigned int segments = reflectedCircle->getStripVertexCount() > 0 ? 8 * (reflectedCircle->getStripVertexCount() - 1) : 0;
+	nPixelSegments += segments;
+	nVectors += segments;
 }
 
 /**
@@ -260,34 +480,13 @@ void printMatrix(glm::mat4 matrix) {
 }
 
 /**
- * The function creates objects such as meshes, planes, and points, and draws them using various
- * algorithms.
+ * The function asks the user for the parameters of the chosen algorithm. It runs on the main thread
+ * before the startup work is split, since the rasterization thread must not touch std::cin.
  */
-void CreateObjects()
+void ReadParameters()
 {
-	unsigned int surfaceIndices[] = {
-		0, 2, 3,
-		0, 3, 1,
-	};
-
-	GLfloat surfaceVertices[] = {
-		// x		y			z
-		-deltaPlane, 0.0f, deltaPlane,
-		deltaPlane, 0.0f, deltaPlane,
-		-deltaPlane, 0.0f, -deltaPlane,
-		deltaPlane, 0.0f, -deltaPlane,
-	};
-
-
-	Mesh* obj1 = new Mesh();
-	obj1->CreateMesh(surfaceVertices, surfaceIndices, 24, 6);
-	meshList.push_back(obj1);
-
-	plane = new CartesianMesh(51, deltaPlane, deltaPlane);
-	plane->drawPlane();
-
-	// BIA = Basic incremental algorithm.
-	if (algorithm_name == "BIA")
+	// BIA, DDA and BA draw a line between two points.
+	if (algorithm_name == "BIA" || algorithm_name == "DDA" || algorithm_name == "BA")
 	{
 		std::cout << "Ingrese la coordenada x del punto inicial:\n";
 		std::cin >> ox;
@@ -297,33 +496,208 @@ void CreateObjects()
 		std::cin >> oxf;
 		std::cout << "Ingrese la coordenada y del punto final:\n";
 		std::cin >> oyf;
-		
-		points = mathGL.drawLineBasic(ox, oy, oxf, oyf);
-
-		PointMesh* pointMesh = new PointMesh(points);
-		pointMesh->drawPoints();
-		pointsList.push_back(pointMesh);
-		printf("points: %d\n", points.size());
+	}
+	// MPC and BCA draw a circle.
+	else if (algorithm_name == "MPC" || algorithm_name == "BCA")
+	{
+		std::cout << "Ingrese la coordenada x del centro del circulo:\n";
+		std::cin >> ox;
+		std::cout << "Ingrese la coordenada y del centro del circulo:\n";
+		std::cin >> oy;
+		std::cout << "Ingrese el radio del circulo:\n";
+		std::cin >> radius;
 
-		drawVectors(points);
+		std::string reflectMode;
+		std::cout << "Dibujar el circulo reflejando un octante en la GPU (8 instancias)? (S/N):\n";
+		std::cin >> reflectMode;
+		circleReflected = (reflectMode == "S" || reflectMode == "s");
 	}
-	// DDA = Digital Differential Analyzer.
-	else if (algorithm_name == "DDA")
+	// CMP runs the five rasterizers on sweeps built from one line and one radius.
+	else if (algorithm_name == "CMP")
 	{
-		std::cout << "Ingrese la coordenada x del punto inicial:\n";
+		std::cout << "Ingrese la coordenada x del punto inicial de la linea (y centro de los circulos):\n";
 		std::cin >> ox;
-		std::cout << "Ingrese la coordenada y del punto inicial:\n";
+		std::cout << "Ingrese la coordenada y del punto inicial de la linea (y centro de los circulos):\n";
 		std::cin >> oy;
-		std::cout << "Ingrese la coordenada x del punto final:\n";
+		std::cout << "Ingrese la coordenada x del punto final de la linea:\n";
 		std::cin >> oxf;
-		std::cout << "Ingrese la coordenada y del punto final:\n";
+		std::cout << "Ingrese la coordenada y del punto final de la linea:\n";
 		std::cin >> oyf;
+		std::cout << "Ingrese el radio del circulo mas grande:\n";
+		std::cin >> radius;
+		std::cout << "Cuantas lineas (rotadas) y circulos (concentricos) probar?:\n";
+		std::cin >> comparisonSteps;
+		comparisonSteps = std::max(1u, comparisonSteps);
+
+		std::cout << "Ruta del informe CSV de la comparacion (N = solo consola):\n";
+		std::cin >> reportPath;
+		if (reportPath == "N" || reportPath == "n")
+		{
+			reportPath.clear();
+		}
 
-		points = mathGL.drawLineDDA(ox, oy, oxf, oyf);
+		std::string windowMode;
+		std::cout << "Mostrar los cinco algoritmos lado a lado en una ventana? (S/N):\n";
+		std::cin >> windowMode;
+		comparisonWindow = (windowMode == "S" || windowMode == "s");
+		return;
+	}
+	// LOAD draws the pixels of a raster file exported before.
+	else if (algorithm_name == "LOAD")
+	{
+		std::cout << "Ingrese la ruta del archivo binario de pixeles:\n";
+		std::cin >> importPath;
+		return;
+	}
+
+	std::cout << "Tolerancia para simplificar los segmentos, en pixeles (0 = solo unir pixeles colineales):\n";
+	std::cin >> simplifyTolerance;
 
-		PointMesh* pointMesh = new PointMesh(points);
-		pointMesh->drawPoints();
-		pointsList.push_back(pointMesh);
+	std::cout << "Grosor de los segmentos, en pixeles (1 = linea simple):\n";
+	std::cin >> lineWidth;
+
+	std::cout << "Ruta del archivo binario donde exportar los pixeles (N = no exportar):\n";
+	std::cin >> exportPath;
+	if (exportPath == "N" || exportPath == "n")
+	{
+		exportPath.clear();
+		return;
+	}
+
+	std::string zOrder;
+	std::cout << "Exportar los pixeles en orden Z (Morton)? (S/N):\n";
+	std::cin >> zOrder;
+	exportZOrder = (zOrder == "S" || zOrder == "s");
+}
+
+/**
+ * The function runs every rasterizer of MathOGL on the sweeps of CMP: the line entered rotated around
+ * its starting point, and concentric circles up to the radius entered. The results are printed and
+ * written to reportPath when one was given.
+ */
+void RunComparison()
+{
+	AlgorithmComparison comparison;
+	comparison.sweepLines(ox, oy, oxf, oyf, comparisonSteps);
+	comparison.sweepCircles(ox, oy, radius, comparisonSteps);
+
+	printf("comparison: %u lines rotated around (%g, %g), %u circles up to radius %g\n", comparisonSteps, ox, oy,
+		comparisonSteps, radius);
+	comparison.print(stdout);
+	if (!reportPath.empty() && comparison.writeReport(reportPath.c_str()))
+	{
+		printf("comparison: report written to %s\n", reportPath.c_str());
+	}
+}
+
+/**
+ * The function clips a line entered by the user to the coordinate space with Liang-Barsky and reports
+ * how much of it is visible.
+ * 
+ * @param x1 The x-coordinate of the starting point, moved inside the coordinate space.
+ * @param y1 The y-coordinate of the starting point, moved inside the coordinate space.
+ * @param x2 The x-coordinate of the end point, moved inside the coordinate space.
+ * @param y2 The y-coordinate of the end point, moved inside the coordinate space.
+ * 
+ * @return false if the line is entirely outside the coordinate space.
+ */
+bool ClipLine(double& x1, double& y1, double& x2, double& y2)
+{
+	double length = sqrt((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1));
+
+	if (!mathGL.clipLineLiangBarsky(x1, y1, x2, y2, coordinateSpace))
+	{
+		printf("clipping: la linea queda fuera del espacio coordenado, no se rasteriza\n");
+		return false;
+	}
+
+	double visible = sqrt((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1));
+	printf("clipping: %.1f%% de la linea es visible\n", length > 0.0 ? 100.0 * visible / length : 100.0);
+	return true;
+}
+
+/**
+ * The function predicts the pixels CreateObjects adds to the geometry store, from the exact counts of
+ * MathOGL. A clipped line can't have more pixels than the whole line, nor more than a walk moving
+ * forward on both axes meets in the coordinate space; each octant of a circle is such a walk too.
+ * 
+ * @return the number of pixels expected for the chosen algorithm.
+ */
+size_t PredictPixels()
+{
+	size_t spaceWalk = (size_t)(coordinateSpace.xMax - coordinateSpace.xMin) + (size_t)(coordinateSpace.yMax - coordinateSpace.yMin) + 2;
+	size_t dda = MathOGL::countLineDDA(ox, oy, oxf, oyf);
+
+	if (algorithm_name == "BIA")
+		return std::min(MathOGL::countLineBasic(ox, oy, oxf, oyf), spaceWalk);
+	if (algorithm_name == "DDA")
+		return std::min(dda, spaceWalk);
+	if (algorithm_name == "BA")
+		return std::min(MathOGL::countLineBres(ox, oy, oxf, oyf), spaceWalk);
+	if (algorithm_name == "MPC" && !circleReflected)
+		return MathOGL::countMidPointCircle(ox, oy, radius);
+	if (algorithm_name == "BCA" && !circleReflected)
+		return std::min(MathOGL::countBresenhamCircle(ox, oy, radius), 8 * spaceWalk);
+	if (algorithm_name == "CMP")
+	{
+		return MathOGL::countLineBasic(ox, oy, oxf, oyf) + (dda != MathOGL::rasterUnbounded ? dda : 0) +
+			MathOGL::countLineOctant(ox, oy, oxf, oyf) + MathOGL::countMidPointCircle(ox, oy, radius) +
+			MathOGL::countBresenhamCircle(ox, oy, radius);
+	}
+	return 0;
+}
+
+/**
+ * The function creates the meshes of the primitives, drawing them with the chosen algorithm. The
+ * ground and the axes are not meshes, see Backdrop. It only fills the CPU side of the geometry
+ * store, so it can run on a worker thread while the window and the shaders are being created; the
+ * upload happens afterwards.
+ * 
+ * @return the time spent, in milliseconds.
+ */
+double CreateObjects()
+{
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+	// Lines are rasterized only inside the coordinate space, with the pixels the whole line has there,
+	// so offscreen parts cost nothing. The clipped end points are only used by the distance fields:
+	// the old rasterizers stray from the ideal line, so they are clipped by their own pixels.
+	double x1 = ox, y1 = oy, x2 = oxf, y2 = oyf;
+	bool lineVisible = (algorithm_name == "BIA" || algorithm_name == "DDA" || algorithm_name == "BA") && ClipLine(x1, y1, x2, y2);
+
+	// The distance field renderer only needs the parameters of the primitive.
+	if (sdfPrimitives != NULL && lineVisible)
+	{
+		sdfPrimitives->addLine(x1, y1, x2, y2);
+	}
+	else if (sdfPrimitives != NULL && (algorithm_name == "MPC" || algorithm_name == "BCA"))
+	{
+		sdfPrimitives->addCircle(ox, oy, radius);
+	}
+
+	// Every pixel becomes one point of the store, room for them is made once from the counts. Points
+	// are drawn without indices.
+	if (sparseCanvas == NULL)
+	{
+		geometry->reserve(PredictPixels(), 0);
+	}
+
+	// BIA = Basic incremental algorithm.
+	if (algorithm_name == "BIA")
+	{
+		points = mathGL.drawLineBasicClipped(ox, oy, oxf, oyf, coordinateSpace);
+
+		AddPixels(points.empty() ? NULL : points.data(), points.size());
+		printf("points: %d\n", points.size());
+
+		drawVectors(points);
+	}
+	// DDA = Digital Differential Analyzer.
+	else if (algorithm_name == "DDA")
+	{
+		points = mathGL.drawLineDDAClipped(ox, oy, oxf, oyf, coordinateSpace);
+
+		AddPixels(points.empty() ? NULL : points.data(), points.size());
 		printf("points: %d\n", points.size());
 
 		drawVectors(points);
@@ -331,75 +705,672 @@ void CreateObjects()
 	// BA = Bresenham algorithm.
 	else if (algorithm_name == "BA")
 	{
-		std::cout << "Ingrese la coordenada x del punto inicial:\n";
-		std::cin >> ox;
-		std::cout << "Ingrese la coordenada y del punto inicial:\n";
-		std::cin >> oy;
-		std::cout << "Ingrese la coordenada x del punto final:\n";
-		std::cin >> oxf;
-		std::cout << "Ingrese la coordenada y del punto final:\n";
-		std::cin >> oyf;
+		points = mathGL.drawLineBresClipped(ox, oy, oxf, oyf, coordinateSpace);
 
-		points = mathGL.drawLineBres(ox, oy, oxf, oyf);
-
-		PointMesh* pointMesh = new PointMesh(points);
-		pointMesh->drawPoints();
-		pointsList.push_back(pointMesh);
+		AddPixels(points.empty() ? NULL : points.data(), points.size());
 		printf("points: %d\n", points.size());
 
 		drawVectors(points);
 	}
 	// MPC = Mid point circle algorithm.
+	else if (algorithm_name == "MPC" && circleReflected)
+	{
+		points = mathGL.midPointCircleOctant(radius);
+		drawReflectedCircle(points);
+	}
 	else if (algorithm_name == "MPC")
 	{
-		std::cout << "Ingrese la coordenada x del centro del circulo:\n";
-		std::cin >> ox;
-		std::cout << "Ingrese la coordenada y del centro del circulo:\n";
-		std::cin >> oy;
-		std::cout << "Ingrese el radio del circulo:\n";
-		std::cin >> radius;
-
 		points = mathGL.midPointCircleDraw(ox, oy, radius);
 		points = reorder_points_adjacent(points);
 
-		PointMesh* pointMesh = new PointMesh(points);
-		pointMesh->drawPoints();
-		pointsList.push_back(pointMesh);
+		AddPixels(points.empty() ? NULL : points.data(), points.size());
 		printf("points: %d\n", points.size());
 
 		drawMidPointCircle(ox, oy, points);
 	}
 	// BCA = Bresenham circle algorithm.
+	else if (algorithm_name == "BCA" && circleReflected)
+	{
+		points = mathGL.BresenhamCircleOctant(radius);
+		drawReflectedCircle(points);
+	}
 	else if (algorithm_name == "BCA")
 	{
-		std::cout << "Ingrese la coordenada x del centro del circulo:\n";
-		std::cin >> ox;
-		std::cout << "Ingrese la coordenada y del centro del circulo:\n";
-		std::cin >> oy;
-		std::cout << "Ingrese el radio del circulo:\n";
-		std::cin >> radius;
-
-		points = mathGL.BresenhamCircle(ox, oy, radius);
-		points = reorder_points_adjacent(points);
+		points = mathGL.BresenhamCircleClipped(ox, oy, radius, coordinateSpace);
 
-		PointMesh* pointMesh = new PointMesh(points);
-		pointMesh->drawPoints();
-		pointsList.push_back(pointMesh);
+		AddPixels(points.empty() ? NULL : points.data(), points.size());
 		printf("points: %d\n", points.size());
 
-		drawVectorsBresenh(points);
+		drawCircleArcs(ox, oy, points);
+	}
+	// CMP = the five rasterizers on the same line and circle, each in its own column.
+	else if (algorithm_name == "CMP")
+	{
+		double spacing = ceil(std::max(fabs(oxf - ox), 2.0 * radius)) + 20.0;
+		const char* columns[5] = { "BIA", "DDA", "BA", "MPC", "BCA" };
+		for (int c = 0; c < 5; c++)
+		{
+			double offset = (c - 2) * spacing;
+			std::vector<glm::vec3> column;
+			if (c == 0)
+				column = mathGL.drawLineBasic(ox + offset, oy, oxf + offset, oyf);
+			else if (c == 1 && MathOGL::countLineDDA(ox + offset, oy, oxf + offset, oyf) != MathOGL::rasterUnbounded)
+				column = mathGL.drawLineDDA(ox + offset, oy, oxf + offset, oyf);
+			else if (c == 2)
+				column = mathGL.drawLineOctant(ox + offset, oy, oxf + offset, oyf);
+			else if (c == 3)
+				column = mathGL.midPointCircleDraw(ox + offset, oy, radius);
+			else if (c == 4)
+				column = mathGL.BresenhamCircle(ox + offset, oy, radius);
+
+			AddPixels(column.empty() ? NULL : column.data(), column.size());
+			if (sdfPrimitives != NULL && c < 3 && !column.empty())
+				sdfPrimitives->addLine(ox + offset, oy, oxf + offset, oyf);
+			else if (sdfPrimitives != NULL && c >= 3)
+				sdfPrimitives->addCircle(ox + offset, oy, radius);
+			printf("comparison: %s drawn at x offset %g, %zu pixels%s\n", columns[c], offset, column.size(),
+				c == 1 && column.empty() ? " (skipped, DDA never ends on this line)" : "");
+		}
+	}
+	// LOAD = pixels of a raster file, mapped and uploaded by the geometry store straight from the
+	// mapping, without parsing or copying them.
+	else if (algorithm_name == "LOAD")
+	{
+		if (importFile.open(importPath.c_str()))
+		{
+			if (sparseCanvas != NULL)
+			{
+				AddPixels(importFile.getPixels(), importFile.getPixelCount());
+			}
+			else
+			{
+				IndexPixels(importFile.getPixels(), importFile.getPixelCount(),
+					geometry->addMappedPoints(importFile.getPixels(), importFile.getPixelCount()));
+			}
+			printf("points: %zu (%.8s", importFile.getPixelCount(), importFile.getHeader().algorithm);
+			for (int i = 0; i < 4; i++)
+			{
+				printf(" %g", importFile.getHeader().parameters[i]);
+			}
+			printf(")\n");
+		}
+	}
+
+	if (!exportPath.empty())
+	{
+		double parameters[4] = { ox, oy, algorithm_name == "MPC" || algorithm_name == "BCA" ? radius : oxf,
+			algorithm_name == "MPC" || algorithm_name == "BCA" ? 0.0 : oyf };
+		// Reflected circles only rasterize one octant, offsets from the centre.
+		std::string exportName = circleReflected ? algorithm_name + "-OCT" : algorithm_name;
+		std::vector<glm::vec3> exported = points;
+		if (exportZOrder)
+		{
+			MortonIndex::sortPixels(exported, std::max(1u, std::thread::hardware_concurrency()));
+		}
+		if (RasterFile::write(exportPath.c_str(), exportName.c_str(), parameters, exported.empty() ? NULL : exported.data(), exported.size()))
+		{
+			printf("export: %zu pixels written to %s%s\n", exported.size(), exportPath.c_str(), exportZOrder ? " in Z order" : "");
+		}
 	}
+
+	printf("segments: %u drawn for %u adjacent pixel pairs (%.1fx fewer)\n", nVectors, nPixelSegments,
+		nVectors > 0 ? (double)nPixelSegments / nVectors : 1.0);
+
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count();
 }
 
 /**
  * The function creates a shader object from vertex and fragment shader files and adds it to a list of
- * shaders.
+ * shaders. Only the compilation is started; Shader::FinishCompile must be called before using it so
+ * that drivers with GL_KHR_parallel_shader_compile can build it in the background.
  */
 void CreateShaders()
 {
-	Shader* shader1 = new Shader();
-	shader1->CreateFromFiles(vShader, fShader);
-	shaderList.push_back(*shader1);
+	if (GLEW_KHR_parallel_shader_compile)
+	{
+		// Let the driver use as many compiler threads as it wants.
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+	}
+
+	Shader* shader1 = sceneArena.create<Shader>();
+	shader1->StartFromFiles(vShader, fShader);
+	shaderList.push_back(shader1);
+
+	if (circleReflected)
+	{
+		Shader* octantShader = sceneArena.create<Shader>();
+		octantShader->StartFromFiles(vOctantShader, fShader);
+		shaderList.push_back(octantShader);
+	}
+
+	backdropShader = sceneArena.create<Shader>();
+	backdropShader->StartFromFiles(vBackdropShader, fBackdropShader);
+	shaderList.push_back(backdropShader);
+
+	if (sdfPrimitives != NULL)
+	{
+		sdfShader = sceneArena.create<Shader>();
+		sdfShader->StartFromFiles(vSdfShader, fSdfShader);
+		shaderList.push_back(sdfShader);
+	}
+}
+
+/**
+ * The function starts timing the GPU work of a frame, after collecting the time of the frame timed
+ * before if the GPU is done with it. While it isn't, the frame is not timed.
+ * 
+ * @param sdf Whether the frame draws the primitives as distance fields.
+ * 
+ * @return true if the timer was started and EndFrameTimer must be called.
+ */
+bool BeginFrameTimer(bool sdf)
+{
+	if (frameTimeQuery == 0)
+	{
+		glGenQueries(1, &frameTimeQuery);
+	}
+
+	if (frameTimePending)
+	{
+		GLint available = 0;
+		glGetQueryObjectiv(frameTimeQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			return false;
+
+		GLuint64 nanoseconds = 0;
+		glGetQueryObjectui64v(frameTimeQuery, GL_QUERY_RESULT, &nanoseconds);
+		timedFrames[frameTimeSdf]++;
+		gpuFrameMs[frameTimeSdf] += nanoseconds / 1e6;
+		frameTimePending = false;
+	}
+
+	glBeginQuery(GL_TIME_ELAPSED, frameTimeQuery);
+	frameTimePending = true;
+	frameTimeSdf = sdf;
+	return true;
+}
+
+/**
+ * The function stops the timer started by BeginFrameTimer.
+ */
+void EndFrameTimer()
+{
+	glEndQuery(GL_TIME_ELAPSED);
+}
+
+/**
+ * The function clears the window and draws the whole scene from the given point of view.
+ * 
+ * @param projection The projection matrix of the camera.
+ * @param view The view matrix of the camera.
+ */
+void RenderScene(const glm::mat4& projection, const glm::mat4& view)
+{
+	// Clear the window
+	glClearColor(windowColor.x / 256, windowColor.y / 256, windowColor.z / 256, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	bool sdf = sdfPrimitives != NULL && sdfShown.load();
+	bool timed = sdfPrimitives != NULL && BeginFrameTimer(sdf);
+
+	// Ground, grid and axes in one pass, under everything else.
+	backdropShader->UseShader();
+	glUniformMatrix4fv(backdropShader->GetProjectionLocation(), 1, GL_FALSE, glm::value_ptr(projection));
+	glUniformMatrix4fv(backdropShader->GetViewLocation(), 1, GL_FALSE, glm::value_ptr(view));
+	glUniform1f(backdropShader->GetGridSpacingLocation(), (GLfloat)gridSpacing);
+	glUniform1f(backdropShader->GetFadeDistanceLocation(), farPlane);
+	backdrop->render();
+
+	shaderList[0]->UseShader();
+	GLuint uniformModel = shaderList[0]->GetModelLocation();
+	GLuint uniformProjection = shaderList[0]->GetProjectionLocation();
+	GLuint uniformView = shaderList[0]->GetViewLocation();
+
+	glm::mat4 model(1.0f);
+
+	model = glm::translate(model, glm::vec3(0.0f, 0.0f, 0.0f));
+	//model = glm::scale(model, glm::vec3(0.4f, 0.4f, 1.0f));
+	glUniformMatrix4fv(uniformModel, 1, GL_FALSE, glm::value_ptr(model));
+	glUniformMatrix4fv(uniformProjection, 1, GL_FALSE, glm::value_ptr(projection));
+	glUniformMatrix4fv(uniformView, 1, GL_FALSE, glm::value_ptr(view));
+
+	// With distance fields shown, the store draws none of the primitives.
+	if (sdfPrimitives != NULL)
+	{
+		geometry->setMeshLimit(sdf ? 0 : UINT_MAX);
+	}
+
+	// Vectors and points in one multi-draw per primitive mode.
+	geometry->render();
+
+	// Stream the canvas tiles the camera sees, a few per frame.
+	canvasStreaming = false;
+	if (canvasView != NULL && !sdf)
+	{
+		ClipRect visible = CanvasView::visibleRect(projection, view);
+		visible.xMin = std::max(visible.xMin, coordinateSpace.xMin);
+		visible.yMin = std::max(visible.yMin, coordinateSpace.yMin);
+		visible.xMax = std::min(visible.xMax, coordinateSpace.xMax);
+		visible.yMax = std::min(visible.yMax, coordinateSpace.yMax);
+		canvasStreaming = canvasView->update(visible) > 0;
+		canvasView->render();
+	}
+
+	if (reflectedCircle != NULL && !sdf)
+	{
+		shaderList[1]->UseShader();
+		glUniformMatrix4fv(shaderList[1]->GetModelLocation(), 1, GL_FALSE, glm::value_ptr(model));
+		glUniformMatrix4fv(shaderList[1]->GetProjectionLocation(), 1, GL_FALSE, glm::value_ptr(projection));
+		glUniformMatrix4fv(shaderList[1]->GetViewLocation(), 1, GL_FALSE, glm::value_ptr(view));
+		reflectedCircle->render(shaderList[1]->GetCentreLocation());
+	}
+
+	if (sdf)
+	{
+		sdfShader->UseShader();
+		glUniformMatrix4fv(sdfShader->GetModelLocation(), 1, GL_FALSE, glm::value_ptr(model));
+		glUniformMatrix4fv(sdfShader->GetProjectionLocation(), 1, GL_FALSE, glm::value_ptr(projection));
+		glUniformMatrix4fv(sdfShader->GetViewLocation(), 1, GL_FALSE, glm::value_ptr(view));
+		glUniform1f(sdfShader->GetLineWidthLocation(), (GLfloat)std::max(lineWidth, 1.0));
+		glUniform1i(sdfShader->GetSnapPixelsLocation(), sdfSnap.load() ? 1 : 0);
+		sdfPrimitives->render();
+	}
+
+	if (timed)
+	{
+		EndFrameTimer();
+	}
+
+	glUseProgram(0);
+}
+
+/**
+ * The function wakes up the render thread if it is waiting for something to draw. A wake-up sent
+ * while it is still drawing is kept for its next wait, so none is lost.
+ */
+void WakeRenderThread()
+{
+	{
+		std::lock_guard<std::mutex> lock(renderWakeMutex);
+		renderWakePending = true;
+	}
+	renderWake.notify_one();
+}
+
+/**
+ * The function is the body of a live feed producer thread. It submits random lines and circles inside
+ * the coordinate space in bursts every 10 ms until feedRunning is cleared, counting the primitives
+ * dropped because the queue was full, and wakes up the main loop after every burst.
+ * 
+ * @param seed The seed of the random generator of this producer.
+ * @param primitivesPerSecond The rate at which primitives are submitted.
+ */
+void FeedProducer(unsigned int seed, unsigned int primitivesPerSecond)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> x(-widthWin / 2.0f, widthWin / 2.0f);
+	std::uniform_real_distribution<float> y(-heightWin / 2.0f, heightWin / 2.0f);
+	std::uniform_real_distribution<float> r(1.0f, heightWin / 8.0f);
+	std::uniform_int_distribution<int> kind(0, 3);
+	unsigned int burst = primitivesPerSecond / 100 > 0 ? primitivesPerSecond / 100 : 1;
+
+	while (feedRunning.load())
+	{
+		for (unsigned int i = 0; i < burst; i++)
+		{
+			Primitive primitive;
+			// Three lines for every circle.
+			if (kind(rng) != 0)
+			{
+				primitive.kind = Primitive::LINE;
+				primitive.x1 = x(rng);
+				primitive.y1 = y(rng);
+				primitive.x2 = x(rng);
+				primitive.y2 = y(rng);
+			}
+			else
+			{
+				primitive.kind = Primitive::CIRCLE;
+				primitive.x1 = x(rng);
+				primitive.y1 = y(rng);
+				primitive.x2 = r(rng);
+				primitive.y2 = 0.0f;
+			}
+
+			if (!primitiveQueue.push(primitive))
+			{
+				feedDropped++;
+			}
+		}
+		feedSubmitted += burst;
+
+		glfwPostEmptyEvent();
+		WakeRenderThread();
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+}
+
+/**
+ * The function rasterizes queued primitives until the queue is empty or the time budget is spent,
+ * and appends the pixels not drawn before to the geometry store as one mesh. It must only be called
+ * from the thread that renders the geometry store.
+ * 
+ * @param budgetMs The longest time to spend, in milliseconds.
+ * 
+ * @return the number of primitives drained.
+ */
+unsigned int DrainPrimitiveQueue(double budgetMs)
+{
+	static std::vector<glm::vec3> pixels;
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	std::chrono::duration<double, std::milli> budget(budgetMs);
+	unsigned int drained = 0;
+	Primitive primitive;
+
+	pixels.clear();
+	while (primitiveQueue.pop(primitive))
+	{
+		if (primitive.kind == Primitive::LINE)
+		{
+			LineOctantPixels line(primitive.x1, primitive.y1, primitive.x2, primitive.y2, coordinateSpace);
+			appendPixels(line, pixels);
+			if (sdfPrimitives != NULL)
+				sdfPrimitives->addLine(primitive.x1, primitive.y1, primitive.x2, primitive.y2);
+		}
+		else
+		{
+			std::vector<glm::vec3> rasterized = mathGL.BresenhamCircleClipped(primitive.x1, primitive.y1, primitive.x2, coordinateSpace);
+			pixels.insert(pixels.end(), rasterized.begin(), rasterized.end());
+			if (sdfPrimitives != NULL)
+				sdfPrimitives->addCircle(primitive.x1, primitive.y1, primitive.x2);
+		}
+		drained++;
+
+		// Reading the clock costs more than rasterizing a short line, only check it now and then.
+		if (drained % 32 == 0 && std::chrono::high_resolution_clock::now() - start > budget)
+			break;
+	}
+
+	// Keep the pixels no earlier primitive of the feed has drawn, in Morton order for the upload.
+	static PixelSet batch;
+	batch.clear();
+	for (size_t i = 0; i < pixels.size(); i++)
+	{
+		if (feedPixelSet.insert(pixels[i]))
+		{
+			batch.insert(pixels[i]);
+		}
+	}
+	feedPixelsRasterized += pixels.size();
+	pixels.clear();
+	batch.appendPoints(pixels);
+	feedPixelsDrawn += pixels.size();
+
+	if (!pixels.empty())
+	{
+		AddPixels(pixels.data(), pixels.size());
+	}
+	feedDrawn += drained;
+	return drained;
+}
+
+/**
+ * The function picks the pixel at the centre of the screen. The cursor is captured by the camera
+ * controls, so the ray is the one the camera looks along; it is intersected with the z = 0 plane
+ * the pixels lie on, and the pixel of pickIndex closest to that point is reported with its primitive
+ * and the pixels around it. The time spent in pickIndex is added to the pick latency metrics.
+ */
+void PickAtCentre()
+{
+	glm::vec3 origin = camera.getPosition();
+	glm::vec3 direction = camera.getFront();
+	if (fabs(direction.z) < 1e-6f || -origin.z / direction.z < 0.0f)
+	{
+		printf("pick: the view ray does not reach the pixels\n");
+		return;
+	}
+	glm::vec3 target = origin + direction * (-origin.z / direction.z);
+
+	static std::vector<SpatialHit> nearby;
+	nearby.clear();
+	SpatialHit hit;
+	bool found;
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	{
+		std::lock_guard<std::mutex> lock(pickMutex);
+		found = pickIndex.nearest(target.x, target.y, pickRadius, hit);
+		pickIndex.queryRadius(target.x, target.y, pickRadius, nearby);
+	}
+	std::chrono::duration<double, std::micro> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+	pickQueries++;
+	pickTotalUs += elapsed.count();
+	pickMaxUs = std::max(pickMaxUs, elapsed.count());
+
+	if (!found)
+	{
+		printf("pick: nothing within %.0f pixels of (%.1f, %.1f), %.2f us\n", pickRadius, target.x, target.y, elapsed.count());
+	}
+	else if (hit.primitive == reflectedCirclePrimitive)
+	{
+		printf("pick: pixel (%d, %d) of the reflected circle, %zu pixels within %.0f, %.2f us\n", hit.x, hit.y,
+			nearby.size(), pickRadius, elapsed.count());
+	}
+	else
+	{
+		printf("pick: pixel (%d, %d) of primitive %u, %zu pixels within %.0f, %.2f us\n", hit.x, hit.y, hit.primitive,
+			nearby.size(), pickRadius, elapsed.count());
+	}
+}
+
+/**
+ * The function picks the pixel at the centre of the screen once every time the P key goes down, when
+ * picking is on.
+ */
+void HandlePickKey()
+{
+	static bool wasDown = false;
+	bool down = mainWindow.getsKeys()[GLFW_KEY_P];
+	if (centrePick && down && !wasDown)
+	{
+		PickAtCentre();
+	}
+	wasDown = down;
+}
+
+/**
+ * The function switches between drawing the primitives as pixels and as distance fields with the V
+ * key, and the Bresenham emulation of the distance fields with the B key, once every time a key goes
+ * down.
+ */
+void HandleRenderKeys()
+{
+	static bool vWasDown = false, bWasDown = false;
+	bool vDown = mainWindow.getsKeys()[GLFW_KEY_V];
+	bool bDown = mainWindow.getsKeys()[GLFW_KEY_B];
+
+	if (sdfPrimitives != NULL && vDown && !vWasDown)
+	{
+		sdfShown.store(!sdfShown.load());
+		printf("render: %s\n", sdfShown.load() ? "distance fields, one quad per primitive" : "pixels, one vertex per pixel");
+	}
+	if (sdfPrimitives != NULL && bDown && !bWasDown)
+	{
+		sdfSnap.store(!sdfSnap.load());
+		printf("render: Bresenham emulation %s\n", sdfSnap.load() ? "on" : "off");
+	}
+
+	vWasDown = vDown;
+	bWasDown = bDown;
+}
+
+/**
+ * The function runs input, camera updates and drawing one after the other on the main thread until
+ * the window is closed. In on-demand mode it sleeps while nothing changes.
+ * 
+ * @param projection The projection matrix of the camera.
+ */
+void RunSingleThreadedLoop(const glm::mat4& projection)
+{
+	FrameMonitor frameMonitor(renderOnDemand ? "on-demand" : "continuous", 5.0);
+	bool sceneDirty = true;
+	bool idled = false;
+
+	// Loop until window closed
+	while (!mainWindow.getShouldClose())
+	{
+		// Get + Handle User Input
+		// In on-demand mode block until an event arrives, unless a key is held and the camera
+		// has to keep moving.
+		if (renderOnDemand && !mainWindow.isAnyKeyHeld() && primitiveQueue.sizeApprox() == 0)
+		{
+			glfwWaitEventsTimeout(idleTimeout);
+		}
+		else
+		{
+			glfwPollEvents();
+		}
+
+		double now = glfwGetTime(); // SDL_GetPerformanceCounter();
+		// Time spent asleep must not turn into camera movement.
+		deltaTime = idled ? 0.0f : now - lastTime; // (now - lastTime)*1000/ SDL_GetPerformaceFrequency()
+		lastTime = now;
+
+		bool cameraChanged = camera.keyControl(mainWindow.getsKeys(), deltaTime);
+		cameraChanged = camera.mouseControl(mainWindow.getXChange(), mainWindow.getYChange()) || cameraChanged;
+		bool inputArrived = mainWindow.consumeInput();
+		HandlePickKey();
+		HandleRenderKeys();
+		if (liveFeed && DrainPrimitiveQueue(feedBudgetMs) > 0)
+		{
+			sceneDirty = true;
+		}
+
+		if (renderOnDemand && !cameraChanged && !inputArrived && !sceneDirty && !canvasStreaming)
+		{
+			idled = true;
+			frameMonitor.frameSkipped();
+			frameMonitor.update();
+			continue;
+		}
+		idled = false;
+
+		RenderScene(projection, camera.calculateViewMatrix());
+		mainWindow.swapBuffers();
+		sceneDirty = false;
+
+		frameMonitor.framePresented(inputArrived ? mainWindow.getLastInputTime() : -1.0);
+		frameMonitor.update();
+	}
+}
+
+/**
+ * The function is the body of the render thread. It owns the GL context and draws the newest
+ * FrameState published by the update thread, never touching the Camera or the Window input state.
+ * In on-demand mode it only draws when a new state arrives, and waits on renderWake in between.
+ * 
+ * @param projection The projection matrix of the camera.
+ */
+void RenderThreadMain(glm::mat4 projection)
+{
+	mainWindow.makeContextCurrent();
+
+	FrameMonitor frameMonitor(renderOnDemand ? "render thread, on-demand" : "render thread, continuous", 5.0);
+	FrameState state;
+	bool drawnOnce = false;
+
+	while (renderThreadRunning.load())
+	{
+		bool fresh = frameExchange.consume(state);
+		// The geometry store belongs to this thread, so the live feed is drained here.
+		bool fed = liveFeed && DrainPrimitiveQueue(feedBudgetMs) > 0;
+		if (!fresh && !fed && drawnOnce && renderOnDemand && !canvasStreaming)
+		{
+			frameMonitor.frameSkipped();
+			frameMonitor.update();
+
+			// Wake up at least every idleTimeout so the frame monitor keeps reporting.
+			std::unique_lock<std::mutex> lock(renderWakeMutex);
+			renderWake.wait_for(lock, std::chrono::duration<double>(idleTimeout), [] { return renderWakePending; });
+			renderWakePending = false;
+			continue;
+		}
+
+		RenderScene(projection, state.view);
+		mainWindow.swapBuffers();
+		drawnOnce = true;
+
+		// Only the first frame showing a state answers to its input.
+		frameMonitor.framePresented(fresh ? state.inputTime : -1.0);
+		frameMonitor.update();
+	}
+
+	glFinish();
+	mainWindow.releaseContext();
+}
+
+/**
+ * The function splits the loop in two threads: the main thread handles GLFW events (which GLFW
+ * requires), owns the Camera, and publishes a FrameState whenever the camera moves or input
+ * arrives, while a render thread draws it. A slow frame no longer delays input handling. Scene
+ * edits from the live feed happen on the render thread, which owns the geometry store.
+ * 
+ * @param projection The projection matrix of the camera.
+ */
+void RunThreadedLoop(const glm::mat4& projection)
+{
+	FrameState state;
+	state.view = camera.calculateViewMatrix();
+	state.inputTime = -1.0;
+	frameExchange.publish(state);
+
+	mainWindow.releaseContext();
+	renderThreadRunning.store(true);
+	std::thread renderThread(RenderThreadMain, projection);
+
+	while (!mainWindow.getShouldClose())
+	{
+		// Without drawing to pace it, the update thread sleeps until input arrives, waking up often
+		// enough to keep held keys moving the camera smoothly.
+		glfwWaitEventsTimeout(mainWindow.isAnyKeyHeld() ? 0.001 : idleTimeout);
+
+		double now = glfwGetTime();
+		deltaTime = now - lastTime;
+		lastTime = now;
+
+		bool cameraChanged = camera.keyControl(mainWindow.getsKeys(), deltaTime);
+		cameraChanged = camera.mouseControl(mainWindow.getXChange(), mainWindow.getYChange()) || cameraChanged;
+		bool inputArrived = mainWindow.consumeInput();
+		HandlePickKey();
+		HandleRenderKeys();
+
+		if (cameraChanged || inputArrived)
+		{
+			state.view = camera.calculateViewMatrix();
+			state.inputTime = inputArrived ? mainWindow.getLastInputTime() : -1.0;
+			frameExchange.publish(state);
+			WakeRenderThread();
+		}
+	}
+
+	renderThreadRunning.store(false);
+	WakeRenderThread();
+	renderThread.join();
+	mainWindow.makeContextCurrent();
+}
+
+/**
+ * The function returns the milliseconds elapsed since start.
+ * 
+ * @param start The time point at which the measurement began.
+ * 
+ * @return the elapsed wall-clock time in milliseconds.
+ */
+double elapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count();
 }
 
 //------------------------------------------------------------------------------------------------------------
@@ -412,74 +1383,197 @@ int main()
 		std::cin >> widthWin;
 		std::cout << "Cual sera el alto del espacio coordenado?:\n";
 		std::cin >> heightWin;
-		std::cout << "Cual algoritmo quieres probar (RECUERDE USAR MAYUSCULAS!)?\nBIA = Basic incremental algorithm.\nDDA = Digital Differential Analyzer.\nBA = Bresenham algorithm.\nMPC = Mid point circle algorithm.\nBCA = Bresenham circle algorithm:\n";
+		coordinateSpace.xMin = -widthWin / 2.0;
+		coordinateSpace.xMax = widthWin / 2.0;
+		coordinateSpace.yMin = -heightWin / 2.0;
+		coordinateSpace.yMax = heightWin / 2.0;
+		std::string canvasMode;
+		std::cout << "Usar un lienzo virtual disperso por tiles (espacios muy grandes, p. ej. 1000000 x 1000000)? (S/N):\n";
+		std::cin >> canvasMode;
+		bool useSparseCanvas = (canvasMode == "S" || canvasMode == "s");
+		std::cout << "Cual algoritmo quieres probar (RECUERDE USAR MAYUSCULAS!)?\nBIA = Basic incremental algorithm.\nDDA = Digital Differential Analyzer.\nBA = Bresenham algorithm.\nMPC = Mid point circle algorithm.\nBCA = Bresenham circle algorithm.\nLOAD = Pixeles de un archivo binario exportado.\nCMP = Comparar los cinco algoritmos con las mismas entradas.\nBENCH = Benchmarks de rendimiento (sin ventana):\n";
 		std::cin >> algorithm_name;
 		std::transform(algorithm_name.begin(), algorithm_name.end(), algorithm_name.begin(), ::toupper);
 		std::cout << "El algoritmo elegido es: " << algorithm_name << std::endl;
 
-		mainWindow = Window(widthWin, heightWin);
+		// BENCH = performance benchmarks, they don't need a window.
+		if (algorithm_name == "BENCH")
+		{
+			Benchmark benchmark;
+			benchmark.runAll();
+			return 0;
+		}
+
+		ReadParameters();
+
+		// CMP reports its results without a window unless they are to be shown side by side.
+		if (algorithm_name == "CMP")
+		{
+			RunComparison();
+			if (!comparisonWindow)
+				return 0;
+		}
+
+		std::string renderMode;
+		std::cout << "Renderizar solo cuando haya cambios (ahorra CPU)? (S/N):\n";
+		std::cin >> renderMode;
+		renderOnDemand = (renderMode == "S" || renderMode == "s");
+		std::cout << "Dibujar en un hilo separado de la entrada? (S/N):\n";
+		std::cin >> renderMode;
+		renderThreaded = (renderMode == "S" || renderMode == "s");
+		std::cout << "Simular una fuente de primitivas en vivo (4 hilos productores)? (S/N):\n";
+		std::cin >> renderMode;
+		liveFeed = (renderMode == "S" || renderMode == "s");
+		std::cout << "Seleccionar el pixel en el centro de la pantalla con la tecla P? (S/N):\n";
+		std::cin >> renderMode;
+		centrePick = (renderMode == "S" || renderMode == "s");
+		std::cout << "Separacion de la cuadricula del suelo, en pixeles (0 = sin cuadricula):\n";
+		std::cin >> gridSpacing;
+		gridSpacing = std::max(0.0, gridSpacing);
+		std::cout << "Dibujar lineas y circulos con campos de distancia en el shader, un quad por primitiva (V alterna con los pixeles, B emula Bresenham)? (S/N):\n";
+		std::cin >> renderMode;
+		bool useSdf = (renderMode == "S" || renderMode == "s");
+
+		// Startup: rasterization runs on a worker thread while the window, the context and the
+		// shaders are created here; the geometry is uploaded once both sides are ready.
+		std::chrono::high_resolution_clock::time_point startupStart = std::chrono::high_resolution_clock::now();
+		geometry = sceneArena.create<GeometryStore>();
+		if (useSparseCanvas)
+		{
+			sparseCanvas = sceneArena.create<SparseCanvas>(canvasMemoryCap, TempFile::path(canvasPageName).c_str());
+			canvasView = sceneArena.create<CanvasView>(*sparseCanvas, tileUploadsPerFrame);
+		}
+		backdrop = sceneArena.create<Backdrop>();
+		if (circleReflected)
+		{
+			reflectedCircle = sceneArena.create<ReflectedCircle>();
+		}
+		if (useSdf)
+		{
+			sdfPrimitives = sceneArena.create<SdfPrimitives>();
+		}
+		std::future<double> rasterization = std::async(std::launch::async, CreateObjects);
+
+		std::chrono::high_resolution_clock::time_point phaseStart = std::chrono::high_resolution_clock::now();
+		mainWindow = useSparseCanvas ? Window(std::min(widthWin, maxCanvasWindow), std::min(heightWin, maxCanvasWindow)) : Window(widthWin, heightWin);
 		mainWindow.Initialise();
+		double windowMs = elapsedMs(phaseStart);
 
-		CreateObjects();
+		phaseStart = std::chrono::high_resolution_clock::now();
 		CreateShaders();
+		double shaderSubmitMs = elapsedMs(phaseStart);
 
-		camera = Camera(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 1.0f, 0.0f), -140.0f, -40.0f, 5.0f, 0.5f);
+		phaseStart = std::chrono::high_resolution_clock::now();
+		double rasterizationMs = rasterization.get();
+		double waitMs = elapsedMs(phaseStart);
 
-		GLuint uniformProjection = 0, uniformModel = 0, uniformView = 0, uniformAmbientIntensity = 0, uniformAmbientColour = 0;
-		glm::mat4 projection = glm::perspective(glm::radians(45.0f), (GLfloat)mainWindow.getBufferWidth() / mainWindow.getBufferHeight(), nearPlane, farPlane);
+		phaseStart = std::chrono::high_resolution_clock::now();
+		geometry->upload();
+		importFile.close();
+		double uploadMs = elapsedMs(phaseStart);
 
-		// Loop until window closed
-		while (!mainWindow.getShouldClose())
+		phaseStart = std::chrono::high_resolution_clock::now();
+		for (size_t i = 0; i < shaderList.size(); i++)
 		{
-			double now = glfwGetTime(); // SDL_GetPerformanceCounter();
-			deltaTime = now - lastTime; // (now - lastTime)*1000/ SDL_GetPerformaceFrequency()
-			lastTime = now;
+			shaderList[i]->FinishCompile();
+		}
+		double shaderFinishMs = elapsedMs(phaseStart);
+		double startupMs = elapsedMs(startupStart);
+
+		printf("geometry: %u meshes in %u draw calls (%s)\n", geometry->getMeshCount(), geometry->getDrawCallCount(),
+			geometry->usesIndirect() ? "glMultiDraw*Indirect" : "glMultiDraw*");
+		printf("startup: %.2f ms total\n", startupMs);
+		printf("  window + context    : %8.2f ms\n", windowMs);
+		printf("  shader submit       : %8.2f ms (parallel compile %s)\n", shaderSubmitMs,
+			GLEW_KHR_parallel_shader_compile ? "on" : "off");
+		printf("  rasterization       : %8.2f ms (worker thread, %.2f ms waited for it)\n", rasterizationMs, waitMs);
+		printf("  geometry upload     : %8.2f ms\n", uploadMs);
+		printf("  shader finish       : %8.2f ms\n", shaderFinishMs);
+		printf("  serial equivalent   : %8.2f ms\n", windowMs + shaderSubmitMs + rasterizationMs + uploadMs + shaderFinishMs);
 
-			// Get + Handle User Input
-			glfwPollEvents();
+		camera = Camera(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 1.0f, 0.0f), -140.0f, -40.0f, 5.0f, 0.5f);
+
+		glm::mat4 projection = glm::perspective(glm::radians(45.0f), (GLfloat)mainWindow.getBufferWidth() / mainWindow.getBufferHeight(), nearPlane, farPlane);
 
-			camera.keyControl(mainWindow.getsKeys(), deltaTime);
-			camera.mouseControl(mainWindow.getXChange(), mainWindow.getYChange());
-
-			// Clear the window
-			glClearColor(windowColor.x / 256, windowColor.y / 256, windowColor.z / 256, 1.0f);
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-			shaderList[0].UseShader();
-			uniformModel = shaderList[0].GetModelLocation();
-			uniformProjection = shaderList[0].GetProjectionLocation();
-			uniformView = shaderList[0].GetViewLocation();
-			uniformAmbientColour = shaderList[0].GetAmbientColourLocation();
-			uniformAmbientIntensity = shaderList[0].GetAmbientIntensityLocation();
-
-			glm::mat4 model(1.0f);
-
-			model = glm::translate(model, glm::vec3(0.0f, 0.0f, 0.0f));
-			//model = glm::scale(model, glm::vec3(0.4f, 0.4f, 1.0f));
-			glUniformMatrix4fv(uniformModel, 1, GL_FALSE, glm::value_ptr(model));
-			glUniformMatrix4fv(uniformProjection, 1, GL_FALSE, glm::value_ptr(projection));
-			glUniformMatrix4fv(uniformView, 1, GL_FALSE, glm::value_ptr(camera.calculateViewMatrix()));
-			meshList[0]->RenderMesh();
-
-			// MPC = Mid point circle algorithm.
-			// NOTE: at the moment there's no difference between renderCircle and renderVectors functions,
-			// but the script is designed like this due to basically it can be extensible for future modifications.
-			if (algorithm_name == "MPC")
+		if (liveFeed)
+		{
+			feedRunning.store(true);
+			for (unsigned int i = 0; i < 4; i++)
 			{
-				renderCircle();
+				feedProducers.push_back(std::thread(FeedProducer, 100 + i, 2000));
 			}
-			else 
+		}
+
+		if (renderThreaded)
+		{
+			RunThreadedLoop(projection);
+		}
+		else
+		{
+			RunSingleThreadedLoop(projection);
+		}
+
+		if (liveFeed)
+		{
+			feedRunning.store(false);
+			for (size_t i = 0; i < feedProducers.size(); i++)
 			{
-				renderVectors();
+				feedProducers[i].join();
 			}
-			
-			plane->renderPlane();
-			pointsList[0]->renderPoints();
+			printf("live feed: %llu primitives submitted, %llu drawn, %llu dropped (queue full)\n",
+				feedSubmitted.load(), feedDrawn, feedDropped.load());
+			printf("live feed: %llu pixels rasterized, %llu drawn, %.1f%% overdraw saved (%zu tiles, %zu KB)\n",
+				feedPixelsRasterized, feedPixelsDrawn,
+				feedPixelsRasterized > 0 ? 100.0 * (feedPixelsRasterized - feedPixelsDrawn) / feedPixelsRasterized : 0.0,
+				feedPixelSet.getTileCount(), feedPixelSet.getBytes() / 1024);
+		}
 
-			glUseProgram(0);
+		if (centrePick)
+		{
+			printf("pick: %u queries over %zu pixels in %zu cells, %.2f us mean, %.2f us max\n", pickQueries,
+				pickIndex.size(), pickIndex.getCellCount(), pickQueries > 0 ? pickTotalUs / pickQueries : 0.0, pickMaxUs);
+		}
 
-			mainWindow.swapBuffers();
+		if (sdfPrimitives != NULL)
+		{
+			printf("sdf: %zu primitives in %zu bytes of instances, one quad each\n", sdfPrimitives->getPrimitiveCount(),
+				sdfPrimitives->getBytes());
+			printf("sdf: GPU frame time %.3f ms with pixels (%u frames), %.3f ms with distance fields (%u frames)\n",
+				timedFrames[0] > 0 ? gpuFrameMs[0] / timedFrames[0] : 0.0, timedFrames[0],
+				timedFrames[1] > 0 ? gpuFrameMs[1] / timedFrames[1] : 0.0, timedFrames[1]);
+		}
+
+		if (sparseCanvas != NULL)
+		{
+			printf("canvas: %zu tiles written, %zu resident (%.1f MB, cap %.1f MB), %.1f MB paged out\n", sparseCanvas->getTileCount(),
+				sparseCanvas->getResidentTileCount(), sparseCanvas->getResidentBytes() / 1048576.0, canvasMemoryCap / 1048576.0,
+				sparseCanvas->getPagedBytes() / 1048576.0);
+			printf("canvas: %llu page-outs, %llu page-ins, a dense bitmap would take %.1f MB\n", sparseCanvas->getPageOuts(),
+				sparseCanvas->getPageIns(), (double)widthWin * heightWin / 8.0 / 1048576.0);
+			printf("canvas: %zu tiles on the GPU, %llu tile uploads (%.1f MB)\n", canvasView->getTileCount(),
+				canvasView->getUploadCount(), canvasView->getUploadedBytes() / 1048576.0);
+		}
+
+		// Release every mesh, shader and GL object of the scene while the context is still alive.
+		printf("scene arena: %zu objects, %zu bytes used of %zu reserved\n",
+			sceneArena.getObjectCount(), sceneArena.getBytesUsed(), sceneArena.getBytesReserved());
+		if (frameTimeQuery != 0)
+		{
+			glDeleteQueries(1, &frameTimeQuery);
+			frameTimeQuery = 0;
 		}
+		shaderList.clear();
+		geometry = NULL;
+		backdrop = NULL;
+		backdropShader = NULL;
+		reflectedCircle = NULL;
+		sdfPrimitives = NULL;
+		sdfShader = NULL;
+		sparseCanvas = NULL;
+		canvasView = NULL;
+		nVectors = 0;
+		nPixelSegments = 0;
+		sceneArena.reset();
 
 		return 0;
 	}